@@ -1,31 +1,43 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "HardwareInfo.hpp"
+#include "ProfileCatalog.hpp"
 #include "ProfileLoader.hpp"
 #include "ProfileEngine.hpp"
 #include "PowerThrottler.hpp"
 #include "BenchmarkTypes.hpp"
 
+// Per GPU adapter, indexed like `snapshot.gpus`.
+struct GpuAdapterState {
+    std::vector<std::uint32_t> candidates;  // ProfileEngine::GpuCandidates
+    // Copied out of the catalog, or synthesized for a candidate, when
+    // picked; `selectedRow` counts the options first, then the candidates.
+    std::optional<GpuThrottleTarget> selected;
+    int selectedRow = -1;
+    double nominalClockMHz = 0.0;
+    double nominalPowerWatts = 0.0;
+};
+
 struct AppState {
     HardwareSnapshot snapshot;
-    ProfileDatabase profiles;
+    ProfileCatalog profiles;
     ProfileEngine engine;
     PowerThrottler throttler;
 
-    std::vector<CpuThrottleTarget> cpuOptions;
-    std::vector<GpuThrottleTarget> gpuOptions;
-
+    // The options live in `engine`; the CPU list shows them followed by
+    // the candidates. The selection is materialized like GpuAdapterState's.
+    std::vector<std::uint32_t> cpuCandidates;  // ProfileEngine::CpuCandidates
     std::optional<CpuThrottleTarget> selectedCpu;
-    std::optional<GpuThrottleTarget> selectedGpu;
+    std::vector<GpuAdapterState> gpus;
+    size_t currentGpu = 0;  // adapter whose options the GPU list shows
 
     BenchmarkSnapshot benchmark;
     double cpuNominalFrequencyMHz = 0.0;
-    double gpuNominalClockMHz = 0.0;
-    double gpuNominalPowerWatts = 0.0;
 
     bool initialized = false;
 };
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <utility>
+
+struct BenchmarkProgress {
+    double fraction = 0.0;  // of the whole run, 0 to 1
+    std::string step;       // what is measured next, e.g. "CPU dot.f64 (AVX2)"
+};
+
+// Cancellation and progress for one benchmark run, shared by the thread
+// running it and the one watching it. The runner gives each part of the
+// run its share of the progress with BeginPart; the part calls Advance
+// between measurements, which reports progress (on the benchmark's
+// thread) and tells it whether to go on. Cancel may come from any thread;
+// a part that sees it stops at the next Advance and returns no result.
+class BenchmarkControl {
+public:
+    using ProgressFn = std::function<void(const BenchmarkProgress&)>;
+
+    explicit BenchmarkControl(ProgressFn onProgress = {}) : onProgress_(std::move(onProgress)) {}
+
+    void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    bool Cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+    void BeginPart(double begin, double end) {
+        begin_ = begin;
+        end_ = end;
+    }
+
+    // `fraction` (0 to 1) of the current part is done and `step` is next;
+    // false once cancelled.
+    bool Advance(double fraction, const std::string& step) const {
+        if (onProgress_) {
+            onProgress_({begin_ + (end_ - begin_) * std::clamp(fraction, 0.0, 1.0), step});
+        }
+        return !Cancelled();
+    }
+
+private:
+    ProgressFn onProgress_;
+    std::atomic<bool> cancelled_ = false;
+    double begin_ = 0.0;
+    double end_ = 1.0;
+};
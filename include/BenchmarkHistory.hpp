@@ -0,0 +1,150 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchmarkRunner.hpp"
+#include "BenchmarkStats.hpp"
+#include "BenchmarkTypes.hpp"
+
+// BenchmarkKey::kernel of each part's headline score.
+inline constexpr const char* kCpuScore = "cpu";
+inline constexpr const char* kGpuScore = "gpu";
+inline constexpr const char* kMemoryScore = "memory";
+inline constexpr const char* kWorkloadScore = "workloads";
+inline constexpr const char* kSustainedScore = "sustained";
+inline constexpr const char* kScalingScore = "scaling";
+
+// What a stored run measured; runs with equal keys are comparable.
+struct BenchmarkKey {
+    std::uint64_t hardwareFingerprint = 0;  // HardwareInfoService::Fingerprint
+    std::string targetId;                    // applied while it ran; empty on unthrottled hardware
+    std::string kernel;                      // one of the k*Score part names above
+    std::string settings;                    // BenchmarkSettings
+
+    bool operator==(const BenchmarkKey&) const = default;
+};
+
+struct BenchmarkRecord {
+    BenchmarkKey key;
+    std::int64_t timestamp = 0;  // seconds since the Unix epoch
+    BenchmarkResultData result;  // samples, kernel tables and curves stored in single precision
+};
+
+// The harness version plus the options that shape `kernel`'s score:
+// "v1;runs=10;per-core" for a per-core CPU run, "v1;huge-pages" for memory,
+// "v1;seconds=60" for a sustained run.
+std::string BenchmarkSettings(const BenchmarkOptions& options, std::string_view kernel);
+
+// A run's score against the rolling baseline: the pooled samples of the
+// latest runs with the same key.
+struct RegressionCheck {
+    std::string kernel;
+    size_t baselineRuns = 0;      // earlier runs pooled; none means nothing to compare against
+    double baselineMedian = 0.0;  // of the pooled samples, outliers dropped
+    SampleComparison comparison;  // the run's samples against the pooled ones
+    bool regressed = false;       // significantly slower, by more than kRegressionThreshold
+};
+
+inline constexpr size_t kRegressionWindow = 5;
+inline constexpr double kRegressionThreshold = 0.02;
+// A stored unthrottled run stands in for a new baseline this long.
+inline constexpr std::chrono::seconds kBaselineMaxAge = std::chrono::hours(24 * 7);
+
+// Append-only file of benchmark runs, one checksummed record each, shared
+// by the GUI and hwlimit. The keys are indexed in memory when the file is
+// read; a record's results are only decoded when a query returns it. A
+// record torn by a crash ends the readable part of the file and is cut off
+// by the next Append. Not synchronized: use one instance per thread.
+class BenchmarkHistory {
+public:
+    // Reads the runs already in `path`, if any; an empty path keeps nothing.
+    explicit BenchmarkHistory(std::filesystem::path path);
+
+    // history.bin in the per-user application data directory; empty when
+    // the platform names none.
+    static std::filesystem::path DefaultPath();
+
+    const std::filesystem::path& Path() const { return path_; }
+    size_t size() const { return entries_.size(); }
+
+    // Re-reads the file if it changed since this instance last read or
+    // wrote it (picking up other writers' runs) and appends `record`.
+    // False when it could not be written, or when the file is from
+    // another version, which is left alone.
+    bool Append(const BenchmarkRecord& record);
+
+    // Oldest first. Every run of `targetId` on the machine, whatever its
+    // kernel and settings:
+    std::vector<BenchmarkRecord> RunsOfTarget(std::uint64_t hardwareFingerprint, std::string_view targetId) const;
+    // Runs with exactly `key`:
+    std::vector<BenchmarkRecord> Runs(const BenchmarkKey& key) const;
+    // The newest run with `key`, if it is at most `maxAge` old.
+    std::optional<BenchmarkRecord> Latest(const BenchmarkKey& key, std::chrono::seconds maxAge) const;
+    // `run` against up to `window` stored runs with its key; call it
+    // before appending `run`.
+    RegressionCheck CheckRegression(const BenchmarkRecord& run, size_t window = kRegressionWindow) const;
+
+private:
+    struct Entry {
+        BenchmarkKey key;
+        std::int64_t timestamp = 0;
+        size_t offset = 0;  // of the record's payload in data_
+        size_t size = 0;
+    };
+    struct FileStamp {
+        std::uintmax_t size = 0;
+        std::filesystem::file_time_type modified;
+
+        bool operator==(const FileStamp&) const = default;
+    };
+
+    // Nullopt when the file is missing or unreadable.
+    static std::optional<FileStamp> Stamp(const std::filesystem::path& path);
+    void Load();
+    void Index(Entry entry);
+    BenchmarkRecord Decode(const Entry& entry) const;
+    std::vector<BenchmarkRecord> Decode(const std::vector<size_t>& entries) const;
+
+    std::filesystem::path path_;
+    std::string data_;          // the file's readable records
+    bool foreign_ = false;      // the file has another magic or version
+    std::optional<FileStamp> stamp_;  // the file as of the last Load or Append
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, std::vector<size_t>> byKey_;     // all key fields -> entries_
+    std::unordered_map<std::string, std::vector<size_t>> byTarget_;  // fingerprint and target -> entries_
+};
+
+// History keys of one run's parts. The CPU, memory, workload, sustained
+// and scaling scores are taken under the applied CPU target; the GPU score
+// on the default adapter, under its GPU target.
+struct BenchmarkRunKeys {
+    BenchmarkKey cpu;
+    BenchmarkKey gpu;
+    BenchmarkKey memory;
+    BenchmarkKey workloads;
+    BenchmarkKey sustained;
+    BenchmarkKey scaling;
+};
+
+BenchmarkRunKeys MakeRunKeys(std::uint64_t hardwareFingerprint, const std::string& cpuTarget,
+                             const std::string& gpuTarget, const BenchmarkOptions& options);
+
+// For a baseline: every part `options` asks for that has a stored run
+// within `maxAge` comes from the history instead and is turned off in
+// `options`. Returns those parts.
+BenchmarkReport ReuseStoredRuns(const BenchmarkHistory& history, const BenchmarkRunKeys& keys,
+                                BenchmarkOptions& options, std::chrono::seconds maxAge = kBaselineMaxAge);
+
+// Checks each part `report` measured against the history, then appends
+// it. `options` are the ones the run used, telling measured parts from
+// reused ones.
+std::vector<RegressionCheck> RecordRuns(BenchmarkHistory& history, const BenchmarkRunKeys& keys,
+                                        const BenchmarkOptions& options, const BenchmarkReport& report);
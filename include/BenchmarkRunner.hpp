@@ -1,21 +1,101 @@
 #pragma once
 
+#include <functional>
 #include <optional>
 #include <string>
 
 #include "HardwareInfo.hpp"
+#include "BenchmarkControl.hpp"
 #include "BenchmarkTypes.hpp"
+#include "MemoryBenchmark.hpp"
+#include "WorkloadBenchmark.hpp"
 
 struct BenchmarkReport {
     std::optional<BenchmarkResultData> cpu;
     std::optional<BenchmarkResultData> gpu;
+    std::optional<BenchmarkResultData> memory;     // only when BenchmarkOptions::memory is set
+    std::optional<BenchmarkResultData> workloads;  // only when BenchmarkOptions::workloads is set
+    std::optional<BenchmarkResultData> sustained;  // only when BenchmarkOptions::sustainedSeconds is set
+    std::optional<BenchmarkResultData> scaling;    // only when BenchmarkOptions::scaling is set
+    bool cancelled = false;  // stopped early; the parts that finished are still filled in
 };
 
+enum class CpuBenchmarkMode {
+    Aggregate,  // all threads at once
+    // Also each logical CPU alone and each core's SMT siblings together,
+    // with one pinned worker per logical CPU, for a per-core score map.
+    PerCore,
+};
+
+struct BenchmarkOptions {
+    bool cpu = true;  // the parts to run; a front end turns one off when the history already has its result
+    bool gpu = true;
+    CpuBenchmarkMode cpuMode = CpuBenchmarkMode::Aggregate;
+    bool memory = false;  // also run the cache/memory suite (MemoryBenchmark), a few seconds more
+    MemoryBenchmarkOptions memoryOptions;
+    bool workloads = false;  // also run the workload suite (WorkloadBenchmark), about a second more
+    // Above 0: also keep the CPU headline kernel running on all threads for
+    // this long, sampled at fixed intervals, for the throughput a target
+    // settles at once power and thermal limits take hold.
+    int sustainedSeconds = 0;
+    // Also run every CPU kernel at 1, 2, 4... threads up to all of them,
+    // for how throughput scales with the cores and threads a target allows.
+    bool scaling = false;
+    int repetitions = 10;  // timed calls behind the CPU, GPU, workload and scaling scores; more narrows the CI
+};
+
+// Curve names in the sustained part's BenchmarkResultData::curves, all
+// seconds -> GFLOPS except the marker.
+inline constexpr const char* kSustainedCurve = "throughput";  // all workers together, per interval
+inline constexpr const char* kSlowestWorkerCurve = "slowest worker";
+inline constexpr const char* kFastestWorkerCurve = "fastest worker";
+// One point: when the run settled (the run's length if it never did) and
+// the steady-state score.
+inline constexpr const char* kSteadyStateCurve = "steady state";
+
+// Curve names in the scaling part's BenchmarkResultData::curves, besides
+// one per CpuKernelName (threads -> G ops/s, all threads together).
+inline constexpr const char* kSpeedupCurve = "speedup";        // threads -> x, over 1 thread, all kernels
+inline constexpr const char* kEfficiencyCurve = "efficiency";  // threads -> %, speedup per thread
+inline constexpr const char* kAmdahlCurve = "amdahl fit";      // threads -> x, the fitted model
+// One point each: the thread count with one thread per physical core, and
+// the serial fraction the fit found up to it (%), or the throughput all
+// threads add over it (%). The SMT one only on CPUs with SMT.
+inline constexpr const char* kSerialFractionCurve = "serial fraction";
+inline constexpr const char* kSmtYieldCurve = "smt yield";
+
+// How a scaling run bears out a CPU target's core and thread limits (0:
+// none): whether throughput stops rising at the threads they leave, as on
+// the SKU the target mimics. Empty when the limits leave every thread the
+// run measured.
+std::string CompareScaling(const BenchmarkResultData& scaling, int maxCores, int maxThreads);
+
+// Bump when a kernel, its timing or its score changes, so stored runs
+// from older builds stop counting as the same configuration.
+inline constexpr int kBenchmarkHarnessVersion = 1;
+
 class BenchmarkRunner {
 public:
-    BenchmarkReport Run(const HardwareSnapshot& snapshot) const;
+    // Called on the benchmark's thread each time a part (CPU, GPU, memory, workloads, sustained,
+    // scaling) finishes, with the report so far.
+    using PartialFn = std::function<void(const BenchmarkReport&)>;
+
+    // Runs on the calling thread; `control`, if given, can cancel it from
+    // another thread and receives progress.
+    BenchmarkReport Run(const HardwareSnapshot& snapshot, const BenchmarkOptions& options = {},
+                        BenchmarkControl* control = nullptr, const PartialFn& onPartial = {}) const;
 
 private:
-    std::optional<BenchmarkResultData> RunCpuBenchmark(const HardwareSnapshot& snapshot) const;
-    std::optional<BenchmarkResultData> RunGpuBenchmark(const HardwareSnapshot& snapshot) const;
+    std::optional<BenchmarkResultData> RunCpuBenchmark(const HardwareSnapshot& snapshot,
+                                                       const BenchmarkOptions& options,
+                                                       BenchmarkControl& control) const;
+    std::optional<BenchmarkResultData> RunGpuBenchmark(const HardwareSnapshot& snapshot,
+                                                       const BenchmarkOptions& options,
+                                                       BenchmarkControl& control) const;
+    std::optional<BenchmarkResultData> RunSustainedBenchmark(const HardwareSnapshot& snapshot,
+                                                             const BenchmarkOptions& options,
+                                                             BenchmarkControl& control) const;
+    std::optional<BenchmarkResultData> RunScalingBenchmark(const HardwareSnapshot& snapshot,
+                                                           const BenchmarkOptions& options,
+                                                           BenchmarkControl& control) const;
 };
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "BenchmarkTypes.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef _MSC_VER
+// Out of line, so the optimizer cannot see that the byte goes unused.
+void UseCharPointer(const volatile char* pointer);
+#endif
+
+// Makes the compiler assume `value` is read here, so the computation that
+// produced it cannot be dropped as dead code.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#ifdef _MSC_VER
+    UseCharPointer(&reinterpret_cast<const volatile char&>(value));
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Makes the compiler assume all memory is read and written here, so stores
+// before it are neither dropped nor moved past it.
+inline void ClobberMemory() {
+#ifdef _MSC_VER
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct RepeatOptions {
+    int warmup = 1;        // untimed calls first: caches, page faults, clock ramp-up
+    int repetitions = 10;  // timed calls
+};
+
+// Calls `run` warmup times, discarding what it returns, then repetitions
+// times; returns the timed calls' results (each one score sample).
+template <typename Run>
+std::vector<double> Repeat(Run&& run, const RepeatOptions& options) {
+    for (int i = 0; i < options.warmup; ++i) {
+        DoNotOptimize(run());
+    }
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    for (int i = 0; i < options.repetitions; ++i) {
+        samples.push_back(run());
+    }
+    return samples;
+}
+
+// Middle value, or the mean of the two middle values; 0 when empty. By
+// value: the elements are reordered, so callers move in a scratch copy.
+double Median(std::vector<double> values);
+
+// Drops samples whose modified z-score (distance from the median in units
+// of 1.4826 MAD) exceeds 3.5, the Iglewicz-Hoaglin cut-off.
+std::vector<double> RejectOutliers(std::span<const double> samples);
+
+// Median, MAD and a distribution-free 95% confidence interval for the
+// median (order statistics), after RejectOutliers.
+ScoreStats SummarizeSamples(std::span<const double> samples);
+
+// "median 12.3, MAD 0.1, 95% CI 12.1-12.5, 10 runs (1 outlier dropped)".
+std::string FormatStats(const ScoreStats& stats);
+
+struct SampleComparison {
+    bool enoughSamples = false;  // both sides had kMinCompareSamples after outlier rejection
+    double change = 0.0;         // current median / baseline median - 1
+    double pValue = 1.0;         // two-sided
+    bool significant = false;    // pValue below the requested level
+};
+
+inline constexpr size_t kMinCompareSamples = 5;
+
+// Mann-Whitney U test (normal approximation, tie-corrected) of whether the
+// current samples come from a different distribution than the baseline's.
+// Rank-based, so long tails from preemption do not swamp it.
+SampleComparison CompareSamples(std::span<const double> baseline, std::span<const double> current,
+                                double alpha = 0.05);
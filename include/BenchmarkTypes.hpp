@@ -1,12 +1,61 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <vector>
+
+// One CPU kernel at one instruction-set level, on one thread (all threads
+// in the scaling sweep), or one workload of the workload suite on all
+// threads.
+struct KernelScore {
+    std::string kernel;  // CpuKernelName, or one of kWorkloadKernels
+    std::string isa;     // SimdIsaName; empty for workloads, which are built for the baseline ISA
+    double gops = 0.0;   // billions of operations (a workload's own unit) per second
+};
+
+// One physical core, measured with workers pinned to its logical CPUs.
+struct CoreScore {
+    unsigned core = 0;
+    std::string type;           // CoreTypeName
+    std::vector<unsigned> cpus;  // its logical CPUs; more than one with SMT
+    std::vector<double> alone;  // per logical CPU: its score with nothing else running
+    double together = 0.0;      // all of them at once; 0 without SMT
+};
+
+struct CurvePoint {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+// One measured series, such as bandwidth against working-set size.
+struct BenchmarkCurve {
+    std::string name;
+    std::string xUnit;
+    std::string yUnit;
+    std::vector<CurvePoint> points;  // ascending x
+};
+
+// Spread of a score's repeated measurements, outliers dropped
+// (BenchmarkStats.hpp).
+struct ScoreStats {
+    size_t samples = 0;   // kept
+    size_t outliers = 0;  // dropped
+    double median = 0.0;
+    double mad = 0.0;     // median absolute deviation
+    double ciLow = 0.0;   // 95% confidence interval of the median
+    double ciHigh = 0.0;
+};
 
 struct BenchmarkResultData {
-    double score = 0.0;
+    double score = 0.0;  // the median of `samples` when there are several
     std::string unit;
     std::string details;
+    std::vector<KernelScore> kernels;    // CPU: every kernel at every level the CPU runs; workloads, scaling: each one
+    std::vector<CoreScore> cores;        // CPU per-core mode only: fastest core type first
+    std::vector<BenchmarkCurve> curves;  // memory suite, sustained and scaling runs only
+    std::vector<double> samples;         // the score's timed repetitions, warmup excluded
+    ScoreStats stats;
 };
 
 struct BenchmarkSnapshot {
@@ -14,4 +63,12 @@ struct BenchmarkSnapshot {
     std::optional<BenchmarkResultData> baselineGpu;
     std::optional<BenchmarkResultData> currentCpu;
     std::optional<BenchmarkResultData> currentGpu;
+    std::optional<BenchmarkResultData> baselineMemory;
+    std::optional<BenchmarkResultData> currentMemory;
+    std::optional<BenchmarkResultData> baselineWorkloads;
+    std::optional<BenchmarkResultData> currentWorkloads;
+    std::optional<BenchmarkResultData> baselineSustained;
+    std::optional<BenchmarkResultData> currentSustained;
+    std::optional<BenchmarkResultData> baselineScaling;
+    std::optional<BenchmarkResultData> currentScaling;
 };
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Serialization helpers for the app's own binary files (StartupCache,
+// BenchmarkHistory). Native-endian: the files never leave the machine
+// that wrote them.
+
+// FNV-1a, stored beside a payload so a damaged file reads as missing
+// rather than as plausible but wrong data.
+inline std::uint64_t BinaryChecksum(std::string_view data) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char c : data) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+class BinaryWriter {
+public:
+    void Bytes(const void* data, size_t size) {
+        const auto* bytes = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+    void U32(std::uint32_t value) { Bytes(&value, sizeof(value)); }
+    void U64(std::uint64_t value) { Bytes(&value, sizeof(value)); }
+    void I64(std::int64_t value) { Bytes(&value, sizeof(value)); }
+    void F32(float value) { Bytes(&value, sizeof(value)); }
+    void F64(double value) { Bytes(&value, sizeof(value)); }
+    void String(const std::string& text) {
+        U32(static_cast<std::uint32_t>(text.size()));
+        Bytes(text.data(), text.size());
+    }
+    // wchar_t is 2 bytes on Windows and 4 elsewhere; store 32-bit units.
+    void WideString(const std::wstring& text) {
+        U32(static_cast<std::uint32_t>(text.size()));
+        for (const wchar_t c : text) {
+            U32(static_cast<std::uint32_t>(c));
+        }
+    }
+    void StringList(const std::vector<std::string>& items) {
+        U32(static_cast<std::uint32_t>(items.size()));
+        for (const auto& item : items) {
+            String(item);
+        }
+    }
+
+    const std::string& Buffer() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+// Bounds-checked reader; after the first short read every call fails, so
+// callers check Ok() once at the end. Lengths are checked against the
+// bytes left before anything is allocated.
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view data) : data_(data) {}
+
+    bool Ok() const { return ok_; }
+    bool AtEnd() const { return ok_ && pos_ == data_.size(); }
+
+    bool Bytes(void* out, size_t size) {
+        if (!ok_ || data_.size() - pos_ < size) {
+            ok_ = false;
+            return false;
+        }
+        std::memcpy(out, data_.data() + pos_, size);
+        pos_ += size;
+        return true;
+    }
+    std::uint32_t U32() { return Value<std::uint32_t>(); }
+    std::uint64_t U64() { return Value<std::uint64_t>(); }
+    std::int64_t I64() { return Value<std::int64_t>(); }
+    float F32() { return Value<float>(); }
+    double F64() { return Value<double>(); }
+    // Count of items that each take at least `minItemSize` bytes.
+    std::uint32_t Count(size_t minItemSize) {
+        const std::uint32_t count = U32();
+        if (ok_ && (data_.size() - pos_) / minItemSize < count) {
+            ok_ = false;
+            return 0;
+        }
+        return count;
+    }
+    std::string String() {
+        const std::uint32_t size = Count(1);
+        std::string text;
+        if (ok_) {
+            text.assign(data_.data() + pos_, size);
+            pos_ += size;
+        }
+        return text;
+    }
+    std::wstring WideString() {
+        const std::uint32_t size = Count(sizeof(std::uint32_t));
+        std::wstring text;
+        text.reserve(size);
+        for (std::uint32_t i = 0; i < size && ok_; ++i) {
+            text.push_back(static_cast<wchar_t>(U32()));
+        }
+        return text;
+    }
+    std::vector<std::string> StringList() {
+        const std::uint32_t count = Count(sizeof(std::uint32_t));
+        std::vector<std::string> items;
+        items.reserve(count);
+        for (std::uint32_t i = 0; i < count && ok_; ++i) {
+            items.push_back(String());
+        }
+        return items;
+    }
+
+private:
+    template <typename T>
+    T Value() {
+        T value{};
+        Bytes(&value, sizeof(value));
+        return value;
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
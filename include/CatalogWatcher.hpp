@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Watches the directory holding the profile catalog, so that in-place
+// writes and editors' write-then-rename saves are both seen. Linux uses
+// inotify and Windows a change-notification handle; on other platforms
+// IsActive() is false and the catalog is only read at startup.
+class CatalogWatcher {
+public:
+    explicit CatalogWatcher(const std::filesystem::path& catalogPath);
+    ~CatalogWatcher();
+
+    CatalogWatcher(const CatalogWatcher&) = delete;
+    CatalogWatcher& operator=(const CatalogWatcher&) = delete;
+
+    bool IsActive() const { return handle_ != kInvalidHandle; }
+    // The inotify descriptor (Linux) or notification HANDLE (Windows) for
+    // an event loop; it becomes readable/signalled when something changed.
+    std::intptr_t NativeHandle() const { return handle_; }
+    // Drains pending notifications and reports whether any may concern the
+    // catalog JSON or its compiled image. Windows notifications carry no
+    // file names, so any change in the directory counts there.
+    bool ConsumeChanges();
+
+private:
+    static constexpr std::intptr_t kInvalidHandle = -1;
+
+    std::string jsonName_;
+    std::string binaryName_;
+    std::intptr_t handle_ = kInvalidHandle;
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "CpuKernels.hpp"
+
+// Kernel bodies shared by the per-ISA translation units (src/CpuKernels*.cpp),
+// written against an `Ops` traits type wrapping one vector type: Scalar,
+// Vec, kLanes, Set1, Load, Store, and MulAdd(a, b, c) = a * b + c for
+// floating point or Add, Xor and ShiftRight (by kAluShift) for unsigned
+// integers. Each unit declares its traits in an anonymous namespace, so
+// every instantiation stays local to code compiled for that ISA. For the
+// same reason the bodies make no library calls: an inline function emitted
+// under AVX-512 flags might otherwise be the copy the linker keeps for all.
+
+struct CpuKernelTable {
+    KernelFn kernels[kCpuKernels.size()] = {};  // indexed by CpuKernel; null when not built
+};
+
+CpuKernelTable ScalarCpuKernels();
+CpuKernelTable Sse42CpuKernels();
+CpuKernelTable Avx2CpuKernels();
+CpuKernelTable Avx512CpuKernels();
+
+// Independent accumulators per kernel: enough to hide a 4-cycle FMA
+// latency on two ports, so the loops measure throughput and not latency.
+inline constexpr int kKernelChains = 8;
+inline constexpr int kKernelSteps = 64;   // chain steps per FMA/ALU round
+inline constexpr int kDotLength = 1024;   // elements per dot-product input
+inline constexpr int kAluShift = 7;
+
+// step(k) for every chain, unrolled at compile time: with only constant
+// indices the chain array is kept in registers instead of on the stack.
+template <typename Step, int... Chain>
+void ForEachChain(Step&& step, std::integer_sequence<int, Chain...>) {
+    (step(Chain), ...);
+}
+
+template <typename Step>
+void ForEachChain(Step&& step) {
+    ForEachChain(step, std::make_integer_sequence<int, kKernelChains>());
+}
+
+template <typename Ops>
+double KernelChecksum(const typename Ops::Vec (&chains)[kKernelChains]) {
+    typename Ops::Scalar lanes[Ops::kLanes];
+    double sum = 0.0;
+    for (int k = 0; k < kKernelChains; ++k) {
+        Ops::Store(lanes, chains[k]);
+        for (int lane = 0; lane < Ops::kLanes; ++lane) {
+            sum += static_cast<double>(lanes[lane]);
+        }
+    }
+    return sum;
+}
+
+// x = 0.999 x + 0.001 converges to 1, so the values stay normal.
+template <typename Ops>
+KernelRun FmaKernel(std::uint64_t rounds) {
+    using T = typename Ops::Scalar;
+    typename Ops::Vec chains[kKernelChains];
+    for (int k = 0; k < kKernelChains; ++k) {
+        chains[k] = Ops::Set1(static_cast<T>(1) + static_cast<T>(k) / static_cast<T>(64));
+    }
+    const auto scale = Ops::Set1(static_cast<T>(0.999));
+    const auto offset = Ops::Set1(static_cast<T>(0.001));
+    for (std::uint64_t round = 0; round < rounds; ++round) {
+        for (int step = 0; step < kKernelSteps; ++step) {
+            ForEachChain([&](int k) { chains[k] = Ops::MulAdd(chains[k], scale, offset); });
+        }
+    }
+    return {rounds * kKernelSteps * kKernelChains * Ops::kLanes * 2, KernelChecksum<Ops>(chains)};
+}
+
+// The accumulators carry over between rounds; reducing them every round
+// would cost as much as a round at the widest vectors.
+template <typename Ops>
+KernelRun DotKernel(std::uint64_t rounds) {
+    using T = typename Ops::Scalar;
+    alignas(64) T a[kDotLength];
+    alignas(64) T b[kDotLength];
+    for (int i = 0; i < kDotLength; ++i) {
+        a[i] = static_cast<T>(1) + static_cast<T>(i % 7) / static_cast<T>(8);
+        b[i] = static_cast<T>(1) - static_cast<T>(i % 5) / static_cast<T>(16);
+    }
+    typename Ops::Vec chains[kKernelChains];
+    for (int k = 0; k < kKernelChains; ++k) {
+        chains[k] = Ops::Set1(static_cast<T>(0));
+    }
+    constexpr int stride = kKernelChains * Ops::kLanes;
+    for (std::uint64_t round = 0; round < rounds; ++round) {
+        for (int i = 0; i < kDotLength; i += stride) {
+            ForEachChain([&](int k) {
+                const int at = i + k * Ops::kLanes;
+                chains[k] = Ops::MulAdd(Ops::Load(a + at), Ops::Load(b + at), chains[k]);
+            });
+        }
+    }
+    return {rounds * kDotLength * 2, KernelChecksum<Ops>(chains)};
+}
+
+// x = (x + c) ^ (x >> 7): an add, a shift and a xor per step.
+template <typename Ops>
+KernelRun AluKernel(std::uint64_t rounds) {
+    using T = typename Ops::Scalar;
+    typename Ops::Vec chains[kKernelChains];
+    for (int k = 0; k < kKernelChains; ++k) {
+        chains[k] = Ops::Set1(static_cast<T>(k + 1));
+    }
+    const auto increment = Ops::Set1(static_cast<T>(0x9E3779B9u));
+    for (std::uint64_t round = 0; round < rounds; ++round) {
+        for (int step = 0; step < kKernelSteps; ++step) {
+            ForEachChain([&](int k) {
+                chains[k] = Ops::Xor(Ops::Add(chains[k], increment), Ops::ShiftRight(chains[k]));
+            });
+        }
+    }
+    return {rounds * kKernelSteps * kKernelChains * Ops::kLanes * 3, KernelChecksum<Ops>(chains)};
+}
+
+template <typename F32, typename F64, typename I32, typename I64>
+CpuKernelTable MakeCpuKernelTable() {
+    CpuKernelTable table;
+    table.kernels[static_cast<size_t>(CpuKernel::FmaF32)] = &FmaKernel<F32>;
+    table.kernels[static_cast<size_t>(CpuKernel::FmaF64)] = &FmaKernel<F64>;
+    table.kernels[static_cast<size_t>(CpuKernel::DotF32)] = &DotKernel<F32>;
+    table.kernels[static_cast<size_t>(CpuKernel::DotF64)] = &DotKernel<F64>;
+    table.kernels[static_cast<size_t>(CpuKernel::AluI32)] = &AluKernel<I32>;
+    table.kernels[static_cast<size_t>(CpuKernel::AluI64)] = &AluKernel<I64>;
+    return table;
+}
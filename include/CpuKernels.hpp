@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Instruction-set levels the CPU benchmark kernels are built for. Each
+// level's kernels live in their own translation unit compiled for that
+// level, so only the ones DetectSimdIsa() allows may run.
+enum class SimdIsa { Scalar, Sse42, Avx2, Avx512 };
+
+enum class CpuKernel {
+    FmaF32,  // independent multiply-add chains: peak arithmetic throughput
+    FmaF64,
+    DotF32,  // L1-resident dot product, several accumulators
+    DotF64,
+    AluI32,  // add/shift/xor chains
+    AluI64,
+};
+
+inline constexpr std::array kSimdIsas = {SimdIsa::Scalar, SimdIsa::Sse42, SimdIsa::Avx2, SimdIsa::Avx512};
+inline constexpr std::array kCpuKernels = {CpuKernel::FmaF32, CpuKernel::FmaF64, CpuKernel::DotF32,
+                                           CpuKernel::DotF64, CpuKernel::AluI32, CpuKernel::AluI64};
+
+// What one kernel call did: floating-point or integer operations (a
+// multiply-add counts as two), and a checksum the caller keeps so the
+// work cannot be optimized away.
+struct KernelRun {
+    std::uint64_t operations = 0;
+    double checksum = 0.0;
+};
+
+using KernelFn = KernelRun (*)(std::uint64_t rounds);
+
+const char* SimdIsaName(SimdIsa isa);
+const char* CpuKernelName(CpuKernel kernel);
+// Highest level both the CPU (CPUID) and the OS (XGETBV register state)
+// support; Scalar off x86.
+SimdIsa DetectSimdIsa();
+// The kernel built for `isa`, or nullptr when this build has none (non-x86
+// targets, or a compiler without that instruction set). Callers check the
+// level against DetectSimdIsa() before running it.
+KernelFn FindCpuKernel(CpuKernel kernel, SimdIsa isa);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Hybrid parts mix core types; Uniform when all cores are alike (or the
+// platform does not say).
+enum class CoreType { Uniform, Performance, Efficiency };
+
+struct LogicalCpu {
+    // The OS's number for it: cpuN on Linux, group * 64 + number on Windows.
+    unsigned index = 0;
+    unsigned core = 0;  // physical core, numbered from 0; SMT siblings share it
+    CoreType type = CoreType::Uniform;
+};
+
+// The online logical CPUs in OS order, from sysfs on Linux and
+// GetLogicalProcessorInformationEx on Windows. Empty where threads cannot
+// be pinned (macOS offers only affinity hints), so the per-core benchmark
+// has nothing to run there.
+std::vector<LogicalCpu> QueryCpuTopology();
+
+const char* CoreTypeName(CoreType type);
+
+// Restricts the calling thread to `cpu`; false if the OS refused.
+bool PinCurrentThread(const LogicalCpu& cpu);
+
+struct CacheLevel {
+    unsigned level = 0;       // 1 for L1
+    std::uint64_t bytes = 0;  // one instance
+    unsigned sharedBy = 1;    // logical CPUs per instance
+};
+
+// The data and unified caches of the first CPU, L1 first: sysfs on Linux,
+// GetLogicalProcessorInformationEx on Windows, hw.* sysctls on macOS.
+// Empty where the OS does not say.
+std::vector<CacheLevel> QueryCacheLevels();
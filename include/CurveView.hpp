@@ -0,0 +1,32 @@
+#pragma once
+
+#include <optional>
+
+#include <QWidget>
+
+#include "BenchmarkTypes.hpp"
+
+class QPaintEvent;
+
+// Plots the sustained benchmark's throughput over time: the baseline run
+// in gray, the current one in the palette's highlight color, each with its
+// steady-state level dashed from the time it settled. Hidden until either
+// run has a throughput curve.
+class CurveView : public QWidget {
+public:
+    explicit CurveView(QWidget* parent = nullptr);
+
+    void SetRuns(const std::optional<BenchmarkResultData>& baseline,
+                 const std::optional<BenchmarkResultData>& current);
+
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    std::optional<BenchmarkCurve> baseline_;
+    std::optional<BenchmarkCurve> current_;
+    std::optional<CurvePoint> baselineSteady_;  // settle time and steady score
+    std::optional<CurvePoint> currentSteady_;
+};
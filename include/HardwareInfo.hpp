@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,13 @@ struct CpuInfo {
     std::string vendor;
     unsigned logicalCores = 0;
     unsigned physicalCores = 0;
+    // Display family/model (extended fields folded in) from CPUID leaf 1;
+    // zero when the platform does not expose CPUID.
+    unsigned family = 0;
+    unsigned model = 0;
+    unsigned stepping = 0;
+
+    bool operator==(const CpuInfo&) const = default;
 };
 
 struct GpuInfo {
@@ -15,14 +23,51 @@ struct GpuInfo {
     std::wstring vendor;
     size_t dedicatedVideoMemoryMB = 0;
     unsigned adapterIndex = 0;
+    // PCI IDs; zero when unknown. The subsystem ID holds the subsystem
+    // device in its high half and the subsystem vendor in its low half.
+    unsigned vendorId = 0;
+    unsigned deviceId = 0;
+    unsigned subsystemId = 0;
+    unsigned revision = 0;
+    // PCI location as nvidia-smi prints it ("00000000:01:00.0"); empty when
+    // unknown. Unlike adapterIndex it names the same card to every tool.
+    std::string pciBusId;
+
+    bool operator==(const GpuInfo&) const = default;
 };
 
+// One adapter appearing or disappearing while the app runs. A removal's
+// index is the adapter's position when the change applies; an addition's
+// is its position once added. Applied in order, the changes DiffGpus
+// returns turn the old adapter list into the new one.
+struct GpuChange {
+    enum class Kind { Added, Removed };
+
+    Kind kind = Kind::Added;
+    size_t index = 0;
+    GpuInfo gpu;
+};
+
+// Removals (highest index first), then additions (lowest first). Adapters
+// are paired up in order, ignoring adapterIndex (an adapter that merely
+// moved in the enumeration is not a change), so an added adapter's
+// adapterIndex is current while a kept one's may be stale.
+std::vector<GpuChange> DiffGpus(const std::vector<GpuInfo>& before, const std::vector<GpuInfo>& after);
+
 struct HardwareSnapshot {
     CpuInfo cpu;
     std::vector<GpuInfo> gpus;
+
+    bool operator==(const HardwareSnapshot&) const = default;
 };
 
 class HardwareInfoService {
 public:
     HardwareSnapshot QueryHardware() const;
+    // Just the GPU part of QueryHardware, for re-enumerating on hotplug.
+    std::vector<GpuInfo> EnumerateGpus() const;
+    // Hash of what can be read without enumerating GPUs (CPU identity,
+    // core counts, machine model); a changed value means QueryHardware
+    // would differ, an unchanged one does not rule it out.
+    std::uint64_t Fingerprint() const;
 };
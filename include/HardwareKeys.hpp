@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "HardwareInfo.hpp"
+
+// CPUID identity. In the catalog it is written as hex fields,
+// "GenuineIntel:06:9E" or with a stepping "GenuineIntel:06:9E:0A"; without
+// one it covers every stepping.
+struct CpuIdKey {
+    std::string vendor;
+    std::uint32_t family = 0;
+    std::uint32_t model = 0;
+    std::optional<std::uint32_t> stepping;
+
+    static std::optional<CpuIdKey> Parse(std::string_view text);
+    // Nullopt when the platform did not report CPUID values.
+    static std::optional<CpuIdKey> FromInfo(const CpuInfo& info);
+    // Whether a catalog key covers a detected device.
+    bool Covers(const CpuIdKey& device) const;
+    bool operator==(const CpuIdKey&) const = default;
+};
+
+// PCI identity, written like lspci as "10DE:2684" or with the subsystem
+// (subsystem device in the high half, vendor in the low half, as DXGI
+// reports it) as "10DE:2684:889D1043".
+struct PciIdKey {
+    std::uint16_t vendorId = 0;
+    std::uint16_t deviceId = 0;
+    std::optional<std::uint32_t> subsystemId;
+
+    static std::optional<PciIdKey> Parse(std::string_view text);
+    static std::optional<PciIdKey> FromInfo(const GpuInfo& info);
+    bool Covers(const PciIdKey& device) const;
+    bool operator==(const PciIdKey&) const = default;
+};
+
+struct CpuIdKeyHash {
+    size_t operator()(const CpuIdKey& key) const;
+};
+
+struct PciIdKeyHash {
+    size_t operator()(const PciIdKey& key) const;
+};
+
+// Hash index from structured keys to profile indices. A lookup probes the
+// exact key and its wildcard (no stepping / no subsystem) form, so it is
+// two hash lookups regardless of catalog size.
+class HardwareIdIndex {
+public:
+    void AddCpu(const CpuIdKey& key, std::uint32_t profileIndex);
+    void AddGpu(const PciIdKey& key, std::uint32_t profileIndex);
+
+    // Profiles keyed for the device, ascending and without duplicates;
+    // empty when none is, in which case token matching applies.
+    std::vector<std::uint32_t> FindCpu(const CpuIdKey& device) const;
+    std::vector<std::uint32_t> FindGpu(const PciIdKey& device) const;
+
+    bool Empty() const { return cpu_.empty() && gpu_.empty(); }
+
+private:
+    std::unordered_map<CpuIdKey, std::vector<std::uint32_t>, CpuIdKeyHash> cpu_;
+    std::unordered_map<PciIdKey, std::vector<std::uint32_t>, PciIdKeyHash> gpu_;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "HardwareInfo.hpp"
+
+// Reports GPU adapters being added or removed (eGPU docks, hotplug) while
+// the app runs. Linux listens to the kernel's PCI uevents over netlink and
+// Windows registers for DXGI's adapters-changed event; both only wake the
+// event loop when the device set changes. On other platforms IsActive()
+// is false and adapters are only enumerated at startup.
+class HardwareWatcher {
+public:
+    HardwareWatcher();
+    ~HardwareWatcher();
+
+    HardwareWatcher(const HardwareWatcher&) = delete;
+    HardwareWatcher& operator=(const HardwareWatcher&) = delete;
+
+    bool IsActive() const { return handle_ != kInvalidHandle; }
+    // The netlink socket (Linux) or event HANDLE (Windows) for an event
+    // loop; it becomes readable/signalled when devices changed.
+    std::intptr_t NativeHandle() const { return handle_; }
+    // Drains pending notifications and reports whether any may concern a
+    // display adapter. Windows notifications carry no detail, so any
+    // counts there.
+    bool ConsumeEvents();
+    // Re-enumerates the GPUs and returns how they differ from `current`
+    // (see DiffGpus). Devices settle a moment after their notification,
+    // so callers debounce between the two.
+    std::vector<GpuChange> CollectChanges(const std::vector<GpuInfo>& current) const;
+
+private:
+    static constexpr std::intptr_t kInvalidHandle = -1;
+
+    std::intptr_t handle_ = kInvalidHandle;
+#ifdef _WIN32
+    void* factory_ = nullptr;  // IDXGIFactory7 holding the registration
+    unsigned long cookie_ = 0;
+#endif
+};
@@ -1,46 +1,119 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <QMainWindow>
 
 #include "AppState.hpp"
 
+class BenchmarkControl;
+class BenchmarkHistory;
+class CatalogWatcher;
+class CurveView;
+class HardwareWatcher;
+class QCheckBox;
+class QComboBox;
 class QListWidget;
 class QLabel;
+class QProgressBar;
 class QPushButton;
+class QSpinBox;
+class QTimer;
+struct BenchmarkProgress;
+struct BenchmarkReport;
+struct RegressionCheck;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
 public:
     explicit MainWindow(QWidget* parent = nullptr);
+    ~MainWindow() override;
 
 private slots:
     void HandleCpuSelection(int row);
+    void HandleGpuAdapterChanged(int index);
     void HandleGpuSelection(int row);
     void ApplyCpuTarget();
-    void ApplyGpuTarget();
+    void ApplyGpuTargets();
     void RestoreDefaults();
     void RunBaselineBenchmark();
     void RunCurrentBenchmark();
+    void CancelBenchmark();
+    void HandleCatalogActivity();
+    void ReloadProfiles();
+    void HandleHardwareActivity();
+    void ApplyHardwareChanges();
 
 private:
     void InitializeState();
+    void StartCatalogWatch();
+    void StartHardwareWatch();
+    void StartHardwareRevalidation();
+    void HandleProbedHardware(const HardwareSnapshot& probed);
+    void StartFullCatalogLoad();
+    void HandleFullCatalog(const ProfileCatalog& full);
+    void RematchHardware(const QString& status);
+    void SaveStartupCache();
+    void SyncEngineResults();
+    void SyncGpuAdapter(size_t adapter);
     void PopulateLists();
+    void PopulateGpuAdapters();
+    void PopulateGpuList();
+    std::optional<CpuThrottleTarget> CpuTargetAtRow(int row) const;
+    std::optional<GpuThrottleTarget> GpuTargetAtRow(size_t adapter, int row) const;
+    std::string SelectedCpuTargetId() const;
+    std::vector<std::string> SelectedGpuTargetIds() const;
+    void ClearSelection();
+    void RestoreSelection(const std::string& cpuTargetId, const std::vector<std::string>& gpuTargetIds);
     void UpdateSnapshotLabel();
     void UpdateStatus(const QString& text);
     void UpdateButtonStates();
     void RunBenchmark(bool baseline);
+    void HandleBenchmarkProgress(const BenchmarkProgress& progress);
+    void StoreBenchmarkReport(const BenchmarkReport& report, bool complete);
+    void FinishBenchmark(const BenchmarkReport& report, const std::vector<RegressionCheck>& checks);
+    void SetBenchmarkRunning(bool running);
     void UpdateBenchmarkLabels();
     std::optional<double> ComputeExpectedCpuScore() const;
     std::optional<double> ComputeExpectedGpuScore() const;
     QString FormatScoreLabel(const std::optional<BenchmarkResultData>& data) const;
     bool ConfirmHighImpact(const QString& targetLabel) const;
     std::filesystem::path ResolveProfilesPath() const;
+    std::filesystem::path ResolveStartupCachePath() const;
 
     AppState state_;
+    std::filesystem::path profilePath_;
+    std::unique_ptr<CatalogWatcher> catalogWatcher_;
+    QObject* catalogNotifier_ = nullptr;
+    QTimer* reloadTimer_ = nullptr;
+    std::unique_ptr<HardwareWatcher> hardwareWatcher_;
+    QObject* hardwareNotifier_ = nullptr;
+    QTimer* hotplugTimer_ = nullptr;
+    std::filesystem::path startupCachePath_;
+    std::uint64_t hardwareFingerprint_ = 0;
+    std::thread probeThread_;  // background re-probe on a warm start
+    std::thread catalogThread_;  // full load behind a partial startup catalog
+    bool catalogLoading_ = false;
+    std::thread benchmarkThread_;
+    std::shared_ptr<BenchmarkControl> benchmarkControl_;  // set while a benchmark runs
+    bool benchmarkBaseline_ = false;  // where the running benchmark's results go
+    bool benchmarkMemory_ = false;    // whether it includes the memory suite
+    bool benchmarkWorkloads_ = false;  // and the workload suite
+    bool benchmarkSustained_ = false;  // and a sustained run
+    bool benchmarkScaling_ = false;    // and the thread-scaling sweep
+    std::unique_ptr<BenchmarkHistory> benchmarkHistory_;  // opened by the first benchmark
+    // Last applied successfully, for the history keys; empty once restored.
+    std::string appliedCpuTarget_;
+    std::string appliedGpuTarget_;  // on adapter 0, the one the GPU benchmark measures
     QListWidget* cpuList_ = nullptr;
+    QComboBox* gpuAdapterBox_ = nullptr;
     QListWidget* gpuList_ = nullptr;
     QLabel* snapshotLabel_ = nullptr;
     QPushButton* applyCpuButton_ = nullptr;
@@ -48,10 +121,28 @@ private:
     QPushButton* restoreButton_ = nullptr;
     QPushButton* runBaselineButton_ = nullptr;
     QPushButton* runCurrentButton_ = nullptr;
+    QPushButton* cancelBenchmarkButton_ = nullptr;
+    QSpinBox* repetitionsBox_ = nullptr;
+    QProgressBar* benchmarkProgress_ = nullptr;
+    QCheckBox* perCoreCheck_ = nullptr;
+    QCheckBox* memoryCheck_ = nullptr;
+    QCheckBox* hugePagesCheck_ = nullptr;
+    QCheckBox* workloadsCheck_ = nullptr;
+    QSpinBox* sustainedBox_ = nullptr;  // seconds; 0 is off
+    QCheckBox* scalingCheck_ = nullptr;
     QLabel* cpuBaselineLabel_ = nullptr;
     QLabel* cpuCurrentLabel_ = nullptr;
     QLabel* cpuExpectedLabel_ = nullptr;
     QLabel* gpuBaselineLabel_ = nullptr;
     QLabel* gpuCurrentLabel_ = nullptr;
     QLabel* gpuExpectedLabel_ = nullptr;
+    QLabel* memoryBaselineLabel_ = nullptr;
+    QLabel* memoryCurrentLabel_ = nullptr;
+    QLabel* workloadsBaselineLabel_ = nullptr;
+    QLabel* workloadsCurrentLabel_ = nullptr;
+    QLabel* sustainedBaselineLabel_ = nullptr;
+    QLabel* sustainedCurrentLabel_ = nullptr;
+    CurveView* sustainedCurve_ = nullptr;
+    QLabel* scalingBaselineLabel_ = nullptr;
+    QLabel* scalingCurrentLabel_ = nullptr;
 };
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <optional>
+
+#include "BenchmarkControl.hpp"
+#include "BenchmarkTypes.hpp"
+#include "HardwareInfo.hpp"
+
+// Curve names in the memory suite's BenchmarkResultData::curves.
+inline constexpr const char* kReadCurve = "read";        // KiB working set -> GB/s, one thread
+inline constexpr const char* kLatencyCurve = "latency";  // KiB working set -> ns per dependent load
+inline constexpr const char* kStreamCurves[] = {"copy", "scale", "add", "triad"};  // threads -> GB/s
+
+struct MemoryBenchmarkOptions {
+    // Back every buffer with huge pages: hugetlbfs pages, else transparent
+    // huge pages on Linux, MEM_LARGE_PAGES on Windows (needs the "Lock
+    // pages in memory" right). Without it the buffers stay on base pages,
+    // so comparing the two runs shows what TLB misses cost.
+    bool hugePages = false;
+};
+
+// Cache and memory hierarchy: a working-set sweep from L1 to DRAM (read
+// bandwidth and pointer-chase latency at each size, one thread) and
+// STREAM copy/scale/add/triad bandwidth over 1, 2, 4... threads, each
+// thread on its own arrays. The headline score is triad on all threads,
+// the median of its timed calls.
+class MemoryBenchmark {
+public:
+    // Reports progress to `control` and stops (returning nothing) once it
+    // is cancelled.
+    std::optional<BenchmarkResultData> Run(const HardwareSnapshot& snapshot, const MemoryBenchmarkOptions& options = {},
+                                           BenchmarkControl* control = nullptr) const;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class ProfileCatalog;
+
+// Projected fraction of full performance under a target's caps: the
+// tightest cap wins, and a cap or nominal value of 0 means none. This is
+// the model behind both the index and the benchmark panel's "expected"
+// scores.
+double ProjectedCpuFactor(int maxPercent, int maxFrequencyMHz, int nominalFrequencyMHz);
+double ProjectedGpuFactor(int maxFrequencyMHz, int powerLimitWatts, int nominalFrequencyMHz, int nominalPowerWatts);
+
+// Relative performance of every CPU and GPU profile in a catalog, so a
+// device can mimic any SKU there rather than only the tiers its profile
+// lists. Each listed tier whose "Mimic <label>" names another profile is
+// a measured ratio between two profiles (the projected factor of its
+// caps); the scores are the least-squares fit of those ratios. The
+// ratios only link profiles into groups (directly or through others), and
+// a group's overall level comes from the nominal clock (and, for GPUs,
+// power) of its members, so scores are only comparable within a group:
+// clock alone says little across CPU segments, say. Scores are normalized
+// so the fastest profile of each kind is 1.
+class PerformanceIndex {
+public:
+    static constexpr std::uint32_t kNoProfile = ~0u;
+
+    PerformanceIndex() = default;
+    explicit PerformanceIndex(const ProfileCatalog& catalog);
+
+    double CpuScore(std::uint32_t profile) const { return cpuScores_[profile]; }
+    double GpuScore(std::uint32_t profile) const { return gpuScores_[profile]; }
+    std::uint32_t CpuGroup(std::uint32_t profile) const { return cpuGroups_[profile]; }
+    std::uint32_t GpuGroup(std::uint32_t profile) const { return gpuGroups_[profile]; }
+    // Profile indices, fastest first.
+    std::span<const std::uint32_t> CpuRanking() const { return cpuRanking_; }
+    std::span<const std::uint32_t> GpuRanking() const { return gpuRanking_; }
+    // The profile a listed target mimics, by target index, or kNoProfile
+    // when its label names no single other profile.
+    std::uint32_t CpuTargetMimics(std::uint32_t target) const { return cpuTargetMimics_[target]; }
+    std::uint32_t GpuTargetMimics(std::uint32_t target) const { return gpuTargetMimics_[target]; }
+
+private:
+    std::vector<double> cpuScores_;
+    std::vector<double> gpuScores_;
+    std::vector<std::uint32_t> cpuGroups_;
+    std::vector<std::uint32_t> gpuGroups_;
+    std::vector<std::uint32_t> cpuRanking_;
+    std::vector<std::uint32_t> gpuRanking_;
+    std::vector<std::uint32_t> cpuTargetMimics_;
+    std::vector<std::uint32_t> gpuTargetMimics_;
+};
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
+#include "HardwareInfo.hpp"
 #include "ProfileLoader.hpp"
 
 struct ThrottleResult {
@@ -10,14 +14,48 @@ struct ThrottleResult {
     std::wstring message;
 };
 
+// A GPU target bound to one adapter. `device` is what nvidia-smi's `-i`
+// gets: the adapter's PCI bus id (NvidiaSmiDevice).
+struct GpuAdapterTarget {
+    std::string device;
+    GpuThrottleTarget target;
+};
+
+// What RestoreGpuDefaults puts back on one adapter: locked clocks are
+// cleared and the power limit goes back to the board's own default
+// (nvidia-smi's power.default_limit), whatever profile it matched.
+struct GpuAdapterDefaults {
+    std::string device;
+};
+
+// The adapter's `-i` argument for nvidia-smi: its PCI bus id, since
+// nvidia-smi's own indices follow PCI order, not the probe's (DXGI lists
+// the display adapter first). Nullopt for other vendors and for adapters
+// whose location is unknown, which nothing could address reliably.
+std::optional<std::string> NvidiaSmiDevice(const GpuInfo& gpu);
+
+struct GpuAdapterResult {
+    std::string device;
+    ThrottleResult result;
+};
+
 class PowerThrottler {
 public:
     PowerThrottler() = default;
 
+    // Plain targets rather than catalog views, so synthesized ones apply
+    // like listed tiers.
     ThrottleResult ApplyCpuTarget(const CpuThrottleTarget& target);
-    ThrottleResult ApplyGpuTarget(const GpuThrottleTarget& target);
+    ThrottleResult ApplyGpuTarget(const std::string& device, const GpuThrottleTarget& target);
+    // Configures the adapters concurrently, one worker each; results come
+    // back in input order.
+    std::vector<GpuAdapterResult> ApplyGpuTargets(std::span<const GpuAdapterTarget> targets);
     ThrottleResult RestoreDefaults();
+    ThrottleResult RestoreGpuDefaults(const GpuAdapterDefaults& adapter);
+    // Concurrent like ApplyGpuTargets.
+    std::vector<GpuAdapterResult> RestoreGpuDefaults(std::span<const GpuAdapterDefaults> adapters);
 
 private:
-    ThrottleResult RunCommand(const std::wstring& commandLine) const;
+    // With `output`, the command's stdout is captured into it.
+    ThrottleResult RunCommand(const std::wstring& commandLine, std::string* output = nullptr) const;
 };
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "ProfileLoader.hpp"
+#include "TokenMatcher.hpp"
+
+// On-disk layout of a compiled catalog (`profilec`). Every reference is an
+// offset or index relative to the image start, so the file can be mapped
+// at any address and read in place. Integers are little-endian.
+namespace catalog_image {
+
+inline constexpr char kMagic[8] = {'H', 'W', 'L', 'C', 'A', 'T', '\0', '\0'};
+inline constexpr std::uint32_t kVersion = 3;
+inline constexpr std::uint32_t kRequiresConfirmation = 1u << 0;
+
+struct StringRef {
+    std::uint32_t offset = 0;  // into the string pool
+    std::uint32_t length = 0;
+};
+
+struct Range {
+    std::uint32_t first = 0;  // element index into the referenced table
+    std::uint32_t count = 0;
+};
+
+struct Section {
+    std::uint32_t offset = 0;  // byte offset from the image start
+    std::uint32_t count = 0;   // elements, or bytes for the string pool
+};
+
+// Targets are stored column-wise: one section per field, each holding one
+// element per target, so reading a field touches only its own column.
+struct CpuTargetColumns {
+    Section id;               // StringRef
+    Section label;            // StringRef
+    Section maxFrequencyMHz;  // int32
+    Section maxCores;         // int32
+    Section maxThreads;       // int32
+    Section maxPercent;       // int32
+    Section extraCommands;    // Range into stringRefs
+    Section flags;            // uint32
+};
+
+struct GpuTargetColumns {
+    Section id;               // StringRef
+    Section label;            // StringRef
+    Section maxFrequencyMHz;  // int32
+    Section powerLimitWatts;  // int32
+    Section nvidiaSmiArgs;    // Range into stringRefs
+    Section flags;            // uint32
+};
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t totalSize;
+    std::uint64_t sourceHash;
+    Section cpuProfiles;
+    Section gpuProfiles;
+    CpuTargetColumns cpuTargets;
+    GpuTargetColumns gpuTargets;
+    Section stringRefs;
+    Section stringPool;
+};
+
+struct CpuProfileRecord {
+    StringRef id;
+    StringRef label;
+    Range matchTokens;  // into stringRefs
+    Range targets;      // into the cpuTargets columns
+    Range cpuIds;       // into stringRefs
+    std::int32_t nominalFrequencyMHz;
+    std::uint32_t reserved;
+};
+
+struct GpuProfileRecord {
+    StringRef id;
+    StringRef label;
+    Range matchTokens;  // into stringRefs
+    Range targets;      // into the gpuTargets columns
+    Range pciIds;       // into stringRefs
+    std::int32_t nominalFrequencyMHz;
+    std::int32_t nominalPowerWatts;
+};
+
+static_assert(sizeof(Header) == 168);
+static_assert(sizeof(CpuProfileRecord) == 48);
+static_assert(sizeof(GpuProfileRecord) == 48);
+static_assert(std::is_trivially_copyable_v<Header>);
+
+}  // namespace catalog_image
+
+class ProfileCatalog;
+class PerformanceIndex;
+
+// Index of a target within one catalog image. Unlike a view it holds no
+// pointer, so it can be stored and later resolved with
+// ProfileCatalog::CpuTarget/GpuTarget against the same catalog.
+struct CpuTargetHandle {
+    std::uint32_t index = 0;
+    bool operator==(const CpuTargetHandle&) const = default;
+};
+
+struct GpuTargetHandle {
+    std::uint32_t index = 0;
+    bool operator==(const GpuTargetHandle&) const = default;
+};
+
+// Random-access range over consecutive catalog entries; `Accessor::At`
+// turns an element index into a view.
+template <typename Accessor>
+class CatalogList {
+public:
+    using value_type = decltype(Accessor::At(std::declval<const ProfileCatalog*>(), std::uint32_t{}));
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CatalogList::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const ProfileCatalog* catalog, std::uint32_t index) : catalog_(catalog), index_(index) {}
+
+        value_type operator*() const { return Accessor::At(catalog_, index_); }
+        iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator copy = *this;
+            ++index_;
+            return copy;
+        }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+
+    private:
+        const ProfileCatalog* catalog_ = nullptr;
+        std::uint32_t index_ = 0;
+    };
+
+    CatalogList() = default;
+    CatalogList(const ProfileCatalog* catalog, catalog_image::Range range) : catalog_(catalog), range_(range) {}
+
+    size_t size() const { return range_.count; }
+    bool empty() const { return range_.count == 0; }
+    value_type operator[](size_t index) const {
+        return Accessor::At(catalog_, range_.first + static_cast<std::uint32_t>(index));
+    }
+    iterator begin() const { return iterator(catalog_, range_.first); }
+    iterator end() const { return iterator(catalog_, range_.first + range_.count); }
+
+private:
+    const ProfileCatalog* catalog_ = nullptr;
+    catalog_image::Range range_;
+};
+
+struct CatalogStringAccessor {
+    static std::string_view At(const ProfileCatalog* catalog, std::uint32_t index);
+};
+
+using StringListView = CatalogList<CatalogStringAccessor>;
+
+class CpuTargetView {
+public:
+    CpuTargetView(const ProfileCatalog* catalog, std::uint32_t index) : catalog_(catalog), index_(index) {}
+    static CpuTargetView At(const ProfileCatalog* catalog, std::uint32_t index) { return {catalog, index}; }
+
+    std::uint32_t Index() const { return index_; }
+    CpuTargetHandle Handle() const { return {index_}; }
+    std::string_view Id() const;
+    std::string_view Label() const;
+    int MaxFrequencyMHz() const;
+    int MaxCores() const;
+    int MaxThreads() const;
+    int MaxPercent() const;
+    StringListView ExtraCommands() const;
+    bool RequiresConfirmation() const;
+    CpuThrottleTarget Materialize() const;
+
+private:
+    template <typename T>
+    const T& Column(catalog_image::Section catalog_image::CpuTargetColumns::*column) const;
+
+    const ProfileCatalog* catalog_;
+    std::uint32_t index_;
+};
+
+class GpuTargetView {
+public:
+    GpuTargetView(const ProfileCatalog* catalog, std::uint32_t index) : catalog_(catalog), index_(index) {}
+    static GpuTargetView At(const ProfileCatalog* catalog, std::uint32_t index) { return {catalog, index}; }
+
+    std::uint32_t Index() const { return index_; }
+    GpuTargetHandle Handle() const { return {index_}; }
+    std::string_view Id() const;
+    std::string_view Label() const;
+    int MaxFrequencyMHz() const;
+    int PowerLimitWatts() const;
+    StringListView NvidiaSmiArgs() const;
+    bool RequiresConfirmation() const;
+    GpuThrottleTarget Materialize() const;
+
+private:
+    template <typename T>
+    const T& Column(catalog_image::Section catalog_image::GpuTargetColumns::*column) const;
+
+    const ProfileCatalog* catalog_;
+    std::uint32_t index_;
+};
+
+class CpuProfileView {
+public:
+    CpuProfileView(const ProfileCatalog* catalog, std::uint32_t index) : catalog_(catalog), index_(index) {}
+    static CpuProfileView At(const ProfileCatalog* catalog, std::uint32_t index) { return {catalog, index}; }
+
+    std::uint32_t Index() const { return index_; }
+    std::string_view Id() const;
+    std::string_view Label() const;
+    StringListView MatchTokens() const;
+    StringListView CpuIds() const;
+    CatalogList<CpuTargetView> Targets() const;
+    int NominalFrequencyMHz() const { return Record().nominalFrequencyMHz; }
+    CpuProfile Materialize() const;
+    // Hash of every field including the targets; equal fingerprints mean
+    // the profile is unchanged between two catalogs.
+    std::uint64_t Fingerprint() const;
+
+private:
+    const catalog_image::CpuProfileRecord& Record() const;
+
+    const ProfileCatalog* catalog_;
+    std::uint32_t index_;
+};
+
+class GpuProfileView {
+public:
+    GpuProfileView(const ProfileCatalog* catalog, std::uint32_t index) : catalog_(catalog), index_(index) {}
+    static GpuProfileView At(const ProfileCatalog* catalog, std::uint32_t index) { return {catalog, index}; }
+
+    std::uint32_t Index() const { return index_; }
+    std::string_view Id() const;
+    std::string_view Label() const;
+    StringListView MatchTokens() const;
+    StringListView PciIds() const;
+    CatalogList<GpuTargetView> Targets() const;
+    int NominalFrequencyMHz() const { return Record().nominalFrequencyMHz; }
+    int NominalPowerWatts() const { return Record().nominalPowerWatts; }
+    GpuProfile Materialize() const;
+    std::uint64_t Fingerprint() const;
+
+private:
+    const catalog_image::GpuProfileRecord& Record() const;
+
+    const ProfileCatalog* catalog_;
+    std::uint32_t index_;
+};
+
+// Profile ids that differ between two catalogs of one kind.
+struct ProfileChanges {
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    std::vector<std::string> changed;
+
+    bool Empty() const { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+struct CatalogDiff {
+    ProfileChanges cpu;
+    ProfileChanges gpu;
+
+    bool Empty() const { return cpu.Empty() && gpu.Empty(); }
+};
+
+// Read-only view over a compiled catalog image, either memory-mapped from
+// a `profilec` output or compiled in memory from a parsed ProfileDatabase.
+// Copies share the underlying image.
+class ProfileCatalog {
+public:
+    ProfileCatalog() = default;
+
+    // Returns nullopt when the file is missing, truncated, or not a
+    // catalog image of the current version.
+    static std::optional<ProfileCatalog> Map(const std::filesystem::path& path);
+    // `partial` marks a catalog compiled from a hardware-filtered subset
+    // (ProfileLoader::LoadMatching); browsing needs a full load instead.
+    static ProfileCatalog Compile(const ProfileDatabase& database, std::uint64_t sourceHash, bool partial = false);
+    static std::vector<std::byte> BuildImage(const ProfileDatabase& database, std::uint64_t sourceHash);
+    // Writes beside `path` and renames, so a running app never maps a
+    // half-written file. Throws std::runtime_error on failure.
+    static void WriteImage(const std::filesystem::path& path, std::span<const std::byte> image);
+    // Cheap content hash used to detect stale images; not cryptographic.
+    static std::uint64_t HashSource(std::string_view text);
+
+    bool IsMapped() const { return mapped_; }
+    bool IsPartial() const { return partial_; }
+    std::uint64_t SourceHash() const;
+    std::span<const std::byte> Image() const { return {data_.get(), size_}; }
+
+    CatalogList<CpuProfileView> CpuProfiles() const;
+    CatalogList<GpuProfileView> GpuProfiles() const;
+    // Automata over all matchTokens and the index over all cpuIds/pciIds,
+    // built once per load; their values are indices into
+    // CpuProfiles()/GpuProfiles(). Malformed IDs are left out of the index.
+    const TokenMatcher& CpuMatcher() const;
+    const TokenMatcher& GpuMatcher() const;
+    const HardwareIdIndex& IdIndex() const;
+    // Catalog-wide performance index, built on first use (thread-safe) and
+    // shared by copies.
+    const PerformanceIndex& Performance() const;
+    CpuTargetView CpuTarget(CpuTargetHandle handle) const { return {this, handle.index}; }
+    GpuTargetView GpuTarget(GpuTargetHandle handle) const { return {this, handle.index}; }
+    ProfileDatabase ToDatabase() const;
+    // Profile-level diff keyed by id; with duplicate ids the first wins,
+    // as it does for matching.
+    static CatalogDiff Diff(const ProfileCatalog& before, const ProfileCatalog& after);
+
+    const catalog_image::Header& ImageHeader() const {
+        return *reinterpret_cast<const catalog_image::Header*>(data_.get());
+    }
+    // Element `index` of a record table or target column.
+    template <typename T>
+    const T& At(const catalog_image::Section& section, std::uint32_t index) const {
+        return reinterpret_cast<const T*>(data_.get() + section.offset)[index];
+    }
+    std::string_view String(catalog_image::StringRef ref) const;
+    std::string_view ListString(std::uint32_t index) const;
+
+private:
+    struct Matchers {
+        TokenMatcher cpu;
+        TokenMatcher gpu;
+        HardwareIdIndex ids;
+    };
+    struct LazyPerformance;
+
+    ProfileCatalog(std::shared_ptr<const std::byte> data, size_t size, bool mapped);
+
+    std::shared_ptr<const std::byte> data_;
+    std::shared_ptr<const Matchers> matchers_;
+    std::shared_ptr<LazyPerformance> performance_;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    bool partial_ = false;
+};
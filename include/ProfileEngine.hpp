@@ -1,29 +1,121 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "HardwareInfo.hpp"
+#include "ProfileCatalog.hpp"
 #include "ProfileLoader.hpp"
 
+// Target options for many snapshots resolved against one catalog, stored
+// flat: snapshot i's options are CpuOptions(i) and, per GPU adapter a,
+// GpuOptions(i, a), in the order Refresh would list them.
+class FleetOptions {
+public:
+    size_t size() const { return cpuStart_.empty() ? 0 : cpuStart_.size() - 1; }
+    std::span<const CpuTargetHandle> CpuOptions(size_t snapshot) const {
+        return std::span(cpuOptions_).subspan(cpuStart_[snapshot], cpuStart_[snapshot + 1] - cpuStart_[snapshot]);
+    }
+    size_t GpuAdapterCount(size_t snapshot) const { return adapterStart_[snapshot + 1] - adapterStart_[snapshot]; }
+    std::span<const GpuTargetHandle> GpuOptions(size_t snapshot, size_t adapter) const {
+        const size_t slot = adapterStart_[snapshot] + adapter;
+        return std::span(gpuOptions_).subspan(gpuStart_[slot], gpuStart_[slot + 1] - gpuStart_[slot]);
+    }
+
+private:
+    friend class ProfileEngine;
+
+    std::vector<size_t> cpuStart_;      // size() + 1 offsets into cpuOptions_
+    std::vector<size_t> adapterStart_;  // size() + 1 offsets into gpuStart_
+    std::vector<size_t> gpuStart_;      // adapters + 1 offsets into gpuOptions_
+    std::vector<CpuTargetHandle> cpuOptions_;
+    std::vector<GpuTargetHandle> gpuOptions_;
+};
+
+// Ids of the profiles a Refresh matched, in catalog order; with the same
+// catalog they determine the options without matching again.
+struct MatchedProfiles {
+    std::vector<std::string> cpu;
+    std::vector<std::vector<std::string>> gpus;  // per adapter
+
+    bool operator==(const MatchedProfiles&) const = default;
+};
+
 class ProfileEngine {
 public:
     ProfileEngine() = default;
 
-    void Refresh(const HardwareSnapshot& snapshot, const ProfileDatabase& database);
+    void Refresh(const HardwareSnapshot& snapshot, const ProfileCatalog& catalog);
+    // Stateless batch form of Refresh for inventory dumps: resolves every
+    // snapshot against the catalog's prebuilt matchers on up to
+    // `workerThreads` threads (0 = one per core).
+    static FleetOptions MatchFleet(std::span<const HardwareSnapshot> snapshots, const ProfileCatalog& catalog,
+                                   unsigned workerThreads = 0);
+    // Whether moving to `next` can change the options: a matched profile
+    // was edited or removed, or an added/edited profile now matches.
+    bool IsAffectedBy(const CatalogDiff& diff, const HardwareSnapshot& snapshot, const ProfileCatalog& next) const;
+    // Re-resolves the current options against `next` by profile id without
+    // re-matching. Returns false, leaving the options as they were, if a
+    // matched profile is missing there or the matched profiles moved
+    // relative to each other; the caller then needs a Refresh.
+    bool Rebind(const ProfileCatalog& next);
+    MatchedProfiles Matched() const;
+    // Rebuilds the state a Refresh against `catalog` left behind from its
+    // Matched() ids, e.g. ones cached from an earlier run. Returns false,
+    // leaving the engine unchanged, when an id is missing or out of order.
+    bool Restore(const MatchedProfiles& matched, const ProfileCatalog& catalog);
+    // Hotplug updates, indexed as in GpuChange: match just the new adapter
+    // and insert its options at `adapter`, or drop adapter `adapter`. The
+    // other adapters keep their options, as a Refresh would leave them.
+    void AddGpuAdapter(size_t adapter, const GpuInfo& gpu, const ProfileCatalog& catalog);
+    void RemoveGpuAdapter(size_t adapter);
 
-    const std::vector<CpuThrottleTarget>& CpuOptions() const { return cpuOptions_; }
-    const std::vector<GpuThrottleTarget>& GpuOptions() const { return gpuOptions_; }
+    // Handles into the catalog passed to the last Refresh. GPU results are
+    // per adapter, indexed like the snapshot's `gpus`.
+    std::span<const CpuTargetHandle> CpuOptions() const { return cpuOptions_; }
     int CpuNominalFrequencyMHz() const { return cpuNominalFrequencyMHz_; }
-    int GpuNominalFrequencyMHz() const { return gpuNominalFrequencyMHz_; }
-    int GpuNominalPowerWatts() const { return gpuNominalPowerWatts_; }
+    size_t GpuAdapterCount() const { return gpuAdapters_.size(); }
+    std::span<const GpuTargetHandle> GpuOptions(size_t adapter) const { return gpuAdapters_[adapter].options; }
+    int GpuNominalFrequencyMHz(size_t adapter) const { return gpuAdapters_[adapter].nominalFrequencyMHz; }
+    int GpuNominalPowerWatts(size_t adapter) const { return gpuAdapters_[adapter].nominalPowerWatts; }
+
+    // Catalog SKUs to mimic beyond the listed tiers: every profile the
+    // catalog's PerformanceIndex ranks below the matched one (the first,
+    // if several matched) within its linked group, fastest first, minus
+    // those a listed tier already mimics. Values are indices into
+    // CpuProfiles()/GpuProfiles() of the catalog the options refer to,
+    // which must be passed here.
+    std::vector<std::uint32_t> CpuCandidates(const ProfileCatalog& catalog) const;
+    std::vector<std::uint32_t> GpuCandidates(size_t adapter, const ProfileCatalog& catalog) const;
+    // Synthesizes a target that makes the matched device perform like
+    // candidate `profile`, scaled by the two profiles' index scores; cheap
+    // enough to run per selection. Nullopt when nothing matched.
+    std::optional<CpuThrottleTarget> SynthesizeCpuTarget(std::uint32_t profile, const ProfileCatalog& catalog) const;
+    std::optional<GpuThrottleTarget> SynthesizeGpuTarget(size_t adapter, std::uint32_t profile,
+                                                         const ProfileCatalog& catalog) const;
+
+    // Token-by-token scan that matching used before the catalog automata;
+    // kept as the reference fleetbench checks the automata against.
+    static bool MatchesTokens(const std::string& haystack, const StringListView& tokens);
 
 private:
-    static bool MatchesTokens(const std::string& haystack, const std::vector<std::string>& tokens);
+    struct GpuAdapterMatch {
+        std::vector<GpuTargetHandle> options;
+        std::vector<std::string> profileIds;  // matched profiles, in catalog order
+        std::optional<std::uint32_t> reference;  // first matched profile's index
+        int nominalFrequencyMHz = 0;
+        int nominalPowerWatts = 0;
+    };
+
+    static GpuAdapterMatch MatchGpuAdapter(const GpuMatchKeys& keys, const ProfileCatalog& catalog);
 
-    std::vector<CpuThrottleTarget> cpuOptions_;
-    std::vector<GpuThrottleTarget> gpuOptions_;
+    std::vector<CpuTargetHandle> cpuOptions_;
+    std::vector<std::string> cpuProfileIds_;  // matched profiles, in catalog order
+    std::optional<std::uint32_t> cpuReference_;  // first matched profile's index
     int cpuNominalFrequencyMHz_ = 0;
-    int gpuNominalFrequencyMHz_ = 0;
-    int gpuNominalPowerWatts_ = 0;
+    std::vector<GpuAdapterMatch> gpuAdapters_;
 };
@@ -3,10 +3,11 @@
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "HardwareInfo.hpp"
-#include "SimpleJson.hpp"
+#include "HardwareKeys.hpp"
 
 struct CpuThrottleTarget {
     std::string id;
@@ -23,6 +24,7 @@ struct CpuProfile {
     std::string id;
     std::string label;
     std::vector<std::string> matchTokens;
+    std::vector<std::string> cpuIds;  // CpuIdKey::Parse format; exact match
     std::vector<CpuThrottleTarget> targets;
     int nominalFrequencyMHz = 0;
 };
@@ -40,6 +42,7 @@ struct GpuProfile {
     std::string id;
     std::string label;
     std::vector<std::string> matchTokens;
+    std::vector<std::string> pciIds;  // PciIdKey::Parse format; exact match
     std::vector<GpuThrottleTarget> targets;
     int nominalFrequencyMHz = 0;
     int nominalPowerWatts = 0;
@@ -50,12 +53,56 @@ struct ProfileDatabase {
     std::vector<GpuProfile> gpuProfiles;
 };
 
+// One GPU adapter's keys; `name` is lower-cased like HardwareMatchKeys::cpu.
+struct GpuMatchKeys {
+    static GpuMatchKeys FromInfo(const GpuInfo& info);
+
+    std::string name;
+    std::optional<PciIdKey> id;
+};
+
+// What profiles are matched against: lower-cased device names for
+// `matchTokens` and the structured IDs for `cpuIds`/`pciIds`.
+struct HardwareMatchKeys {
+    explicit HardwareMatchKeys(const HardwareSnapshot& snapshot);
+
+    // Case-insensitive substring test against a lower-cased key; an empty
+    // token never matches.
+    static bool ContainsToken(std::string_view key, std::string_view token);
+
+    std::string cpu;
+    std::optional<CpuIdKey> cpuId;
+    std::vector<GpuMatchKeys> gpus;  // one per adapter, in snapshot order
+};
+
+class ProfileCatalog;
+
 class ProfileLoader {
 public:
+    // Maps the compiled `profiles.bin` next to `path` when its embedded
+    // source hash matches the JSON; otherwise parses the JSON and compiles
+    // it in memory. A lone binary is used as-is.
+    ProfileCatalog LoadCatalog(const std::filesystem::path& path) const;
+    // As above, but a JSON fallback only decodes the profiles matching
+    // `snapshot` and yields a partial catalog. The mapped image is already
+    // lazy, so a fresh binary is still returned whole.
+    ProfileCatalog LoadCatalog(const std::filesystem::path& path, const HardwareSnapshot& snapshot) const;
     ProfileDatabase LoadFromFile(const std::filesystem::path& path) const;
+    // Single pass over the catalog text; values are bound straight into the
+    // profile structs without building a DOM. Large catalogs are split at
+    // profile boundaries and parsed on worker threads; the result (and any
+    // parse error) is identical to the serial pass.
+    ProfileDatabase LoadFromText(std::string_view text) const;
+    // Keeps only the profiles a ProfileEngine would match for `snapshot`.
+    // Other profile objects are skipped unparsed, and targets are decoded
+    // for matches only.
+    ProfileDatabase LoadMatching(std::string_view text, const HardwareSnapshot& snapshot) const;
+
+    // 0 (the default) uses one worker per hardware thread, and only for
+    // catalogs above a size threshold; 1 forces the serial pass; N > 1
+    // always splits across N workers.
+    void SetWorkerThreads(unsigned count) { workerThreads_ = count; }
 
 private:
-    CpuProfile ParseCpuProfile(const jsonlite::Value& value) const;
-    GpuProfile ParseGpuProfile(const jsonlite::Value& value) const;
-    std::vector<std::string> ParseStringArray(const jsonlite::Value& value) const;
+    unsigned workerThreads_ = 0;
 };
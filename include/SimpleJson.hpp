@@ -1,17 +1,43 @@
 #pragma once
 
-#include <cctype>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
-#include <map>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define JSONLITE_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define JSONLITE_X86_SIMD 0
+#endif
+
+#if JSONLITE_X86_SIMD && (defined(__GNUC__) || defined(__clang__))
+#define JSONLITE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define JSONLITE_TARGET_AVX2
+#endif
+
 namespace jsonlite {
 
-enum class Type {
+enum class Type : std::uint8_t {
     Null,
     Bool,
     Number,
@@ -20,49 +46,211 @@ enum class Type {
     Array
 };
 
-struct Value {
-    Type type = Type::Null;
-    double number = 0.0;
-    bool boolean = false;
-    std::string string;
-    std::map<std::string, Value> object;
-    std::vector<Value> array;
+// Bump allocator backing every node of a parsed Document. Blocks are never
+// freed individually; the whole arena goes away with its Document.
+class Arena {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
 
-    bool IsNull() const { return type == Type::Null; }
-    bool IsBool() const { return type == Type::Bool; }
-    bool IsNumber() const { return type == Type::Number; }
-    bool IsString() const { return type == Type::String; }
-    bool IsObject() const { return type == Type::Object; }
-    bool IsArray() const { return type == Type::Array; }
+    explicit Arena(size_t blockSize = kDefaultBlockSize) : blockSize_(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
 
-    const Value& operator[](const std::string& key) const {
-        static Value nullValue;
-        auto it = object.find(key);
-        if (it == object.end()) {
-            return nullValue;
+    void* Allocate(size_t bytes, size_t alignment) {
+        auto address = reinterpret_cast<std::uintptr_t>(cursor_);
+        size_t padding = (alignment - (address % alignment)) % alignment;
+        if (cursor_ == nullptr || padding + bytes > remaining_) {
+            AddBlock(bytes + alignment);
+            address = reinterpret_cast<std::uintptr_t>(cursor_);
+            padding = (alignment - (address % alignment)) % alignment;
         }
-        return it->second;
+        std::byte* result = cursor_ + padding;
+        cursor_ = result + bytes;
+        remaining_ -= padding + bytes;
+        return result;
+    }
+
+    template <typename T>
+    T* AllocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena never runs destructors");
+        if (count == 0) {
+            return nullptr;
+        }
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    std::string_view CopyString(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        char* data = AllocateArray<char>(text.size());
+        std::memcpy(data, text.data(), text.size());
+        return {data, text.size()};
+    }
+
+    size_t BytesReserved() const { return reserved_; }
+
+private:
+    void AddBlock(size_t minimumBytes) {
+        const size_t size = std::max(blockSize_, minimumBytes);
+        blocks_.push_back(std::make_unique<std::byte[]>(size));
+        cursor_ = blocks_.back().get();
+        remaining_ = size;
+        reserved_ += size;
+    }
+
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    std::byte* cursor_ = nullptr;
+    size_t remaining_ = 0;
+    size_t blockSize_ = kDefaultBlockSize;
+    size_t reserved_ = 0;
+};
+
+struct Member;
+
+// Compact tagged node (16 bytes). Strings are slices of the parsed source
+// where possible, otherwise arena copies; arrays and objects point at
+// contiguous arena spans, with object members sorted by key.
+class Value {
+public:
+    Value() = default;
+
+    static Value MakeBool(bool value) {
+        Value v;
+        v.type_ = Type::Bool;
+        v.boolean_ = value;
+        return v;
     }
 
+    static Value MakeNumber(double value) {
+        Value v;
+        v.type_ = Type::Number;
+        v.number_ = value;
+        return v;
+    }
+
+    static Value MakeString(std::string_view value) {
+        Value v;
+        v.type_ = Type::String;
+        v.chars_ = value.data();
+        v.size_ = static_cast<std::uint32_t>(value.size());
+        return v;
+    }
+
+    static Value MakeArray(const Value* items, size_t count) {
+        Value v;
+        v.type_ = Type::Array;
+        v.items_ = items;
+        v.size_ = static_cast<std::uint32_t>(count);
+        return v;
+    }
+
+    static Value MakeObject(const Member* members, size_t count) {
+        Value v;
+        v.type_ = Type::Object;
+        v.members_ = members;
+        v.size_ = static_cast<std::uint32_t>(count);
+        return v;
+    }
+
+    Type GetType() const { return type_; }
+    bool IsNull() const { return type_ == Type::Null; }
+    bool IsBool() const { return type_ == Type::Bool; }
+    bool IsNumber() const { return type_ == Type::Number; }
+    bool IsString() const { return type_ == Type::String; }
+    bool IsObject() const { return type_ == Type::Object; }
+    bool IsArray() const { return type_ == Type::Array; }
+
+    // Element count for arrays/objects, byte length for strings.
+    size_t Size() const { return size_; }
+
+    std::span<const Value> Items() const {
+        return IsArray() ? std::span<const Value>(items_, size_) : std::span<const Value>();
+    }
+
+    std::span<const Member> Members() const;
+
+    const Value& operator[](std::string_view key) const;
+
     const Value& operator[](size_t index) const {
-        static Value nullValue;
-        if (index >= array.size()) {
-            return nullValue;
+        if (!IsArray() || index >= size_) {
+            return Null();
         }
-        return array[index];
+        return items_[index];
     }
 
-    std::string GetString(const std::string& fallback = {}) const {
-        return IsString() ? string : fallback;
+    std::string_view GetString(std::string_view fallback = {}) const {
+        return IsString() ? std::string_view(chars_, size_) : fallback;
     }
 
     double GetNumber(double fallback = 0.0) const {
-        return IsNumber() ? number : fallback;
+        return IsNumber() ? number_ : fallback;
     }
 
     bool GetBool(bool fallback = false) const {
-        return IsBool() ? boolean : fallback;
+        return IsBool() ? boolean_ : fallback;
     }
+
+private:
+    static const Value& Null() {
+        static const Value nullValue;
+        return nullValue;
+    }
+
+    Type type_ = Type::Null;
+    std::uint32_t size_ = 0;
+    union {
+        double number_ = 0.0;
+        bool boolean_;
+        const char* chars_;
+        const Value* items_;
+        const Member* members_;
+    };
+};
+
+struct Member {
+    std::string_view key;
+    Value value;
+};
+
+inline std::span<const Member> Value::Members() const {
+    return IsObject() ? std::span<const Member>(members_, size_) : std::span<const Member>();
+}
+
+inline const Value& Value::operator[](std::string_view key) const {
+    if (!IsObject()) {
+        return Null();
+    }
+    const Member* end = members_ + size_;
+    const Member* it = std::lower_bound(members_, end, key, [](const Member& member, std::string_view k) {
+        return member.key < k;
+    });
+    if (it == end || it->key != key) {
+        return Null();
+    }
+    return it->value;
+}
+
+// Owns the arena behind a parsed tree. Unescaped strings and keys are views
+// into the parsed text, so a Document must not outlive the buffer it was
+// parsed from.
+class Document {
+public:
+    Document() = default;
+    Document(Document&&) noexcept = default;
+    Document& operator=(Document&&) noexcept = default;
+
+    const Value& Root() const { return root_; }
+    const Value& operator[](std::string_view key) const { return root_[key]; }
+    size_t ArenaBytes() const { return arena_.BytesReserved(); }
+
+private:
+    friend class Parser;
+
+    Arena arena_;
+    Value root_;
 };
 
 class ParseError : public std::runtime_error {
@@ -70,21 +258,518 @@ public:
     explicit ParseError(const std::string& message) : std::runtime_error(message) {}
 };
 
-class Parser {
+// Instruction sets the Reader's byte scanners can use. The best supported
+// one is picked at first use; SetScanBackend can force another, e.g. to
+// compare the vector paths against the scalar reference.
+enum class ScanBackend : std::uint8_t {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+namespace detail {
+
+// Matches std::isspace in the "C" locale.
+inline bool IsSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool IsStructural(char c) {
+    return c == '"' || c == '{' || c == '}' || c == '[' || c == ']';
+}
+
+// Each scanner returns the index of the first byte at or after `pos` that
+// stops the scan, or `size` when none does. `skipBalanced` starts just
+// inside an open container and returns the index past its closing
+// bracket, or kUnbalanced when the input ends first.
+struct ScanKernels {
+    size_t (*skipWhitespace)(const char* data, size_t pos, size_t size);
+    size_t (*findQuoteOrEscape)(const char* data, size_t pos, size_t size);
+    size_t (*findStructural)(const char* data, size_t pos, size_t size);
+    size_t (*skipBalanced)(const char* data, size_t pos, size_t size);
+};
+
+inline constexpr size_t kUnbalanced = static_cast<size_t>(-1);
+
+// Carried across blocks by the balanced skip; `inString` is all-ones
+// inside a string so it can be xor-ed into a block mask.
+struct BalanceState {
+    size_t depth = 1;
+    std::uint64_t inString = 0;
+    bool escaped = false;
+};
+
+inline size_t WalkBalancedBytes(const char* data, size_t pos, size_t end, BalanceState& state) {
+    for (; pos < end; ++pos) {
+        const char c = data[pos];
+        if (state.inString) {
+            if (state.escaped) {
+                state.escaped = false;
+            } else if (c == '\\') {
+                state.escaped = true;
+            } else if (c == '"') {
+                state.inString = 0;
+            }
+        } else if (c == '"') {
+            state.inString = ~std::uint64_t{0};
+        } else if (c == '{' || c == '[') {
+            ++state.depth;
+        } else if ((c == '}' || c == ']') && --state.depth == 0) {
+            return pos + 1;
+        }
+    }
+    return kUnbalanced;
+}
+
+inline size_t SkipBalancedScalar(const char* data, size_t pos, size_t size) {
+    BalanceState state;
+    return WalkBalancedBytes(data, pos, size, state);
+}
+
+// One 64-byte block without backslashes: a prefix xor over the quote bits
+// marks string interiors, which hides their brackets; the depth is then
+// walked over the remaining bracket bits only when it can reach zero.
+// Returns the block offset past the closing bracket, or 0 if not reached.
+inline unsigned WalkBalancedBlock(std::uint64_t quote, std::uint64_t open, std::uint64_t close, BalanceState& state) {
+    std::uint64_t inside = quote;
+    inside ^= inside << 1;
+    inside ^= inside << 2;
+    inside ^= inside << 4;
+    inside ^= inside << 8;
+    inside ^= inside << 16;
+    inside ^= inside << 32;
+    inside ^= state.inString;
+    state.inString = (inside >> 63) ? ~std::uint64_t{0} : 0;
+    open &= ~inside;
+    close &= ~inside;
+    const auto closes = static_cast<size_t>(std::popcount(close));
+    if (closes < state.depth) {
+        state.depth = state.depth - closes + static_cast<size_t>(std::popcount(open));
+        return 0;
+    }
+    for (std::uint64_t bits = open | close; bits != 0; bits &= bits - 1) {
+        const int index = std::countr_zero(bits);
+        if ((open >> index) & 1) {
+            ++state.depth;
+        } else if (--state.depth == 0) {
+            return static_cast<unsigned>(index) + 1;
+        }
+    }
+    return 0;
+}
+
+inline size_t SkipWhitespaceScalar(const char* data, size_t pos, size_t size) {
+    while (pos < size && IsSpace(data[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+inline size_t FindQuoteOrEscapeScalar(const char* data, size_t pos, size_t size) {
+    while (pos < size && data[pos] != '"' && data[pos] != '\\') {
+        ++pos;
+    }
+    return pos;
+}
+
+inline size_t FindStructuralScalar(const char* data, size_t pos, size_t size) {
+    while (pos < size && !IsStructural(data[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+inline constexpr ScanKernels kScalarKernels{SkipWhitespaceScalar, FindQuoteOrEscapeScalar, FindStructuralScalar,
+                                            SkipBalancedScalar};
+
+#if JSONLITE_X86_SIMD
+
+// Whitespace is ' ' or 0x09..0x0D; the range test is an unsigned
+// min-compare on (c - '\t').
+inline __m128i SpaceMaskSse2(__m128i chunk) {
+    const __m128i offset = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+    const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(4)), offset);
+    return _mm_or_si128(control, _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')));
+}
+
+inline size_t SkipWhitespaceSse2(const char* data, size_t pos, size_t size) {
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const unsigned stop = ~static_cast<unsigned>(_mm_movemask_epi8(SpaceMaskSse2(chunk))) & 0xFFFFu;
+        if (stop != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(stop));
+        }
+    }
+    return SkipWhitespaceScalar(data, pos, size);
+}
+
+inline size_t FindQuoteOrEscapeSse2(const char* data, size_t pos, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+    return FindQuoteOrEscapeScalar(data, pos, size);
+}
+
+inline size_t FindStructuralSse2(const char* data, size_t pos, size_t size) {
+    // '[' and ']' differ from '{' and '}' only in bit 5, so setting it
+    // folds four compares into two; no other byte folds onto a brace.
+    const __m128i foldBit = _mm_set1_epi8(0x20);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const __m128i folded = _mm_or_si128(chunk, foldBit);
+        const __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                          _mm_or_si128(_mm_cmpeq_epi8(folded, open),
+                                                       _mm_cmpeq_epi8(folded, close)));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+    return FindStructuralScalar(data, pos, size);
+}
+
+struct BlockMasks {
+    std::uint64_t quote = 0;
+    std::uint64_t backslash = 0;
+    std::uint64_t open = 0;
+    std::uint64_t close = 0;
+};
+
+inline BlockMasks ClassifyBlockSse2(const char* data) {
+    BlockMasks masks;
+    for (int lane = 0; lane < 4; ++lane) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + lane * 16));
+        const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+        auto bits = [lane](__m128i hits) {
+            return static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(hits))) << (lane * 16);
+        };
+        masks.quote |= bits(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')));
+        masks.backslash |= bits(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+        masks.open |= bits(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')));
+        masks.close |= bits(_mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+    }
+    return masks;
+}
+
+// Blocks holding a backslash (or starting mid-escape) take the byte walk,
+// which tracks escapes exactly; catalogs rarely contain any.
+inline size_t SkipBalancedSse2(const char* data, size_t pos, size_t size) {
+    BalanceState state;
+    for (; pos + 64 <= size; pos += 64) {
+        const BlockMasks masks = ClassifyBlockSse2(data + pos);
+        if (masks.backslash != 0 || state.escaped) {
+            const size_t end = WalkBalancedBytes(data, pos, pos + 64, state);
+            if (end != kUnbalanced) {
+                return end;
+            }
+            continue;
+        }
+        const unsigned end = WalkBalancedBlock(masks.quote, masks.open, masks.close, state);
+        if (end != 0) {
+            return pos + end;
+        }
+    }
+    return WalkBalancedBytes(data, pos, size, state);
+}
+
+JSONLITE_TARGET_AVX2 inline size_t SkipWhitespaceAvx2(const char* data, size_t pos, size_t size) {
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    const __m256i space = _mm256_set1_epi8(' ');
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const __m256i offset = _mm256_sub_epi8(chunk, tab);
+        const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, four), offset);
+        const __m256i spaces = _mm256_or_si256(control, _mm256_cmpeq_epi8(chunk, space));
+        const std::uint32_t stop = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(spaces));
+        if (stop != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(stop));
+        }
+    }
+    return SkipWhitespaceSse2(data, pos, size);
+}
+
+JSONLITE_TARGET_AVX2 inline size_t FindQuoteOrEscapeAvx2(const char* data, size_t pos, size_t size) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+        const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+    return FindQuoteOrEscapeSse2(data, pos, size);
+}
+
+JSONLITE_TARGET_AVX2 inline size_t FindStructuralAvx2(const char* data, size_t pos, size_t size) {
+    const __m256i foldBit = _mm256_set1_epi8(0x20);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const __m256i folded = _mm256_or_si256(chunk, foldBit);
+        const __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                                             _mm256_or_si256(_mm256_cmpeq_epi8(folded, open),
+                                                             _mm256_cmpeq_epi8(folded, close)));
+        const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+        if (mask != 0) {
+            return pos + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+    return FindStructuralSse2(data, pos, size);
+}
+
+JSONLITE_TARGET_AVX2 inline BlockMasks ClassifyBlockAvx2(const char* data) {
+    BlockMasks masks;
+    for (int lane = 0; lane < 2; ++lane) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + lane * 32));
+        const __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+        auto bits = [lane](__m256i hits) JSONLITE_TARGET_AVX2 {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(hits))) << (lane * 32);
+        };
+        masks.quote |= bits(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')));
+        masks.backslash |= bits(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+        masks.open |= bits(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')));
+        masks.close |= bits(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}')));
+    }
+    return masks;
+}
+
+JSONLITE_TARGET_AVX2 inline size_t SkipBalancedAvx2(const char* data, size_t pos, size_t size) {
+    BalanceState state;
+    for (; pos + 64 <= size; pos += 64) {
+        const BlockMasks masks = ClassifyBlockAvx2(data + pos);
+        if (masks.backslash != 0 || state.escaped) {
+            const size_t end = WalkBalancedBytes(data, pos, pos + 64, state);
+            if (end != kUnbalanced) {
+                return end;
+            }
+            continue;
+        }
+        const unsigned end = WalkBalancedBlock(masks.quote, masks.open, masks.close, state);
+        if (end != 0) {
+            return pos + end;
+        }
+    }
+    return WalkBalancedBytes(data, pos, size, state);
+}
+
+inline constexpr ScanKernels kSse2Kernels{SkipWhitespaceSse2, FindQuoteOrEscapeSse2, FindStructuralSse2,
+                                          SkipBalancedSse2};
+inline constexpr ScanKernels kAvx2Kernels{SkipWhitespaceAvx2, FindQuoteOrEscapeAvx2, FindStructuralAvx2,
+                                          SkipBalancedAvx2};
+
+inline bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // JSONLITE_X86_SIMD
+
+inline ScanBackend BestScanBackend() {
+#if JSONLITE_X86_SIMD
+    return CpuHasAvx2() ? ScanBackend::Avx2 : ScanBackend::Sse2;
+#else
+    return ScanBackend::Scalar;
+#endif
+}
+
+inline std::atomic<ScanBackend>& ScanBackendSlot() {
+    static std::atomic<ScanBackend> backend{BestScanBackend()};
+    return backend;
+}
+
+inline const ScanKernels& KernelsFor(ScanBackend backend) {
+    switch (backend) {
+#if JSONLITE_X86_SIMD
+        case ScanBackend::Avx2:
+            return kAvx2Kernels;
+        case ScanBackend::Sse2:
+            return kSse2Kernels;
+#endif
+        default:
+            return kScalarKernels;
+    }
+}
+
+}  // namespace detail
+
+inline ScanBackend ActiveScanBackend() {
+    return detail::ScanBackendSlot().load(std::memory_order_relaxed);
+}
+
+// Affects Readers constructed afterwards. Requests above what the CPU
+// supports are clamped to the best available backend.
+inline void SetScanBackend(ScanBackend backend) {
+    const ScanBackend best = detail::BestScanBackend();
+    if (static_cast<std::uint8_t>(backend) > static_cast<std::uint8_t>(best)) {
+        backend = best;
+    }
+    detail::ScanBackendSlot().store(backend, std::memory_order_relaxed);
+}
+
+enum class Event : std::uint8_t {
+    StartObject,
+    EndObject,
+    StartArray,
+    EndArray,
+    Key,
+    String,
+    Number,
+    Bool,
+    Null,
+    End
+};
+
+// Pull-style event reader: every Next() yields one token of the document
+// and validates the grammar as it goes. Key/String text is a slice of the
+// source when unescaped (TextIsSlice()), otherwise it lives in a scratch
+// buffer that the following Next() overwrites. Nothing else is allocated.
+class Reader {
 public:
-    explicit Parser(std::string_view input) : source_(input) {}
+    explicit Reader(std::string_view input)
+        : source_(input), kernels_(&detail::KernelsFor(ActiveScanBackend())) {}
 
-    Value Parse() {
-        SkipWhitespace();
-        auto value = ParseValue();
+    Event Next() {
+        while (true) {
+            SkipWhitespace();
+            switch (state_) {
+                case State::Done:
+                    return Event::End;
+                case State::Separator: {
+                    if (containers_.empty()) {
+                        if (pos_ != source_.size()) {
+                            throw ParseError("Unexpected trailing characters in JSON");
+                        }
+                        state_ = State::Done;
+                        return Event::End;
+                    }
+                    const bool inObject = containers_.back() == Type::Object;
+                    if (Match(',')) {
+                        state_ = inObject ? State::Key : State::Value;
+                        continue;
+                    }
+                    if (Match(inObject ? '}' : ']')) {
+                        return Close();
+                    }
+                    throw ParseError(inObject ? "Expected ',' between object members"
+                                              : "Expected ',' between array elements");
+                }
+                case State::KeyOrEnd:
+                    if (Match('}')) {
+                        return Close();
+                    }
+                    [[fallthrough]];
+                case State::Key:
+                    if (Peek() != '"') {
+                        throw ParseError("Expected string key in JSON object");
+                    }
+                    ReadString();
+                    SkipWhitespace();
+                    if (!Match(':')) {
+                        throw ParseError("Expected ':' after object key");
+                    }
+                    state_ = State::Value;
+                    return Event::Key;
+                case State::ValueOrEnd:
+                    if (Match(']')) {
+                        return Close();
+                    }
+                    [[fallthrough]];
+                case State::Value:
+                    return ReadValue();
+            }
+        }
+    }
+
+    // Restarts on a new input, keeping the container stack and string
+    // scratch capacity, so one reader can walk many small documents.
+    void Reset(std::string_view input) {
+        source_ = input;
+        pos_ = 0;
+        state_ = State::Value;
+        containers_.clear();
+        text_ = {};
+        textIsSlice_ = false;
+    }
+
+    std::string_view Text() const { return text_; }
+    bool TextIsSlice() const { return textIsSlice_; }
+    double Number() const { return number_; }
+    bool Boolean() const { return boolean_; }
+    size_t Depth() const { return containers_.size(); }
+    size_t Offset() const { return pos_; }
+
+    // Skips the value that follows a Key without decoding it. Skipped
+    // containers are only checked for bracket and quote balance.
+    void SkipValue() {
+        if (state_ != State::Value) {
+            throw ParseError("SkipValue called outside a value position");
+        }
         SkipWhitespace();
-        if (pos_ != source_.size()) {
-            throw ParseError("Unexpected trailing characters in JSON");
+        const char c = Peek();
+        if (c == '{' || c == '[') {
+            ++pos_;
+            SkipBalanced();
+            state_ = State::Separator;
+        } else {
+            ReadValue();
         }
-        return value;
+    }
+
+    // Skips the remainder of the innermost open object or array, leaving
+    // the reader just past its closing bracket.
+    void SkipRest() {
+        if (containers_.empty()) {
+            throw ParseError("SkipRest called outside a container");
+        }
+        SkipBalanced();
+        containers_.pop_back();
+        state_ = State::Separator;
     }
 
 private:
+    enum class State : std::uint8_t {
+        Value,
+        ValueOrEnd,
+        Key,
+        KeyOrEnd,
+        Separator,
+        Done
+    };
+
     char Peek() const {
         return pos_ < source_.size() ? source_[pos_] : '\0';
     }
@@ -102,52 +787,54 @@ private:
     }
 
     void SkipWhitespace() {
-        while (pos_ < source_.size() && std::isspace(static_cast<unsigned char>(source_[pos_]))) {
-            ++pos_;
+        // Most gaps are a single separator byte; only longer runs (indents)
+        // go through the vector scanner.
+        if (pos_ < source_.size() && detail::IsSpace(source_[pos_])) {
+            pos_ = kernels_->skipWhitespace(source_.data(), pos_ + 1, source_.size());
         }
     }
 
-    Value ParseValue() {
-        SkipWhitespace();
-        char c = Peek();
+    Event Close() {
+        const Type closed = containers_.back();
+        containers_.pop_back();
+        state_ = State::Separator;
+        return closed == Type::Object ? Event::EndObject : Event::EndArray;
+    }
+
+    Event ReadValue() {
+        const char c = Peek();
         if (c == '\0') {
             throw ParseError("Unexpected end of JSON input");
         }
-        if (c == '"') {
-            Value v;
-            v.type = Type::String;
-            v.string = ParseString();
-            return v;
-        }
-        if (c == '{') {
-            return ParseObject();
+        if (c == '{' || c == '[') {
+            ++pos_;
+            const bool object = c == '{';
+            containers_.push_back(object ? Type::Object : Type::Array);
+            state_ = object ? State::KeyOrEnd : State::ValueOrEnd;
+            return object ? Event::StartObject : Event::StartArray;
         }
-        if (c == '[') {
-            return ParseArray();
+        state_ = State::Separator;
+        if (c == '"') {
+            ReadString();
+            return Event::String;
         }
-        if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
-            Value v;
-            v.type = Type::Number;
-            v.number = ParseNumber();
-            return v;
+        if (c == '-' || detail::IsDigit(c)) {
+            number_ = ReadNumber();
+            return Event::Number;
         }
         if (c == 't') {
             ExpectLiteral("true");
-            Value v;
-            v.type = Type::Bool;
-            v.boolean = true;
-            return v;
+            boolean_ = true;
+            return Event::Bool;
         }
         if (c == 'f') {
             ExpectLiteral("false");
-            Value v;
-            v.type = Type::Bool;
-            v.boolean = false;
-            return v;
+            boolean_ = false;
+            return Event::Bool;
         }
         if (c == 'n') {
             ExpectLiteral("null");
-            return Value{};
+            return Event::Null;
         }
         throw ParseError("Unrecognized value in JSON");
     }
@@ -160,104 +847,98 @@ private:
         }
     }
 
-    Value ParseObject() {
-        Value objectValue;
-        objectValue.type = Type::Object;
-        objectValue.object.clear();
-        Get(); // consume '{'
-        SkipWhitespace();
-        if (Match('}')) {
-            return objectValue;
+    // Scans forward until the bracket depth opened before the call drops
+    // back to zero, stepping over string literals.
+    void SkipBalanced() {
+        const size_t end = kernels_->skipBalanced(source_.data(), pos_, source_.size());
+        if (end != detail::kUnbalanced) {
+            pos_ = end;
+            return;
         }
+        // Unterminated: rescan structurally to report the precise error.
+        size_t depth = 1;
         while (true) {
-            SkipWhitespace();
-            if (Peek() != '"') {
-                throw ParseError("Expected string key in JSON object");
-            }
-            std::string key = ParseString();
-            SkipWhitespace();
-            if (!Match(':')) {
-                throw ParseError("Expected ':' after object key");
-            }
-            SkipWhitespace();
-            Value value = ParseValue();
-            objectValue.object.emplace(std::move(key), std::move(value));
-            SkipWhitespace();
-            if (Match('}')) {
-                break;
+            pos_ = kernels_->findStructural(source_.data(), pos_, source_.size());
+            if (pos_ >= source_.size()) {
+                throw ParseError("Unexpected end of JSON input");
             }
-            if (!Match(',')) {
-                throw ParseError("Expected ',' between object members");
+            const char c = source_[pos_++];
+            if (c == '"') {
+                SkipStringBody();
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (--depth == 0) {
+                return;
             }
         }
-        return objectValue;
     }
 
-    Value ParseArray() {
-        Value arrayValue;
-        arrayValue.type = Type::Array;
-        arrayValue.array.clear();
-        Get(); // consume '['
-        SkipWhitespace();
-        if (Match(']')) {
-            return arrayValue;
-        }
+    void SkipStringBody() {
         while (true) {
-            Value entry = ParseValue();
-            arrayValue.array.emplace_back(std::move(entry));
-            SkipWhitespace();
-            if (Match(']')) {
-                break;
+            pos_ = kernels_->findQuoteOrEscape(source_.data(), pos_, source_.size());
+            if (pos_ >= source_.size()) {
+                throw ParseError("Unterminated string literal");
             }
-            if (!Match(',')) {
-                throw ParseError("Expected ',' between array elements");
+            if (source_[pos_++] == '"') {
+                return;
             }
+            ++pos_;  // escaped character
         }
-        return arrayValue;
     }
 
-    std::string ParseString() {
+    void ReadString() {
         if (!Match('"')) {
             throw ParseError("Expected beginning of string");
         }
-        std::string result;
-        while (true) {
+        const size_t start = pos_;
+        pos_ = kernels_->findQuoteOrEscape(source_.data(), pos_, source_.size());
+        if (pos_ >= source_.size()) {
+            throw ParseError("Unterminated string literal");
+        }
+        if (source_[pos_] == '"') {
+            text_ = source_.substr(start, pos_ - start);
+            textIsSlice_ = true;
+            ++pos_;
+            return;
+        }
+
+        // Escaped: copy each unescaped run in bulk, decode escapes between.
+        scratch_.assign(source_.data() + start, pos_ - start);
+        while (source_[pos_] == '\\') {
+            ++pos_;
             if (pos_ >= source_.size()) {
-                throw ParseError("Unterminated string literal");
+                throw ParseError("Bad escape sequence in string");
             }
-            char c = Get();
-            if (c == '"') {
-                break;
-            }
-            if (c == '\\') {
-                if (pos_ >= source_.size()) {
-                    throw ParseError("Bad escape sequence in string");
+            char esc = Get();
+            switch (esc) {
+                case '"': scratch_.push_back('"'); break;
+                case '\\': scratch_.push_back('\\'); break;
+                case '/': scratch_.push_back('/'); break;
+                case 'b': scratch_.push_back('\b'); break;
+                case 'f': scratch_.push_back('\f'); break;
+                case 'n': scratch_.push_back('\n'); break;
+                case 'r': scratch_.push_back('\r'); break;
+                case 't': scratch_.push_back('\t'); break;
+                case 'u': {
+                    scratch_.push_back(ReadUnicodeEscape());
+                    break;
                 }
-                char esc = Get();
-                switch (esc) {
-                    case '"': result.push_back('"'); break;
-                    case '\\': result.push_back('\\'); break;
-                    case '/': result.push_back('/'); break;
-                    case 'b': result.push_back('\b'); break;
-                    case 'f': result.push_back('\f'); break;
-                    case 'n': result.push_back('\n'); break;
-                    case 'r': result.push_back('\r'); break;
-                    case 't': result.push_back('\t'); break;
-                    case 'u': {
-                        result.push_back(ParseUnicodeEscape());
-                        break;
-                    }
-                    default:
-                        throw ParseError("Invalid escape character in string");
-                }
-            } else {
-                result.push_back(c);
+                default:
+                    throw ParseError("Invalid escape character in string");
             }
+            const size_t run = pos_;
+            pos_ = kernels_->findQuoteOrEscape(source_.data(), pos_, source_.size());
+            if (pos_ >= source_.size()) {
+                throw ParseError("Unterminated string literal");
+            }
+            scratch_.append(source_.data() + run, pos_ - run);
         }
-        return result;
+        ++pos_;  // closing quote
+        text_ = scratch_;
+        textIsSlice_ = false;
     }
 
-    char ParseUnicodeEscape() {
+    char ReadUnicodeEscape() {
         if (pos_ + 4 > source_.size()) {
             throw ParseError("Invalid unicode escape");
         }
@@ -282,39 +963,161 @@ private:
         return '?';
     }
 
-    double ParseNumber() {
-        size_t start = pos_;
-        if (Match('-')) {}
-        while (std::isdigit(static_cast<unsigned char>(Peek()))) {
-            ++pos_;
-        }
+    // Locale-independent and allocation-free. Like the strtod-based path it
+    // replaces, a prefix such as "1e" yields the longest valid number.
+    double ReadNumber() {
+        const size_t start = pos_;
+        Match('-');
+        SkipDigits();
         if (Match('.')) {
-            while (std::isdigit(static_cast<unsigned char>(Peek()))) {
-                ++pos_;
-            }
+            SkipDigits();
         }
         if (Peek() == 'e' || Peek() == 'E') {
             ++pos_;
             if (Peek() == '+' || Peek() == '-') {
                 ++pos_;
             }
-            while (std::isdigit(static_cast<unsigned char>(Peek()))) {
-                ++pos_;
-            }
+            SkipDigits();
         }
-        auto numberStr = std::string(source_.substr(start, pos_ - start));
-        try {
-            return std::stod(numberStr);
-        } catch (const std::exception&) {
+        const char* first = source_.data() + start;
+        const char* last = source_.data() + pos_;
+        double value = 0.0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        const auto result = std::from_chars(first, last, value);
+        if (result.ec != std::errc()) {
             throw ParseError("Invalid numeric literal in JSON");
         }
+#else
+        // Toolchains without floating-point from_chars fall back to strtod.
+        const std::string literal(first, last);
+        char* end = nullptr;
+        errno = 0;
+        value = std::strtod(literal.c_str(), &end);
+        if (end == literal.c_str() || errno == ERANGE) {
+            throw ParseError("Invalid numeric literal in JSON");
+        }
+#endif
+        // std::stod rejected results that underflow into the subnormal range.
+        if (std::fpclassify(value) == FP_SUBNORMAL) {
+            throw ParseError("Invalid numeric literal in JSON");
+        }
+        return value;
+    }
+
+    void SkipDigits() {
+        while (pos_ < source_.size() && detail::IsDigit(source_[pos_])) {
+            ++pos_;
+        }
     }
 
     std::string_view source_;
+    const detail::ScanKernels* kernels_;
     size_t pos_ = 0;
+    State state_ = State::Value;
+    std::vector<Type> containers_;
+    std::string_view text_;
+    bool textIsSlice_ = false;
+    std::string scratch_;
+    double number_ = 0.0;
+    bool boolean_ = false;
+};
+
+// Builds an arena-backed Document from Reader events.
+class Parser {
+public:
+    explicit Parser(std::string_view input) : reader_(input), sourceSize_(input.size()) {}
+
+    Document Parse() {
+        Document document;
+        // Node storage stays well under the text size on typical catalogs.
+        document.arena_ = Arena(std::max<size_t>(Arena::kDefaultBlockSize, sourceSize_ / 2));
+        arena_ = &document.arena_;
+        document.root_ = BuildValue(reader_.Next());
+        reader_.Next();  // End; throws on trailing characters
+        arena_ = nullptr;
+        return document;
+    }
+
+private:
+    Value BuildValue(Event event) {
+        switch (event) {
+            case Event::StartObject:
+                return BuildObject();
+            case Event::StartArray:
+                return BuildArray();
+            case Event::String:
+                return Value::MakeString(StoreText());
+            case Event::Number:
+                return Value::MakeNumber(reader_.Number());
+            case Event::Bool:
+                return Value::MakeBool(reader_.Boolean());
+            case Event::Null:
+                return Value{};
+            default:
+                throw ParseError("Unexpected end of JSON input");
+        }
+    }
+
+    std::string_view StoreText() {
+        return reader_.TextIsSlice() ? reader_.Text() : arena_->CopyString(reader_.Text());
+    }
+
+    // Members are collected on a shared scratch stack and copied into the
+    // arena once the object closes, so nested objects never reallocate.
+    Value BuildObject() {
+        const size_t base = memberStack_.size();
+        for (Event event = reader_.Next(); event != Event::EndObject; event = reader_.Next()) {
+            std::string_view key = StoreText();
+            Value value = BuildValue(reader_.Next());
+            memberStack_.push_back(Member{key, value});
+        }
+        const size_t count = memberStack_.size() - base;
+        Member* members = arena_->AllocateArray<Member>(count);
+        std::copy(memberStack_.begin() + static_cast<std::ptrdiff_t>(base), memberStack_.end(), members);
+        memberStack_.resize(base);
+        SortMembers(members, count);
+        return Value::MakeObject(members, count);
+    }
+
+    // Stable so duplicate keys resolve to the first occurrence. Objects are
+    // small, so an in-place insertion sort avoids stable_sort's buffer.
+    static void SortMembers(Member* members, size_t count) {
+        auto byKey = [](const Member& lhs, const Member& rhs) { return lhs.key < rhs.key; };
+        if (count > 32) {
+            std::stable_sort(members, members + count, byKey);
+            return;
+        }
+        for (size_t i = 1; i < count; ++i) {
+            Member current = members[i];
+            size_t j = i;
+            while (j > 0 && byKey(current, members[j - 1])) {
+                members[j] = members[j - 1];
+                --j;
+            }
+            members[j] = current;
+        }
+    }
+
+    Value BuildArray() {
+        const size_t base = valueStack_.size();
+        for (Event event = reader_.Next(); event != Event::EndArray; event = reader_.Next()) {
+            valueStack_.push_back(BuildValue(event));
+        }
+        const size_t count = valueStack_.size() - base;
+        Value* items = arena_->AllocateArray<Value>(count);
+        std::copy(valueStack_.begin() + static_cast<std::ptrdiff_t>(base), valueStack_.end(), items);
+        valueStack_.resize(base);
+        return Value::MakeArray(items, count);
+    }
+
+    Reader reader_;
+    size_t sourceSize_ = 0;
+    Arena* arena_ = nullptr;
+    std::vector<Value> valueStack_;
+    std::vector<Member> memberStack_;
 };
 
-inline Value Parse(std::string_view text) {
+inline Document Parse(std::string_view text) {
     Parser parser(text);
     return parser.Parse();
 }
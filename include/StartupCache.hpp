@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <utility>
+
+#include "HardwareInfo.hpp"
+#include "ProfileEngine.hpp"
+
+// What a launch needs to skip hardware probing and matching: the probed
+// snapshot and the profiles it matched, valid while the hardware
+// fingerprint (HardwareInfoService::Fingerprint) and the catalog's source
+// hash are unchanged.
+struct StartupCacheEntry {
+    std::uint64_t hardwareFingerprint = 0;
+    std::uint64_t catalogHash = 0;
+    HardwareSnapshot snapshot;
+    MatchedProfiles matched;
+
+    bool operator==(const StartupCacheEntry&) const = default;
+};
+
+// Small versioned binary file; any read problem is treated as a miss.
+class StartupCache {
+public:
+    explicit StartupCache(std::filesystem::path path) : path_(std::move(path)) {}
+
+    // nullopt when the file is missing, truncated, or from another version.
+    std::optional<StartupCacheEntry> Load() const;
+    // Writes beside the file and renames, so a crash never leaves a torn
+    // cache. Returns false when the directory is not writable.
+    bool Save(const StartupCacheEntry& entry) const;
+    void Invalidate() const;
+
+private:
+    std::filesystem::path path_;
+};
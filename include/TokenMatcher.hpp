@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Aho-Corasick automaton over a fixed set of tokens, each tagged with a
+// value (a profile index in the catalog). Finding every token contained
+// in a text is one pass over the text, independent of the token count.
+// Matching is ASCII case-insensitive, like HardwareMatchKeys::ContainsToken.
+class TokenMatcher {
+public:
+    using Pattern = std::pair<std::string_view, std::uint32_t>;
+
+    TokenMatcher() = default;
+    // Empty tokens are ignored; they never match.
+    explicit TokenMatcher(std::span<const Pattern> patterns);
+
+    // Values of all tokens found in `text`, sorted and without duplicates.
+    std::vector<std::uint32_t> Match(std::string_view text) const;
+    // As above into `values` (cleared first), reusing its capacity.
+    void Match(std::string_view text, std::vector<std::uint32_t>& values) const;
+
+    size_t StateCount() const { return classCount_ == 0 ? 0 : transitions_.size() / classCount_; }
+
+private:
+    // Set on a transition whose target state has outputs, so the scan only
+    // touches the output table on a hit.
+    static constexpr std::uint32_t kHasOutput = 1u << 31;
+
+    // Bytes that occur in no token share class 0, which keeps each state's
+    // row as narrow as the tokens' alphabet.
+    std::array<std::uint8_t, 256> classes_{};
+    std::uint32_t classCount_ = 0;
+    std::vector<std::uint32_t> transitions_;  // state * classCount_ + class -> state | kHasOutput
+    std::vector<std::uint32_t> outputStart_;  // per state, plus an end sentinel
+    std::vector<std::uint32_t> outputs_;
+};
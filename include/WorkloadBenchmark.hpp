@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+
+#include "BenchmarkControl.hpp"
+#include "BenchmarkTypes.hpp"
+#include "HardwareInfo.hpp"
+
+// Kernel names in the workload suite's BenchmarkResultData::kernels, in
+// the order they run. Each KernelScore::gops is that workload's rate on
+// all threads, in billions of its own unit per second: bytes for the
+// compression, hashing and text kernels, keys for the sort, lookups for
+// the tree search and particle updates for the physics step.
+inline constexpr const char* kWorkloadKernels[] = {"lz-compress", "lz-decompress", "sha256",  "crc32c",
+                                                   "tree-search", "radix-sort",    "strings", "physics"};
+
+// Self-contained kernels standing in for the compiles, games and
+// compression jobs a throttled machine is used for: LZ77 compression and
+// decompression, SHA-256 and CRC-32C, lookups in an unbalanced binary
+// search tree, an LSD radix sort, word counting over text and a
+// mass-spring cloth step. Every input is generated from a fixed seed and
+// every pass's checksum is compared with the one the kernel must produce,
+// so a miscompiled or unstable build fails instead of scoring. Each
+// workload runs on all threads, one private working set per thread; the
+// headline score is a weighted geometric mean of the rates against a
+// reference machine's single thread (1000 points each).
+class WorkloadBenchmark {
+public:
+    // `repetitions` timed calls per workload, after one warmup call.
+    // Reports progress to `control` and stops (returning nothing) once it
+    // is cancelled; also returns nothing when a checksum is wrong.
+    std::optional<BenchmarkResultData> Run(const HardwareSnapshot& snapshot, int repetitions = 10,
+                                           BenchmarkControl* control = nullptr) const;
+};
@@ -0,0 +1,465 @@
+#include "BenchmarkHistory.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+
+#include "BinaryIo.hpp"
+
+namespace {
+
+constexpr char kMagic[8] = {'H', 'W', 'L', 'H', 'I', 'S', 'T', 'R'};
+constexpr std::uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = sizeof(kMagic) + sizeof(std::uint32_t);
+// Each record is its payload's size, the payload and its checksum.
+constexpr size_t kRecordOverhead = sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+std::string KeyIndex(const BenchmarkKey& key) {
+    std::string index = std::to_string(key.hardwareFingerprint);
+    for (const std::string* field : {&key.targetId, &key.kernel, &key.settings}) {
+        index += '\0';
+        index += *field;
+    }
+    return index;
+}
+
+std::string TargetIndex(std::uint64_t hardwareFingerprint, std::string_view targetId) {
+    std::string index = std::to_string(hardwareFingerprint);
+    index += '\0';
+    index += targetId;
+    return index;
+}
+
+void WriteKey(BinaryWriter& writer, const BenchmarkKey& key, std::int64_t timestamp) {
+    writer.U64(key.hardwareFingerprint);
+    writer.String(key.targetId);
+    writer.String(key.kernel);
+    writer.String(key.settings);
+    writer.I64(timestamp);
+}
+
+void WriteFloats(BinaryWriter& writer, const std::vector<double>& values) {
+    writer.U32(static_cast<std::uint32_t>(values.size()));
+    for (const double value : values) {
+        writer.F32(static_cast<float>(value));
+    }
+}
+
+std::vector<double> ReadFloats(BinaryReader& reader) {
+    std::vector<double> values(reader.Count(sizeof(float)));
+    for (double& value : values) {
+        value = reader.F32();
+    }
+    return values;
+}
+
+void WriteResult(BinaryWriter& writer, const BenchmarkResultData& result) {
+    writer.F64(result.score);
+    writer.String(result.unit);
+    writer.String(result.details);
+    const ScoreStats& stats = result.stats;
+    writer.U32(static_cast<std::uint32_t>(stats.samples));
+    writer.U32(static_cast<std::uint32_t>(stats.outliers));
+    for (const double value : {stats.median, stats.mad, stats.ciLow, stats.ciHigh}) {
+        writer.F64(value);
+    }
+    WriteFloats(writer, result.samples);
+    writer.U32(static_cast<std::uint32_t>(result.kernels.size()));
+    for (const KernelScore& kernel : result.kernels) {
+        writer.String(kernel.kernel);
+        writer.String(kernel.isa);
+        writer.F32(static_cast<float>(kernel.gops));
+    }
+    writer.U32(static_cast<std::uint32_t>(result.cores.size()));
+    for (const CoreScore& core : result.cores) {
+        writer.U32(core.core);
+        writer.String(core.type);
+        writer.U32(static_cast<std::uint32_t>(core.cpus.size()));
+        for (const unsigned cpu : core.cpus) {
+            writer.U32(cpu);
+        }
+        WriteFloats(writer, core.alone);
+        writer.F32(static_cast<float>(core.together));
+    }
+    writer.U32(static_cast<std::uint32_t>(result.curves.size()));
+    for (const BenchmarkCurve& curve : result.curves) {
+        writer.String(curve.name);
+        writer.String(curve.xUnit);
+        writer.String(curve.yUnit);
+        writer.U32(static_cast<std::uint32_t>(curve.points.size()));
+        for (const CurvePoint& point : curve.points) {
+            writer.F32(static_cast<float>(point.x));
+            writer.F32(static_cast<float>(point.y));
+        }
+    }
+}
+
+BenchmarkResultData ReadResult(BinaryReader& reader) {
+    BenchmarkResultData result;
+    result.score = reader.F64();
+    result.unit = reader.String();
+    result.details = reader.String();
+    ScoreStats& stats = result.stats;
+    stats.samples = reader.U32();
+    stats.outliers = reader.U32();
+    for (double* value : {&stats.median, &stats.mad, &stats.ciLow, &stats.ciHigh}) {
+        *value = reader.F64();
+    }
+    result.samples = ReadFloats(reader);
+    // Minimum encoded sizes: two empty strings and a float; an id, an
+    // empty string, two empty lists and a float; three empty strings and
+    // an empty list.
+    result.kernels.resize(reader.Count(12));
+    for (KernelScore& kernel : result.kernels) {
+        kernel.kernel = reader.String();
+        kernel.isa = reader.String();
+        kernel.gops = reader.F32();
+    }
+    result.cores.resize(reader.Count(20));
+    for (CoreScore& core : result.cores) {
+        core.core = reader.U32();
+        core.type = reader.String();
+        core.cpus.resize(reader.Count(sizeof(std::uint32_t)));
+        for (unsigned& cpu : core.cpus) {
+            cpu = reader.U32();
+        }
+        core.alone = ReadFloats(reader);
+        core.together = reader.F32();
+    }
+    result.curves.resize(reader.Count(16));
+    for (BenchmarkCurve& curve : result.curves) {
+        curve.name = reader.String();
+        curve.xUnit = reader.String();
+        curve.yUnit = reader.String();
+        curve.points.resize(reader.Count(2 * sizeof(float)));
+        for (CurvePoint& point : curve.points) {
+            point.x = reader.F32();
+            point.y = reader.F32();
+        }
+    }
+    return result;
+}
+
+std::int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+std::string BenchmarkSettings(const BenchmarkOptions& options, std::string_view kernel) {
+    std::string settings = "v" + std::to_string(kBenchmarkHarnessVersion);
+    if (kernel == kMemoryScore) {
+        // STREAM repeats a fixed number of times; only the pages matter.
+        settings += options.memoryOptions.hugePages ? ";huge-pages" : ";base-pages";
+        return settings;
+    }
+    if (kernel == kSustainedScore) {
+        settings += ";seconds=" + std::to_string(options.sustainedSeconds);
+        return settings;
+    }
+    settings += ";runs=" + std::to_string(options.repetitions);
+    if (kernel == kCpuScore && options.cpuMode == CpuBenchmarkMode::PerCore) {
+        settings += ";per-core";
+    }
+    return settings;
+}
+
+BenchmarkHistory::BenchmarkHistory(std::filesystem::path path) : path_(std::move(path)) {
+    Load();
+}
+
+std::filesystem::path BenchmarkHistory::DefaultPath() {
+    std::filesystem::path dir;
+#ifdef _WIN32
+    if (const wchar_t* local = _wgetenv(L"LOCALAPPDATA")) {
+        dir = local;
+    }
+#elif defined(__APPLE__)
+    if (const char* home = std::getenv("HOME")) {
+        dir = std::filesystem::path(home) / "Library" / "Application Support";
+    }
+#else
+    if (const char* data = std::getenv("XDG_DATA_HOME"); data && *data) {
+        dir = data;
+    } else if (const char* home = std::getenv("HOME")) {
+        dir = std::filesystem::path(home) / ".local" / "share";
+    }
+#endif
+    if (dir.empty()) {
+        return {};
+    }
+    return dir / "HardwareLimiter" / "history.bin";
+}
+
+std::optional<BenchmarkHistory::FileStamp> BenchmarkHistory::Stamp(const std::filesystem::path& path) {
+    std::error_code ec;
+    FileStamp stamp;
+    stamp.size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    stamp.modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return stamp;
+}
+
+// Keeps the file's bytes up to the first record that fails to parse or
+// checksum; whatever follows is unreadable.
+void BenchmarkHistory::Load() {
+    data_.clear();
+    foreign_ = false;
+    entries_.clear();
+    byKey_.clear();
+    byTarget_.clear();
+    stamp_.reset();
+    if (path_.empty()) {
+        return;
+    }
+    // Taken before reading, so a write racing the read shows up as a
+    // change on the next Append.
+    stamp_ = Stamp(path_);
+    std::ifstream stream(path_, std::ios::binary);
+    if (!stream) {
+        return;
+    }
+    std::string file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (file.empty()) {
+        return;
+    }
+    BinaryReader header(file);
+    char magic[sizeof(kMagic)] = {};
+    header.Bytes(magic, sizeof(magic));
+    if (!header.Ok() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || header.U32() != kVersion) {
+        foreign_ = file.size() >= kHeaderSize;  // a torn header is ours to rewrite
+        return;
+    }
+
+    size_t pos = kHeaderSize;
+    while (file.size() - pos >= kRecordOverhead) {
+        std::uint32_t size = 0;
+        std::memcpy(&size, file.data() + pos, sizeof(size));
+        if (file.size() - pos - kRecordOverhead < size) {
+            break;
+        }
+        const std::string_view payload(file.data() + pos + sizeof(size), size);
+        std::uint64_t checksum = 0;
+        std::memcpy(&checksum, payload.data() + payload.size(), sizeof(checksum));
+        if (checksum != BinaryChecksum(payload)) {
+            break;
+        }
+        BinaryReader reader(payload);
+        Entry entry;
+        entry.key.hardwareFingerprint = reader.U64();
+        entry.key.targetId = reader.String();
+        entry.key.kernel = reader.String();
+        entry.key.settings = reader.String();
+        entry.timestamp = reader.I64();
+        if (!reader.Ok()) {
+            break;
+        }
+        entry.offset = pos + sizeof(size);
+        entry.size = size;
+        Index(std::move(entry));
+        pos += kRecordOverhead + size;
+    }
+    file.resize(pos);
+    data_ = std::move(file);
+}
+
+void BenchmarkHistory::Index(Entry entry) {
+    const size_t index = entries_.size();
+    byKey_[KeyIndex(entry.key)].push_back(index);
+    byTarget_[TargetIndex(entry.key.hardwareFingerprint, entry.key.targetId)].push_back(index);
+    entries_.push_back(std::move(entry));
+}
+
+bool BenchmarkHistory::Append(const BenchmarkRecord& record) {
+    if (path_.empty()) {
+        return false;
+    }
+    // RecordRuns appends a record per part; only another writer makes the
+    // next one re-read the file.
+    if (Stamp(path_) != stamp_) {
+        Load();
+    }
+    if (foreign_) {
+        return false;
+    }
+    BinaryWriter payload;
+    WriteKey(payload, record.key, record.timestamp);
+    WriteResult(payload, record.result);
+    BinaryWriter writer;
+    if (data_.empty()) {
+        writer.Bytes(kMagic, sizeof(kMagic));
+        writer.U32(kVersion);
+    }
+    writer.U32(static_cast<std::uint32_t>(payload.Buffer().size()));
+    writer.Bytes(payload.Buffer().data(), payload.Buffer().size());
+    writer.U64(BinaryChecksum(payload.Buffer()));
+
+    std::error_code ec;
+    std::filesystem::create_directories(path_.parent_path(), ec);
+    // Drop a torn tail (or a torn header) so the new record stays readable.
+    if (std::filesystem::exists(path_, ec) && std::filesystem::file_size(path_, ec) != data_.size()) {
+        std::filesystem::resize_file(path_, data_.size(), ec);
+        if (ec) {
+            return false;
+        }
+    }
+    {
+        std::ofstream stream(path_, std::ios::binary | std::ios::app);
+        if (!stream) {
+            return false;
+        }
+        const std::string& buffer = writer.Buffer();
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!stream.flush()) {
+            return false;
+        }
+    }
+
+    data_ += writer.Buffer();
+    stamp_ = Stamp(path_);
+    Entry entry;
+    entry.key = record.key;
+    entry.timestamp = record.timestamp;
+    entry.size = payload.Buffer().size();
+    entry.offset = data_.size() - sizeof(std::uint64_t) - entry.size;
+    Index(std::move(entry));
+    return true;
+}
+
+BenchmarkRecord BenchmarkHistory::Decode(const Entry& entry) const {
+    BinaryReader reader(std::string_view(data_).substr(entry.offset, entry.size));
+    BenchmarkRecord record;
+    record.key.hardwareFingerprint = reader.U64();
+    record.key.targetId = reader.String();
+    record.key.kernel = reader.String();
+    record.key.settings = reader.String();
+    record.timestamp = reader.I64();
+    record.result = ReadResult(reader);
+    return record;
+}
+
+std::vector<BenchmarkRecord> BenchmarkHistory::Decode(const std::vector<size_t>& entries) const {
+    std::vector<BenchmarkRecord> records;
+    records.reserve(entries.size());
+    for (const size_t index : entries) {
+        records.push_back(Decode(entries_[index]));
+    }
+    return records;
+}
+
+std::vector<BenchmarkRecord> BenchmarkHistory::RunsOfTarget(std::uint64_t hardwareFingerprint,
+                                                            std::string_view targetId) const {
+    const auto found = byTarget_.find(TargetIndex(hardwareFingerprint, targetId));
+    return found == byTarget_.end() ? std::vector<BenchmarkRecord>() : Decode(found->second);
+}
+
+std::vector<BenchmarkRecord> BenchmarkHistory::Runs(const BenchmarkKey& key) const {
+    const auto found = byKey_.find(KeyIndex(key));
+    return found == byKey_.end() ? std::vector<BenchmarkRecord>() : Decode(found->second);
+}
+
+// Appended in time order, so the newest run is the last one with the key
+// (barring a clock set back).
+std::optional<BenchmarkRecord> BenchmarkHistory::Latest(const BenchmarkKey& key, std::chrono::seconds maxAge) const {
+    const auto found = byKey_.find(KeyIndex(key));
+    if (found == byKey_.end()) {
+        return std::nullopt;
+    }
+    const Entry& entry = entries_[found->second.back()];
+    const std::int64_t age = Now() - entry.timestamp;
+    if (age < 0 || age > maxAge.count()) {
+        return std::nullopt;
+    }
+    return Decode(entry);
+}
+
+RegressionCheck BenchmarkHistory::CheckRegression(const BenchmarkRecord& run, size_t window) const {
+    RegressionCheck check;
+    check.kernel = run.key.kernel;
+    const auto found = byKey_.find(KeyIndex(run.key));
+    if (found == byKey_.end() || window == 0) {
+        return check;
+    }
+    const std::vector<size_t>& runs = found->second;
+    const size_t first = runs.size() > window ? runs.size() - window : 0;
+    std::vector<double> pooled;
+    for (size_t i = first; i < runs.size(); ++i) {
+        const std::vector<double> samples = Decode(entries_[runs[i]]).result.samples;
+        pooled.insert(pooled.end(), samples.begin(), samples.end());
+    }
+    check.baselineRuns = runs.size() - first;
+    check.baselineMedian = SummarizeSamples(pooled).median;
+    check.comparison = CompareSamples(pooled, run.result.samples);
+    check.regressed = check.comparison.significant && check.comparison.change < -kRegressionThreshold;
+    return check;
+}
+
+BenchmarkRunKeys MakeRunKeys(std::uint64_t hardwareFingerprint, const std::string& cpuTarget,
+                             const std::string& gpuTarget, const BenchmarkOptions& options) {
+    BenchmarkRunKeys keys;
+    keys.cpu = {hardwareFingerprint, cpuTarget, kCpuScore, BenchmarkSettings(options, kCpuScore)};
+    keys.gpu = {hardwareFingerprint, gpuTarget, kGpuScore, BenchmarkSettings(options, kGpuScore)};
+    keys.memory = {hardwareFingerprint, cpuTarget, kMemoryScore, BenchmarkSettings(options, kMemoryScore)};
+    keys.workloads = {hardwareFingerprint, cpuTarget, kWorkloadScore, BenchmarkSettings(options, kWorkloadScore)};
+    keys.sustained = {hardwareFingerprint, cpuTarget, kSustainedScore, BenchmarkSettings(options, kSustainedScore)};
+    keys.scaling = {hardwareFingerprint, cpuTarget, kScalingScore, BenchmarkSettings(options, kScalingScore)};
+    return keys;
+}
+
+BenchmarkReport ReuseStoredRuns(const BenchmarkHistory& history, const BenchmarkRunKeys& keys,
+                                BenchmarkOptions& options, std::chrono::seconds maxAge) {
+    BenchmarkReport report;
+    const auto reuse = [&](bool& wanted, const BenchmarkKey& key, std::optional<BenchmarkResultData>& slot) {
+        if (!wanted) {
+            return;
+        }
+        if (auto stored = history.Latest(key, maxAge)) {
+            slot = std::move(stored->result);
+            wanted = false;
+        }
+    };
+    reuse(options.cpu, keys.cpu, report.cpu);
+    reuse(options.gpu, keys.gpu, report.gpu);
+    reuse(options.memory, keys.memory, report.memory);
+    reuse(options.workloads, keys.workloads, report.workloads);
+    reuse(options.scaling, keys.scaling, report.scaling);
+    if (options.sustainedSeconds > 0) {
+        bool wanted = true;
+        reuse(wanted, keys.sustained, report.sustained);
+        if (!wanted) {
+            options.sustainedSeconds = 0;
+        }
+    }
+    return report;
+}
+
+std::vector<RegressionCheck> RecordRuns(BenchmarkHistory& history, const BenchmarkRunKeys& keys,
+                                        const BenchmarkOptions& options, const BenchmarkReport& report) {
+    std::vector<RegressionCheck> checks;
+    const std::int64_t now = Now();
+    const auto record = [&](bool measured, const BenchmarkKey& key, const std::optional<BenchmarkResultData>& result) {
+        if (!measured || !result) {
+            return;
+        }
+        BenchmarkRecord run{key, now, *result};
+        checks.push_back(history.CheckRegression(run));
+        history.Append(run);
+    };
+    record(options.cpu, keys.cpu, report.cpu);
+    record(options.gpu, keys.gpu, report.gpu);
+    record(options.memory, keys.memory, report.memory);
+    record(options.workloads, keys.workloads, report.workloads);
+    record(options.sustainedSeconds > 0, keys.sustained, report.sustained);
+    record(options.scaling, keys.scaling, report.scaling);
+    return checks;
+}
@@ -2,13 +2,23 @@
 
 #include <algorithm>
 #include <atomic>
+#include <barrier>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
-#include <random>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
 #include "AppState.hpp"
+#include "BenchmarkStats.hpp"
+#include "CpuKernels.hpp"
+#include "CpuTopology.hpp"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -21,6 +31,354 @@
 
 namespace {
 
+// Seconds per timed call, and how many calls: the median of the timed
+// ones is the score.
+constexpr double kKernelSeconds = 0.005;     // per kernel and level
+constexpr double kThroughputSeconds = 0.05;  // the all-threads headline run
+constexpr double kCoreSeconds = 0.02;        // per logical CPU or SMT group in per-core mode
+constexpr RepeatOptions kKernelRepeats{1, 5};
+constexpr RepeatOptions kCoreRepeats{1, 5};
+constexpr int kHeadlineWarmup = 1;  // BenchmarkOptions::repetitions sets the timed calls
+constexpr CpuKernel kHeadlineKernel = CpuKernel::DotF64;
+// Sustained mode: kernel calls short enough that a worker's counter moves
+// many times per interval, intervals of at least kSustainedInterval with
+// at most kSustainedPoints of them, and the band around the steady level
+// the rolling median of a second of intervals must stay within.
+constexpr double kSustainedChunkSeconds = 0.001;
+constexpr double kSustainedInterval = 0.25;
+constexpr int kSustainedPoints = 240;
+constexpr double kSteadyBand = 0.03;
+// Scaling mode: seconds per timed call and calls per kernel below all
+// threads (all threads take BenchmarkOptions::repetitions, the score's
+// samples); and the gain past a target's limits still called flat.
+constexpr double kScalingSeconds = 0.01;
+constexpr RepeatOptions kScalingRepeats{1, 5};
+constexpr double kScalingFlat = 0.1;
+
+struct TimedRun {
+    KernelRun run;
+    double seconds = 0.0;
+};
+
+TimedRun TimeKernel(KernelFn kernel, std::uint64_t rounds) {
+    const auto start = std::chrono::steady_clock::now();
+    TimedRun timed;
+    timed.run = kernel(rounds);
+    timed.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return timed;
+}
+
+// Rounds for one call to take about `targetSeconds`: grown 4x at a time
+// until a call takes a quarter of that, then scaled.
+std::uint64_t CalibrateRounds(KernelFn kernel, double targetSeconds) {
+    std::uint64_t rounds = 1;
+    while (true) {
+        const TimedRun timed = TimeKernel(kernel, rounds);
+        DoNotOptimize(timed.run.checksum);
+        if (timed.seconds >= targetSeconds / 4.0 || rounds >= (1ull << 40)) {
+            const double scale = targetSeconds / std::max(timed.seconds, 1e-9);
+            return std::max<std::uint64_t>(1, static_cast<std::uint64_t>(static_cast<double>(rounds) * scale));
+        }
+        rounds *= 4;
+    }
+}
+
+std::string FormatRate(double gops) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f", gops);
+    return buffer;
+}
+
+struct WorkerRuns {
+    std::vector<double> rates;  // G ops/s of each timed call, all workers together
+    double checksum = 0.0;
+    bool pinned = true;  // every worker that had a CPU got it
+};
+
+// Runs `kernel` on `workers` threads at once, or with `pins`, on one
+// thread per entry pinned to that CPU. The threads start once and run
+// every call together, released by a barrier, so thread start-up and
+// pinning stay out of the timings; a call is timed from the release to
+// the last worker finishing.
+WorkerRuns RunWorkers(KernelFn kernel, std::uint64_t rounds, unsigned workers, std::span<const LogicalCpu> pins,
+                      const RepeatOptions& repeats) {
+    const size_t count = pins.empty() ? workers : pins.size();
+    const int calls = repeats.warmup + repeats.repetitions;
+    std::barrier sync(static_cast<std::ptrdiff_t>(count) + 1);
+    std::vector<std::uint64_t> operations(count);
+    std::vector<double> checksums(count);
+    std::atomic<bool> pinned = true;
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (size_t t = 0; t < count; ++t) {
+        threads.emplace_back([&, t] {
+            if (!pins.empty() && !PinCurrentThread(pins[t])) {
+                pinned = false;
+            }
+            for (int call = 0; call < calls; ++call) {
+                sync.arrive_and_wait();
+                const KernelRun run = kernel(rounds);
+                operations[t] = run.operations;
+                checksums[t] += run.checksum;
+                sync.arrive_and_wait();
+            }
+        });
+    }
+    WorkerRuns result;
+    result.rates = Repeat(
+        [&] {
+            sync.arrive_and_wait();
+            const auto start = std::chrono::steady_clock::now();
+            sync.arrive_and_wait();
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::uint64_t total = 0;
+            for (const std::uint64_t done : operations) {
+                total += done;
+            }
+            return static_cast<double>(total) / std::max(seconds, 1e-9) / 1e9;
+        },
+        repeats);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    result.pinned = pinned;
+    for (const double checksum : checksums) {
+        result.checksum += checksum;
+    }
+    return result;
+}
+
+// P-cores, then uniform ones, then E-cores.
+int CoreTypeOrder(CoreType type) {
+    return type == CoreType::Performance ? 0 : type == CoreType::Uniform ? 1 : 2;
+}
+
+// Each logical CPU alone, then each core's SMT siblings together, ordered
+// by core type (P-cores, then uniform ones, then E-cores) and core, with
+// progress reported from `progressFrom` of the CPU part on. Empty if any
+// worker could not be pinned or the run was cancelled.
+std::vector<CoreScore> MeasureCores(KernelFn kernel, std::uint64_t rounds, const std::vector<LogicalCpu>& topology,
+                                    double& checksum, const BenchmarkControl& control, double progressFrom) {
+    std::map<std::pair<CoreType, unsigned>, std::vector<LogicalCpu>> byCore;
+    for (const auto& cpu : topology) {
+        byCore[{cpu.type, cpu.core}].push_back(cpu);
+    }
+    std::vector<std::pair<CoreType, unsigned>> order;
+    for (const auto& entry : byCore) {
+        order.push_back(entry.first);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](const auto& a, const auto& b) {
+        return CoreTypeOrder(a.first) < CoreTypeOrder(b.first);
+    });
+
+    size_t measurements = topology.size();
+    for (const auto& entry : byCore) {
+        measurements += entry.second.size() > 1 ? 1 : 0;
+    }
+    size_t measured = 0;
+    const auto advance = [&](const std::string& step) {
+        const double done = static_cast<double>(measured++) / static_cast<double>(measurements);
+        return control.Advance(progressFrom + (1.0 - progressFrom) * done, step);
+    };
+
+    std::vector<CoreScore> cores;
+    for (const auto& key : order) {
+        const std::vector<LogicalCpu>& cpus = byCore[key];
+        CoreScore score;
+        score.core = key.second;
+        score.type = CoreTypeName(key.first);
+        for (const auto& cpu : cpus) {
+            if (!advance("CPU " + std::to_string(cpu.index) + " alone")) {
+                return {};
+            }
+            const WorkerRuns runs = RunWorkers(kernel, rounds, 1, std::span(&cpu, 1), kCoreRepeats);
+            if (!runs.pinned) {
+                return {};
+            }
+            checksum += runs.checksum;
+            score.cpus.push_back(cpu.index);
+            score.alone.push_back(SummarizeSamples(runs.rates).median);
+        }
+        if (cpus.size() > 1) {
+            if (!advance("core " + std::to_string(key.second) + " SMT siblings together")) {
+                return {};
+            }
+            const WorkerRuns runs = RunWorkers(kernel, rounds, 0, cpus, kCoreRepeats);
+            if (!runs.pinned) {
+                return {};
+            }
+            checksum += runs.checksum;
+            score.together = SummarizeSamples(runs.rates).median;
+        }
+        cores.push_back(std::move(score));
+    }
+    return cores;
+}
+
+// Per core type: core count, mean single-thread score and mean SMT-group
+// score, then one line per core.
+std::string DescribeCores(const std::vector<CoreScore>& cores) {
+    std::string text = "\nPer core (GFLOPS, pinned, median of " + std::to_string(kCoreRepeats.repetitions) + "):";
+    for (size_t first = 0; first < cores.size();) {
+        size_t last = first;
+        double alone = 0.0;
+        size_t aloneCount = 0;
+        double together = 0.0;
+        size_t togetherCount = 0;
+        for (; last < cores.size() && cores[last].type == cores[first].type; ++last) {
+            for (const double value : cores[last].alone) {
+                alone += value;
+                ++aloneCount;
+            }
+            if (cores[last].together > 0.0) {
+                together += cores[last].together;
+                ++togetherCount;
+            }
+        }
+        text += "\n" + cores[first].type + " x" + std::to_string(last - first) + ": 1 thread " +
+                FormatRate(alone / static_cast<double>(std::max<size_t>(aloneCount, 1)));
+        if (togetherCount > 0) {
+            text += ", SMT siblings together " + FormatRate(together / static_cast<double>(togetherCount));
+        }
+        first = last;
+    }
+    for (const auto& core : cores) {
+        text += "\ncore " + std::to_string(core.core) + " (" + core.type + "):";
+        for (size_t i = 0; i < core.cpus.size(); ++i) {
+            text += " cpu" + std::to_string(core.cpus[i]) + " " + FormatRate(core.alone[i]);
+        }
+        if (core.together > 0.0) {
+            text += ", together " + FormatRate(core.together);
+        }
+    }
+    return text;
+}
+
+// The widest level `kernel` is built for, up to `best`; below it only if
+// this build lacks that level.
+SimdIsa WidestIsa(CpuKernel kernel, SimdIsa best) {
+    while (!FindCpuKernel(kernel, best)) {
+        best = static_cast<SimdIsa>(static_cast<int>(best) - 1);
+    }
+    return best;
+}
+
+// Operations a sustained worker has done, written by that worker alone
+// (a plain store, no read-modify-write) and read by the sampler; one per
+// cache line so the workers never share one.
+struct alignas(64) WorkerCounter {
+    std::atomic<std::uint64_t> operations = 0;
+};
+
+struct SteadyState {
+    size_t first = 0;       // interval the steady state starts at
+    bool reached = false;   // false: still drifting at the end, `first` is the last quarter's start
+    double level = 0.0;     // median of the last quarter
+};
+
+// The steady level is the median of the run's last quarter (at least
+// `window` intervals). The steady state starts where the rolling median of
+// `window` intervals enters the band around it for good: kSteadyBand, or
+// the last quarter's own spread (1.4826 MAD) on a noisier machine.
+SteadyState FindSteadyState(const std::vector<double>& totals, size_t window) {
+    const size_t count = totals.size();
+    window = std::clamp<size_t>(window, 1, count);
+    const size_t tail = std::max(window, count / 4);
+    SteadyState steady;
+    std::vector<double> last(totals.end() - static_cast<std::ptrdiff_t>(tail), totals.end());
+    steady.level = Median(last);
+    for (double& value : last) {
+        value = std::abs(value - steady.level);
+    }
+    const double band = std::max(kSteadyBand, 1.4826 * Median(last) / std::max(steady.level, 1e-9));
+    const auto settled = [&](size_t start) {
+        const auto from = totals.begin() + static_cast<std::ptrdiff_t>(start);
+        const double median = Median(std::vector<double>(from, from + static_cast<std::ptrdiff_t>(window)));
+        return std::abs(median / steady.level - 1.0) <= band;
+    };
+    size_t first = count - window;
+    if (steady.level <= 0.0 || !settled(first)) {
+        steady.first = count - tail;
+        return steady;
+    }
+    while (first > 0 && settled(first - 1)) {
+        --first;
+    }
+    steady.first = first;
+    steady.reached = true;
+    return steady;
+}
+
+// The logical CPUs in the order the scaling sweep adds threads: one on
+// each physical core first, fastest core type first, then the cores'
+// second SMT siblings and so on, so the sweep only leans on SMT once every
+// core is busy.
+std::vector<LogicalCpu> ScalingOrder(const std::vector<LogicalCpu>& topology) {
+    std::map<std::pair<int, unsigned>, std::vector<LogicalCpu>> byCore;
+    for (const auto& cpu : topology) {
+        byCore[{CoreTypeOrder(cpu.type), cpu.core}].push_back(cpu);
+    }
+    std::vector<LogicalCpu> order;
+    for (size_t sibling = 0; order.size() < topology.size(); ++sibling) {
+        for (const auto& entry : byCore) {
+            if (sibling < entry.second.size()) {
+                order.push_back(entry.second[sibling]);
+            }
+        }
+    }
+    return order;
+}
+
+// 1, 2, 4... below `threads`, then one thread per core and all threads.
+std::vector<unsigned> ScalingThreadCounts(unsigned threads, unsigned cores) {
+    std::vector<unsigned> counts;
+    for (unsigned count = 1; count < threads; count *= 2) {
+        counts.push_back(count);
+    }
+    if (cores > 0 && cores < threads) {
+        counts.push_back(cores);
+    }
+    counts.push_back(threads);
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    return counts;
+}
+
+// Least-squares serial fraction f of Amdahl's law, S(n) = 1 / (f + (1 - f) / n),
+// over (threads, speedup) points, in its linear form 1/S - 1/n = f (1 - 1/n).
+double FitSerialFraction(const std::vector<CurvePoint>& speedup) {
+    double xy = 0.0;
+    double xx = 0.0;
+    for (const CurvePoint& point : speedup) {
+        if (point.x > 1.0 && point.y > 0.0) {
+            const double x = 1.0 - 1.0 / point.x;
+            xy += x * (1.0 / point.y - 1.0 / point.x);
+            xx += x * x;
+        }
+    }
+    return xx > 0.0 ? std::clamp(xy / xx, 0.0, 1.0) : 0.0;
+}
+
+double GeometricMean(const std::vector<double>& values) {
+    double logs = 0.0;
+    for (const double value : values) {
+        logs += std::log(std::max(value, 1e-12));
+    }
+    return values.empty() ? 0.0 : std::exp(logs / static_cast<double>(values.size()));
+}
+
+std::string FormatPercent(double fraction) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f%%", fraction * 100.0);
+    return buffer;
+}
+
+std::string FormatChange(double fraction) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%+.1f%%", fraction * 100.0);
+    return buffer;
+}
+
 BenchmarkResultData MakeResult(double score, const char* unit, std::string details) {
     BenchmarkResultData result;
     result.score = score;
@@ -31,15 +389,96 @@ BenchmarkResultData MakeResult(double score, const char* unit, std::string detai
 
 }  // namespace
 
-BenchmarkReport BenchmarkRunner::Run(const HardwareSnapshot& snapshot) const {
+BenchmarkReport BenchmarkRunner::Run(const HardwareSnapshot& snapshot, const BenchmarkOptions& options,
+                                     BenchmarkControl* control, const PartialFn& onPartial) const {
+    BenchmarkControl detached;
+    BenchmarkControl& active = control ? *control : detached;
+    // Each part's share of the progress, by its rough duration in seconds.
+    const unsigned cpus = std::max(1u, snapshot.cpu.logicalCores);
+    const double cpuWeight =
+        options.cpu ? 1.5 + (options.cpuMode == CpuBenchmarkMode::PerCore ? 0.15 * cpus : 0.0) : 0.0;
+    const double gpuWeight = options.gpu ? 0.3 : 0.0;
+    const double memoryWeight = options.memory ? 6.0 : 0.0;
+    const double workloadWeight = options.workloads ? 1.2 : 0.0;
+    const double sustainedWeight = std::max(0, options.sustainedSeconds);
+    const double scalingWeight =
+        options.scaling ? 0.4 * static_cast<double>(ScalingThreadCounts(cpus, snapshot.cpu.physicalCores).size())
+                        : 0.0;
+    const double total = cpuWeight + gpuWeight + memoryWeight + workloadWeight + sustainedWeight + scalingWeight;
+    double done = 0.0;
     BenchmarkReport report;
-    report.cpu = RunCpuBenchmark(snapshot);
-    report.gpu = RunGpuBenchmark(snapshot);
+    const auto beginPart = [&](double weight) {
+        active.BeginPart(done / total, (done + weight) / total);
+        done += weight;
+    };
+    // False once cancelled, which drops whatever the part left unfinished.
+    const auto finishPart = [&] {
+        if (active.Cancelled()) {
+            report.cancelled = true;
+            return false;
+        }
+        if (onPartial) {
+            onPartial(report);
+        }
+        return true;
+    };
+
+    if (options.cpu) {
+        beginPart(cpuWeight);
+        report.cpu = RunCpuBenchmark(snapshot, options, active);
+        if (!finishPart()) {
+            return report;
+        }
+    }
+    if (options.gpu) {
+        beginPart(gpuWeight);
+        report.gpu = RunGpuBenchmark(snapshot, options, active);
+        if (!finishPart()) {
+            return report;
+        }
+    }
+    if (options.memory) {
+        beginPart(memoryWeight);
+        report.memory = MemoryBenchmark().Run(snapshot, options.memoryOptions, &active);
+        if (!finishPart()) {
+            return report;
+        }
+    }
+    if (options.workloads) {
+        beginPart(workloadWeight);
+        report.workloads = WorkloadBenchmark().Run(snapshot, options.repetitions, &active);
+        if (!finishPart()) {
+            return report;
+        }
+    }
+    if (options.sustainedSeconds > 0) {
+        beginPart(sustainedWeight);
+        report.sustained = RunSustainedBenchmark(snapshot, options, active);
+        if (!finishPart()) {
+            return report;
+        }
+    }
+    if (options.scaling) {
+        beginPart(scalingWeight);
+        report.scaling = RunScalingBenchmark(snapshot, options, active);
+        finishPart();
+    }
     return report;
 }
 
-std::optional<BenchmarkResultData> BenchmarkRunner::RunCpuBenchmark(const HardwareSnapshot& snapshot) const {
-    using namespace std::chrono;
+// Every kernel at every level up to the detected one, single-threaded,
+// then the headline score: the dot product at the detected level on all
+// threads. Comparing the per-level rows of two runs shows whether a
+// mimicked SKU also lost the wide-vector advantage, which clock and power
+// caps alone do not take away. The per-core mode pins the headline
+// workers, one per logical CPU, and adds the per-core map that targets
+// limiting maxCores/maxThreads are checked against. Every figure is the
+// median of several timed calls after an untimed warmup; the headline
+// keeps its samples, so two runs can be tested against each other.
+std::optional<BenchmarkResultData> BenchmarkRunner::RunCpuBenchmark(const HardwareSnapshot& snapshot,
+                                                                    const BenchmarkOptions& options,
+                                                                    BenchmarkControl& control) const {
+    const CpuBenchmarkMode mode = options.cpuMode;
     unsigned threadCount = snapshot.cpu.logicalCores;
     if (threadCount == 0) {
         threadCount = std::thread::hardware_concurrency();
@@ -48,55 +487,447 @@ std::optional<BenchmarkResultData> BenchmarkRunner::RunCpuBenchmark(const Hardwa
         threadCount = 1;
     }
     const unsigned threads = threadCount;
-    const size_t elements = 1 << 18;  // 262k elements
-    const int iterations = 200;
-
-    std::vector<double> a(elements);
-    std::vector<double> b(elements);
-    std::mt19937_64 rng(42);
-    std::uniform_real_distribution<double> dist(0.0, 1.0);
-    for (size_t i = 0; i < elements; ++i) {
-        a[i] = dist(rng);
-        b[i] = dist(rng);
+    const SimdIsa best = DetectSimdIsa();
+    // Progress: the matrix, then the headline run, then the per-core map.
+    const double matrixEnd = mode == CpuBenchmarkMode::PerCore ? 0.3 : 0.5;
+    const double headlineEnd = mode == CpuBenchmarkMode::PerCore ? 0.5 : 1.0;
+    const auto runs = [&](CpuKernel kernel, SimdIsa isa) { return isa <= best && FindCpuKernel(kernel, isa); };
+    size_t cells = 0;
+    for (const CpuKernel kernel : kCpuKernels) {
+        cells += std::count_if(kSimdIsas.begin(), kSimdIsas.end(), [&](SimdIsa isa) { return runs(kernel, isa); });
     }
 
-    std::atomic<uint64_t> operations = 0;
-    auto worker = [&](unsigned /*index*/) {
-        double acc = 0.0;
-        for (int iter = 0; iter < iterations; ++iter) {
-            for (size_t i = 0; i < elements; ++i) {
-                acc += a[i] * b[i];
+    std::vector<KernelScore> scores;
+    std::string matrix;
+    double checksum = 0.0;
+    std::uint64_t headlineRounds = 0;
+    for (const CpuKernel kernel : kCpuKernels) {
+        matrix += std::string("\n") + CpuKernelName(kernel) + ":";
+        for (const SimdIsa isa : kSimdIsas) {
+            if (!runs(kernel, isa)) {
+                continue;
+            }
+            const double done = static_cast<double>(scores.size()) / static_cast<double>(cells);
+            if (!control.Advance(matrixEnd * done,
+                                 std::string("CPU ") + CpuKernelName(kernel) + " (" + SimdIsaName(isa) + ")")) {
+                return std::nullopt;
+            }
+            const KernelFn function = FindCpuKernel(kernel, isa);
+            const std::uint64_t rounds = CalibrateRounds(function, kKernelSeconds);
+            const std::vector<double> samples = Repeat(
+                [&] {
+                    const TimedRun timed = TimeKernel(function, rounds);
+                    checksum += timed.run.checksum;
+                    return static_cast<double>(timed.run.operations) / std::max(timed.seconds, 1e-9) / 1e9;
+                },
+                kKernelRepeats);
+            const double gops = SummarizeSamples(samples).median;
+            scores.push_back({CpuKernelName(kernel), SimdIsaName(isa), gops});
+            matrix += std::string(" ") + SimdIsaName(isa) + " " + FormatRate(gops);
+            if (kernel == kHeadlineKernel) {
+                headlineRounds = rounds;  // the last one run is the widest
             }
         }
-        operations += static_cast<uint64_t>(iterations) * elements * 2;
-        return acc;
+    }
+
+    const SimdIsa headlineIsa = WidestIsa(kHeadlineKernel, best);
+    const KernelFn headline = FindCpuKernel(kHeadlineKernel, headlineIsa);
+    const auto scaledRounds = [&](double seconds) {
+        return std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(static_cast<double>(headlineRounds) * seconds / kKernelSeconds));
     };
+    const std::vector<LogicalCpu> topology =
+        mode == CpuBenchmarkMode::PerCore ? QueryCpuTopology() : std::vector<LogicalCpu>();
+    if (!control.Advance(matrixEnd, "CPU all threads")) {
+        return std::nullopt;
+    }
+    const RepeatOptions headlineRepeats{kHeadlineWarmup, std::max(1, options.repetitions)};
+    const WorkerRuns all = RunWorkers(headline, scaledRounds(kThroughputSeconds), threads, topology, headlineRepeats);
+    const ScoreStats stats = SummarizeSamples(all.rates);
+    if (stats.median <= 0.0) {
+        return std::nullopt;
+    }
+    checksum += all.checksum;
+
+    std::vector<CoreScore> cores;
+    std::string coreDetails;
+    if (mode == CpuBenchmarkMode::PerCore) {
+        if (!topology.empty() && all.pinned) {
+            cores = MeasureCores(headline, scaledRounds(kCoreSeconds), topology, checksum, control, headlineEnd);
+        }
+        if (control.Cancelled()) {
+            return std::nullopt;
+        }
+        coreDetails = cores.empty() ? "\nPer core: unavailable, threads cannot be pinned here" : DescribeCores(cores);
+    }
+    DoNotOptimize(checksum);
+
+    const unsigned workers = topology.empty() ? threads : static_cast<unsigned>(topology.size());
+    const char* pinning = topology.empty() ? "" : all.pinned ? " (pinned)" : " (pinning refused)";
+    std::string details = "Threads: " + std::to_string(workers) + pinning +
+                          ", kernel: " + CpuKernelName(kHeadlineKernel) + " (" + SimdIsaName(headlineIsa) +
+                          ")\nGFLOPS: " + FormatStats(stats) + " after " + std::to_string(kHeadlineWarmup) +
+                          " warmup\nSingle-thread G ops/s by ISA (median of " +
+                          std::to_string(kKernelRepeats.repetitions) + "):" + matrix + coreDetails;
+    BenchmarkResultData result = MakeResult(stats.median, "GFLOPS", details);
+    result.samples = all.rates;
+    result.stats = stats;
+    result.kernels = std::move(scores);
+    result.cores = std::move(cores);
+    return result;
+}
+
+// The headline kernel on every logical CPU for options.sustainedSeconds.
+// Each worker makes millisecond calls and stores its running operation
+// count in its own counter; this thread reads the counters at fixed
+// intervals, so the workers never wait for it. The result keeps the
+// series (all workers together, and the slowest and fastest one) and
+// scores the steady state: the median of the intervals after the run
+// settled.
+std::optional<BenchmarkResultData> BenchmarkRunner::RunSustainedBenchmark(const HardwareSnapshot& snapshot,
+                                                                          const BenchmarkOptions& options,
+                                                                          BenchmarkControl& control) const {
+    using Clock = std::chrono::steady_clock;
+    unsigned threads = snapshot.cpu.logicalCores;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const SimdIsa isa = WidestIsa(kHeadlineKernel, DetectSimdIsa());
+    const KernelFn kernel = FindCpuKernel(kHeadlineKernel, isa);
+    const double duration = std::max(1, options.sustainedSeconds);
+    const double interval = std::max(kSustainedInterval, duration / kSustainedPoints);
+    const auto intervals = static_cast<size_t>(std::max(1.0, std::round(duration / interval)));
+    if (!control.Advance(0.0, "CPU sustained load")) {
+        return std::nullopt;
+    }
+    const std::uint64_t rounds = CalibrateRounds(kernel, kSustainedChunkSeconds);
 
-    auto start = high_resolution_clock::now();
+    std::vector<WorkerCounter> counters(threads);
+    std::vector<double> checksums(threads);
+    std::atomic<bool> stop = false;
+    std::barrier start(static_cast<std::ptrdiff_t>(threads) + 1);
     std::vector<std::thread> workers;
     workers.reserve(threads);
     for (unsigned t = 0; t < threads; ++t) {
-        workers.emplace_back(worker, t);
+        workers.emplace_back([&, t] {
+            start.arrive_and_wait();
+            std::uint64_t done = 0;
+            double checksum = 0.0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const KernelRun run = kernel(rounds);
+                checksum += run.checksum;
+                done += run.operations;
+                counters[t].operations.store(done, std::memory_order_relaxed);
+            }
+            checksums[t] = checksum;
+        });
+    }
+
+    BenchmarkCurve total{kSustainedCurve, "s", "GFLOPS", {}};
+    BenchmarkCurve slowest{kSlowestWorkerCurve, "s", "GFLOPS", {}};
+    BenchmarkCurve fastest{kFastestWorkerCurve, "s", "GFLOPS", {}};
+    std::vector<double> totals;
+    std::vector<std::uint64_t> before(threads, 0);
+    bool cancelled = false;
+    start.arrive_and_wait();
+    const Clock::time_point begin = Clock::now();
+    Clock::time_point previous = begin;
+    for (size_t i = 1; i <= intervals && !cancelled; ++i) {
+        std::this_thread::sleep_until(
+            begin + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval * i)));
+        // Rates over the time that actually passed, however late the wake-up.
+        const Clock::time_point now = Clock::now();
+        const double seconds = std::max(std::chrono::duration<double>(now - previous).count(), 1e-9);
+        previous = now;
+        double sum = 0.0;
+        double low = 0.0;
+        double high = 0.0;
+        for (unsigned t = 0; t < threads; ++t) {
+            const std::uint64_t done = counters[t].operations.load(std::memory_order_relaxed);
+            const double rate = static_cast<double>(done - before[t]) / seconds / 1e9;
+            before[t] = done;
+            sum += rate;
+            low = t == 0 ? rate : std::min(low, rate);
+            high = std::max(high, rate);
+        }
+        const double at = std::chrono::duration<double>(now - begin).count();
+        total.points.push_back({at, sum});
+        slowest.points.push_back({at, low});
+        fastest.points.push_back({at, high});
+        totals.push_back(sum);
+        cancelled = !control.Advance(at / duration, "CPU sustained load, " + std::to_string(std::lround(at)) +
+                                                        " s of " + std::to_string(std::lround(duration)));
     }
-    for (auto& th : workers) {
-        th.join();
+    stop = true;
+    for (auto& worker : workers) {
+        worker.join();
     }
-    auto end = high_resolution_clock::now();
-    const double seconds = duration<double>(end - start).count();
-    if (seconds <= 0.0) {
+    if (cancelled) {
         return std::nullopt;
     }
-    const double gflops = (operations.load() / seconds) / 1e9;
-    std::string details = "Threads: " + std::to_string(threads) +
-                          ", ops: " + std::to_string(operations.load()) +
-                          ", time: " + std::to_string(seconds) + "s";
-    return MakeResult(gflops, "GFLOPS", details);
+    double checksum = 0.0;
+    for (const double value : checksums) {
+        checksum += value;
+    }
+    DoNotOptimize(checksum);
+
+    const size_t window = static_cast<size_t>(std::max(1.0, std::round(1.0 / interval)));
+    const SteadyState steady = FindSteadyState(totals, window);
+    std::vector<double> samples(totals.begin() + static_cast<std::ptrdiff_t>(steady.first), totals.end());
+    const ScoreStats stats = SummarizeSamples(samples);
+    if (stats.median <= 0.0) {
+        return std::nullopt;
+    }
+    const double settled = steady.first == 0 ? 0.0 : total.points[steady.first - 1].x;
+    const auto firstSecond = totals.begin() + static_cast<std::ptrdiff_t>(std::min(window, totals.size()));
+    const double initial = Median(std::vector<double>(totals.begin(), firstSecond));
+    std::vector<double> slowestSteady;
+    std::vector<double> fastestSteady;
+    for (size_t i = steady.first; i < totals.size(); ++i) {
+        slowestSteady.push_back(slowest.points[i].y);
+        fastestSteady.push_back(fastest.points[i].y);
+    }
+
+    char intervalText[16];
+    std::snprintf(intervalText, sizeof(intervalText), "%g", interval);
+    char change[16];
+    std::snprintf(change, sizeof(change), "%+.1f%%", (stats.median / std::max(initial, 1e-9) - 1.0) * 100.0);
+    std::string details = "Threads: " + std::to_string(threads) + ", kernel: " + CpuKernelName(kHeadlineKernel) +
+                          " (" + SimdIsaName(isa) + "), " + std::to_string(std::lround(duration)) +
+                          " s sampled every " + intervalText + " s\nFirst second: " + FormatRate(initial) +
+                          " GFLOPS, steady state: " + FormatRate(stats.median) + " GFLOPS (" + change + ")\n" +
+                          (steady.reached ? "Steady after " + FormatRate(settled) + " s"
+                                          : std::string("No steady state within the run; scored on its last quarter")) +
+                          "\nGFLOPS per interval at steady state: " + FormatStats(stats) +
+                          "\nOne worker at steady state: slowest " + FormatRate(Median(slowestSteady)) +
+                          ", fastest " + FormatRate(Median(fastestSteady)) + " GFLOPS";
+    BenchmarkResultData result = MakeResult(stats.median, "GFLOPS", details);
+    result.samples = std::move(samples);
+    result.stats = stats;
+    result.curves.push_back(std::move(total));
+    result.curves.push_back(std::move(slowest));
+    result.curves.push_back(std::move(fastest));
+    result.curves.push_back({kSteadyStateCurve, "s", "GFLOPS", {{steady.reached ? settled : duration, stats.median}}});
+    return result;
 }
 
-std::optional<BenchmarkResultData> BenchmarkRunner::RunGpuBenchmark(const HardwareSnapshot& snapshot) const {
+// Every CPU kernel, at its widest level, on 1, 2, 4... threads, one
+// thread per core and all threads. The workers are pinned in ScalingOrder
+// and each runs its own kernel calls on its own stack-resident data, so
+// a thread count changes nothing but how many cores and SMT siblings
+// work; a call is timed from the barrier release to the last worker done.
+// A count's speedup is the geometric mean over the kernels of its rate
+// against one thread's; the score is the speedup on all threads.
+std::optional<BenchmarkResultData> BenchmarkRunner::RunScalingBenchmark(const HardwareSnapshot& snapshot,
+                                                                        const BenchmarkOptions& options,
+                                                                        BenchmarkControl& control) const {
+    const std::vector<LogicalCpu> topology = QueryCpuTopology();
+    const std::vector<LogicalCpu> order = ScalingOrder(topology);
+    unsigned threads = order.empty() ? snapshot.cpu.logicalCores : static_cast<unsigned>(order.size());
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    unsigned cores = snapshot.cpu.physicalCores;
+    bool hybrid = false;
+    if (!order.empty()) {
+        std::map<std::pair<CoreType, unsigned>, unsigned> byCore;
+        for (const auto& cpu : order) {
+            ++byCore[{cpu.type, cpu.core}];
+            hybrid = hybrid || cpu.type != order.front().type;
+        }
+        cores = static_cast<unsigned>(byCore.size());
+    }
+    if (cores == 0 || cores > threads) {
+        cores = threads;
+    }
+    const std::vector<unsigned> counts = ScalingThreadCounts(threads, cores);
+    const RepeatOptions allRepeats{kScalingRepeats.warmup, std::max(1, options.repetitions)};
+
+    struct Column {
+        CpuKernel kernel;
+        SimdIsa isa;
+        KernelFn function;
+        std::uint64_t rounds = 0;
+        std::vector<std::vector<double>> rates{};  // per thread count: each timed call's G ops/s
+        std::vector<double> medians{};             // per thread count
+    };
+    const SimdIsa best = DetectSimdIsa();
+    std::vector<Column> columns;
+    for (const CpuKernel kernel : kCpuKernels) {
+        const SimdIsa isa = WidestIsa(kernel, best);
+        columns.push_back({kernel, isa, FindCpuKernel(kernel, isa)});
+    }
+
+    const size_t steps = counts.size() * columns.size();
+    size_t step = 0;
+    double checksum = 0.0;
+    bool pinned = true;
+    for (const unsigned count : counts) {
+        const std::span<const LogicalCpu> pins =
+            order.empty() ? std::span<const LogicalCpu>() : std::span(order.data(), count);
+        const std::string label = "CPU scaling, " + std::to_string(count) + (count == 1 ? " thread: " : " threads: ");
+        for (Column& column : columns) {
+            if (!control.Advance(static_cast<double>(step++) / static_cast<double>(steps),
+                                 label + CpuKernelName(column.kernel))) {
+                return std::nullopt;
+            }
+            if (column.rounds == 0) {
+                column.rounds = CalibrateRounds(column.function, kScalingSeconds);
+            }
+            const WorkerRuns runs = RunWorkers(column.function, column.rounds, count, pins,
+                                               count == counts.back() ? allRepeats : kScalingRepeats);
+            pinned = pinned && runs.pinned;
+            checksum += runs.checksum;
+            column.medians.push_back(SummarizeSamples(runs.rates).median);
+            column.rates.push_back(runs.rates);
+        }
+    }
+    DoNotOptimize(checksum);
+    if (std::any_of(columns.begin(), columns.end(), [](const Column& column) { return column.medians[0] <= 0.0; })) {
+        return std::nullopt;
+    }
+
+    // The geometric mean of the kernels' speedups, so each kernel weighs
+    // the same whatever its rate: of their medians per thread count, and
+    // of each timed call on all threads for the score's samples.
+    BenchmarkCurve speedup{kSpeedupCurve, "threads", "x", {}};
+    BenchmarkCurve efficiency{kEfficiencyCurve, "threads", "%", {}};
+    for (size_t c = 0; c < counts.size(); ++c) {
+        std::vector<double> ratios;
+        for (const Column& column : columns) {
+            ratios.push_back(column.medians[c] / column.medians[0]);
+        }
+        const double mean = GeometricMean(ratios);
+        speedup.points.push_back({static_cast<double>(counts[c]), mean});
+        efficiency.points.push_back({static_cast<double>(counts[c]), mean / counts[c] * 100.0});
+    }
+    std::vector<double> samples;
+    for (int call = 0; call < allRepeats.repetitions; ++call) {
+        std::vector<double> ratios;
+        for (const Column& column : columns) {
+            ratios.push_back(column.rates.back()[static_cast<size_t>(call)] / column.medians[0]);
+        }
+        samples.push_back(GeometricMean(ratios));
+    }
+    const ScoreStats stats = SummarizeSamples(samples);
+    if (stats.median <= 0.0) {
+        return std::nullopt;
+    }
+
+    const char* pinning = order.empty() ? "" : pinned ? ", pinned one per core first" : ", pinning refused";
+    std::string details = "Threads: " + std::to_string(threads) + " on " + std::to_string(cores) +
+                          (cores == 1 ? " core" : " cores") + pinning +
+                          "\nSpeedup over 1 thread (geometric mean of the kernels), efficiency:";
+    for (size_t c = 0; c < counts.size(); ++c) {
+        details += "\n" + std::to_string(counts[c]) + ": " + FormatRate(speedup.points[c].y) + "x, " +
+                   FormatRate(efficiency.points[c].y) + "%";
+    }
+    details += "\nSpeedup on all threads: " + FormatStats(stats);
+
+    BenchmarkResultData result = MakeResult(stats.median, "x", "");
+    std::vector<CurvePoint> perCore;
+    for (const CurvePoint& point : speedup.points) {
+        if (point.x <= cores) {
+            perCore.push_back(point);
+        }
+    }
+    if (cores > 1) {
+        const double serial = FitSerialFraction(perCore);
+        details += "\nSerial fraction (Amdahl fit, 1-" + std::to_string(cores) + " threads): " + FormatPercent(serial) +
+                   (hybrid ? " (counting the slower cores' shortfall as serial work)" : "");
+        BenchmarkCurve amdahl{kAmdahlCurve, "threads", "x", {}};
+        for (const CurvePoint& point : perCore) {
+            amdahl.points.push_back({point.x, 1.0 / (serial + (1.0 - serial) / point.x)});
+        }
+        result.curves.push_back(std::move(amdahl));
+        result.curves.push_back({kSerialFractionCurve, "threads", "%", {{static_cast<double>(cores), serial * 100.0}}});
+    }
+    const size_t oneEach = static_cast<size_t>(
+        std::find(counts.begin(), counts.end(), cores) - counts.begin());  // one thread per core
+    if (cores < threads) {
+        const double yield = speedup.points.back().y / speedup.points[oneEach].y - 1.0;
+        details += "\nSMT yield: " + FormatChange(yield) + " on all " + std::to_string(threads) +
+                   " threads over one per core";
+        result.curves.push_back({kSmtYieldCurve, "threads", "%", {{static_cast<double>(cores), yield * 100.0}}});
+    }
+
+    details += "\nG ops/s by thread count:";
+    for (const Column& column : columns) {
+        details += std::string("\n") + CpuKernelName(column.kernel) + " (" + SimdIsaName(column.isa) + "):";
+        BenchmarkCurve curve{CpuKernelName(column.kernel), "threads", "G ops/s", {}};
+        for (size_t c = 0; c < counts.size(); ++c) {
+            details += (c == 0 ? " " : ", ") + std::to_string(counts[c]) + ": " + FormatRate(column.medians[c]);
+            curve.points.push_back({static_cast<double>(counts[c]), column.medians[c]});
+        }
+        if (cores < threads && column.medians[oneEach] > 0.0) {
+            details += "; SMT " + FormatChange(column.medians.back() / column.medians[oneEach] - 1.0);
+        }
+        result.kernels.push_back({CpuKernelName(column.kernel), SimdIsaName(column.isa), column.medians.back()});
+        result.curves.push_back(std::move(curve));
+    }
+    result.details = std::move(details);
+    result.samples = std::move(samples);
+    result.stats = stats;
+    result.curves.insert(result.curves.begin(), {std::move(speedup), std::move(efficiency)});
+    return result;
+}
+
+// Finds where the target's limits should flatten the speedup curve: at
+// maxThreads, or maxCores times the threads per core the run found.
+std::string CompareScaling(const BenchmarkResultData& scaling, int maxCores, int maxThreads) {
+    const auto find = [&](std::string_view name) -> const BenchmarkCurve* {
+        for (const BenchmarkCurve& curve : scaling.curves) {
+            if (curve.name == name && !curve.points.empty()) {
+                return &curve;
+            }
+        }
+        return nullptr;
+    };
+    const BenchmarkCurve* speedup = find(kSpeedupCurve);
+    if (!speedup) {
+        return {};
+    }
+    const CurvePoint& all = speedup->points.back();
+    const BenchmarkCurve* serial = find(kSerialFractionCurve);
+    const double cores = serial ? serial->points.front().x : all.x;
+    double allowed = all.x;
+    if (maxCores > 0) {
+        allowed = std::min(allowed, std::floor(maxCores * all.x / std::max(cores, 1.0)));
+    }
+    if (maxThreads > 0) {
+        allowed = std::min(allowed, static_cast<double>(maxThreads));
+    }
+    if (allowed >= all.x) {
+        return {};
+    }
+    const CurvePoint* within = &speedup->points.front();  // the most threads measured within the limits
+    for (const CurvePoint& point : speedup->points) {
+        if (point.x <= allowed) {
+            within = &point;
+        }
+    }
+    const double gain = all.y / std::max(within->y, 1e-9) - 1.0;
+    std::string limits;
+    if (maxCores > 0) {
+        limits = std::to_string(maxCores) + (maxCores == 1 ? " core" : " cores");
+    }
+    if (maxThreads > 0) {
+        limits += (limits.empty() ? "" : ", ") + std::to_string(maxThreads);
+        limits += maxThreads == 1 ? " thread" : " threads";
+    }
+    const auto count = [](double threads) { return std::to_string(std::lround(threads)); };
+    return "Target allows " + limits + " (" + count(allowed) + " of " + count(all.x) + " threads): speedup " +
+           FormatRate(within->y) + "x at " + count(within->x) + ", " + FormatRate(all.y) + "x at " + count(all.x) +
+           (gain <= kScalingFlat ? "; flat past the limit, as on the SKU it mimics"
+                                 : "; still " + FormatPercent(gain) + " higher past the limit, so it is not in effect");
+}
+
+std::optional<BenchmarkResultData> BenchmarkRunner::RunGpuBenchmark(const HardwareSnapshot& snapshot,
+                                                                    const BenchmarkOptions& options,
+                                                                    BenchmarkControl& control) const {
 #ifdef _WIN32
     using Microsoft::WRL::ComPtr;
-    if (snapshot.gpus.empty()) {
+    if (snapshot.gpus.empty() || !control.Advance(0.0, "GPU compute")) {
         return std::nullopt;
     }
 
@@ -194,58 +1025,76 @@ void main(uint3 tid : SV_DispatchThreadID) {
         return std::nullopt;
     }
 
+    // A timestamp pair around each call's batch of dispatches, all inside
+    // one disjoint query; the first `warmup` batches are not scored.
     D3D11_QUERY_DESC timestampDesc{};
     timestampDesc.Query = D3D11_QUERY_TIMESTAMP;
-    ComPtr<ID3D11Query> startQuery;
-    ComPtr<ID3D11Query> endQuery;
-    device->CreateQuery(&timestampDesc, &startQuery);
-    device->CreateQuery(&timestampDesc, &endQuery);
+    const int calls = kHeadlineWarmup + std::max(1, options.repetitions);
+    std::vector<ComPtr<ID3D11Query>> startQueries(calls);
+    std::vector<ComPtr<ID3D11Query>> endQueries(calls);
+    for (int call = 0; call < calls; ++call) {
+        if (FAILED(device->CreateQuery(&timestampDesc, &startQueries[call])) ||
+            FAILED(device->CreateQuery(&timestampDesc, &endQueries[call]))) {
+            return std::nullopt;
+        }
+    }
 
-    const UINT dispatchCount = 2048;
+    const UINT dispatchCount = 256;  // per call
     context->Begin(disjoint.Get());
-    context->End(startQuery.Get());
-    for (UINT i = 0; i < dispatchCount; ++i) {
-        context->Dispatch(elements / 256, 1, 1);
+    for (int call = 0; call < calls; ++call) {
+        context->End(startQueries[call].Get());
+        for (UINT i = 0; i < dispatchCount; ++i) {
+            context->Dispatch(elements / 256, 1, 1);
+        }
+        context->End(endQueries[call].Get());
     }
-    context->End(endQuery.Get());
     context->End(disjoint.Get());
     context->Flush();
 
+    const auto readQuery = [&](ID3D11Query* query, auto& value) {
+        while (context->GetData(query, &value, sizeof(value), 0) == S_FALSE) {
+            Sleep(0);
+        }
+    };
     D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData{};
-    while (context->GetData(disjoint.Get(), &disjointData, sizeof(disjointData), 0) == S_FALSE) {
-        Sleep(0);
-    }
-    UINT64 startTime = 0;
-    while (context->GetData(startQuery.Get(), &startTime, sizeof(startTime), 0) == S_FALSE) {
-        Sleep(0);
-    }
-    UINT64 endTime = 0;
-    while (context->GetData(endQuery.Get(), &endTime, sizeof(endTime), 0) == S_FALSE) {
-        Sleep(0);
-    }
+    readQuery(disjoint.Get(), disjointData);
     if (disjointData.Disjoint || disjointData.Frequency == 0) {
         return std::nullopt;
     }
-    const double gpuTimeSec = static_cast<double>(endTime - startTime) / static_cast<double>(disjointData.Frequency);
-    if (gpuTimeSec <= 0.0) {
-        return std::nullopt;
-    }
-
     const double operations = static_cast<double>(dispatchCount) *
                               static_cast<double>(elements) *
                               4096.0 * 2.0;
-    const double gflops = operations / gpuTimeSec / 1e9;
-    std::string details = "Dispatches: " + std::to_string(dispatchCount) +
+    std::vector<double> samples;
+    for (int call = kHeadlineWarmup; call < calls; ++call) {
+        UINT64 startTime = 0;
+        UINT64 endTime = 0;
+        readQuery(startQueries[call].Get(), startTime);
+        readQuery(endQueries[call].Get(), endTime);
+        const double gpuTimeSec =
+            static_cast<double>(endTime - startTime) / static_cast<double>(disjointData.Frequency);
+        if (gpuTimeSec <= 0.0) {
+            return std::nullopt;
+        }
+        samples.push_back(operations / gpuTimeSec / 1e9);
+    }
+    const ScoreStats stats = SummarizeSamples(samples);
+    std::string details = "Dispatches: " + std::to_string(dispatchCount) + " per run" +
                           ", elements: " + std::to_string(elements) +
-                          ", time: " + std::to_string(gpuTimeSec) + "s";
+                          "\nGFLOPS: " + FormatStats(stats) + " after " + std::to_string(kHeadlineWarmup) +
+                          " warmup";
 
     ID3D11UnorderedAccessView* nullUAV[] = {nullptr};
     context->CSSetUnorderedAccessViews(0, 1, nullUAV, nullptr);
     context->CSSetShader(nullptr, nullptr, 0);
 
-    return MakeResult(gflops, "GFLOPS", details);
+    BenchmarkResultData result = MakeResult(stats.median, "GFLOPS", details);
+    result.samples = std::move(samples);
+    result.stats = stats;
+    return result;
 #else
     (void)snapshot;
+    (void)options;
+    (void)control;
     return std::nullopt;
 #endif
 }
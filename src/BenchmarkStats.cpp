@@ -0,0 +1,139 @@
+#include "BenchmarkStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+namespace {
+
+constexpr double kMadToSigma = 1.4826;  // MAD of a normal distribution times this is its sigma
+constexpr double kOutlierScore = 3.5;
+constexpr double kZ95 = 1.959964;
+
+double MedianAbsoluteDeviation(const std::vector<double>& values, double median) {
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (const double value : values) {
+        deviations.push_back(std::abs(value - median));
+    }
+    return Median(std::move(deviations));
+}
+
+}  // namespace
+
+#ifdef _MSC_VER
+void UseCharPointer(const volatile char*) {}
+#endif
+
+double Median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    const double upper = values[middle];
+    if (values.size() % 2 != 0) {
+        return upper;
+    }
+    return (*std::max_element(values.begin(), values.begin() + middle) + upper) / 2.0;
+}
+
+std::vector<double> RejectOutliers(std::span<const double> samples) {
+    std::vector<double> values(samples.begin(), samples.end());
+    const double median = Median(values);
+    const double spread = kMadToSigma * MedianAbsoluteDeviation(values, median);
+    if (spread <= 0.0) {
+        return values;  // at least half the samples are identical; nothing to measure against
+    }
+    std::erase_if(values, [&](double value) { return std::abs(value - median) / spread > kOutlierScore; });
+    return values;
+}
+
+ScoreStats SummarizeSamples(std::span<const double> samples) {
+    ScoreStats stats;
+    std::vector<double> kept = RejectOutliers(samples);
+    stats.samples = kept.size();
+    stats.outliers = samples.size() - kept.size();
+    if (kept.empty()) {
+        return stats;
+    }
+    std::sort(kept.begin(), kept.end());
+    stats.median = Median(kept);
+    stats.mad = MedianAbsoluteDeviation(kept, stats.median);
+    // The median lies between the order statistics of 1-based rank
+    // n/2 - z sqrt(n)/2 and 1 + n/2 + z sqrt(n)/2 with 95% probability,
+    // whatever the distribution (binomial, normal approximation).
+    const double n = static_cast<double>(kept.size());
+    const double half = kZ95 * std::sqrt(n) / 2.0;
+    const auto lower = static_cast<size_t>(std::clamp(std::floor(n / 2.0 - half) - 1.0, 0.0, n - 1.0));
+    const auto upper = static_cast<size_t>(std::clamp(std::ceil(n / 2.0 + half), 0.0, n - 1.0));
+    stats.ciLow = kept[lower];
+    stats.ciHigh = kept[upper];
+    return stats;
+}
+
+std::string FormatStats(const ScoreStats& stats) {
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "median %.2f, MAD %.2f, 95%% CI %.2f-%.2f, %zu runs", stats.median,
+                  stats.mad, stats.ciLow, stats.ciHigh, stats.samples);
+    std::string text = buffer;
+    if (stats.outliers > 0) {
+        text += " (" + std::to_string(stats.outliers) + (stats.outliers == 1 ? " outlier" : " outliers") +
+                " dropped)";
+    }
+    return text;
+}
+
+SampleComparison CompareSamples(std::span<const double> baseline, std::span<const double> current, double alpha) {
+    SampleComparison result;
+    const std::vector<double> before = RejectOutliers(baseline);
+    const std::vector<double> after = RejectOutliers(current);
+    if (before.size() < kMinCompareSamples || after.size() < kMinCompareSamples) {
+        return result;
+    }
+    result.enoughSamples = true;
+    const double baseMedian = Median(before);
+    result.change = baseMedian != 0.0 ? Median(after) / baseMedian - 1.0 : 0.0;
+
+    // Rank both samples together, ties sharing their mean rank.
+    std::vector<std::pair<double, bool>> pooled;  // value, from the baseline
+    for (const double value : before) {
+        pooled.emplace_back(value, true);
+    }
+    for (const double value : after) {
+        pooled.emplace_back(value, false);
+    }
+    std::sort(pooled.begin(), pooled.end());
+    const double n1 = static_cast<double>(before.size());
+    const double n2 = static_cast<double>(after.size());
+    const double total = n1 + n2;
+    double baselineRanks = 0.0;
+    double ties = 0.0;  // sum of t^3 - t over groups of t tied values
+    for (size_t first = 0; first < pooled.size();) {
+        size_t last = first;
+        while (last < pooled.size() && pooled[last].first == pooled[first].first) {
+            ++last;
+        }
+        const double rank = (static_cast<double>(first + last) + 1.0) / 2.0;  // 1-based mean
+        for (size_t i = first; i < last; ++i) {
+            if (pooled[i].second) {
+                baselineRanks += rank;
+            }
+        }
+        const double t = static_cast<double>(last - first);
+        ties += t * t * t - t;
+        first = last;
+    }
+
+    const double u = baselineRanks - n1 * (n1 + 1.0) / 2.0;
+    const double mean = n1 * n2 / 2.0;
+    const double variance = n1 * n2 / 12.0 * ((total + 1.0) - ties / (total * (total - 1.0)));
+    if (variance <= 0.0) {
+        return result;  // every value equal
+    }
+    const double z = std::max(0.0, std::abs(u - mean) - 0.5) / std::sqrt(variance);  // continuity-corrected
+    result.pValue = std::erfc(z / std::sqrt(2.0));
+    result.significant = result.pValue < alpha;
+    return result;
+}
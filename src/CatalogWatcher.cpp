@@ -0,0 +1,87 @@
+#include "CatalogWatcher.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+CatalogWatcher::CatalogWatcher(const std::filesystem::path& catalogPath) {
+    std::filesystem::path binaryPath = catalogPath;
+    binaryPath.replace_extension(".bin");
+    jsonName_ = catalogPath.filename().string();
+    binaryName_ = binaryPath.filename().string();
+    std::filesystem::path directory = catalogPath.parent_path();
+    if (directory.empty()) {
+        directory = ".";
+    }
+
+#ifdef _WIN32
+    HANDLE handle = FindFirstChangeNotificationW(directory.c_str(), FALSE,
+                                                 FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE);
+    if (handle != INVALID_HANDLE_VALUE) {
+        handle_ = reinterpret_cast<std::intptr_t>(handle);
+    }
+#elif defined(__linux__)
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE) < 0) {
+        ::close(fd);
+        return;
+    }
+    handle_ = fd;
+#else
+    (void)directory;
+#endif
+}
+
+CatalogWatcher::~CatalogWatcher() {
+    if (!IsActive()) {
+        return;
+    }
+#ifdef _WIN32
+    FindCloseChangeNotification(reinterpret_cast<HANDLE>(handle_));
+#elif defined(__linux__)
+    ::close(static_cast<int>(handle_));
+#endif
+}
+
+bool CatalogWatcher::ConsumeChanges() {
+    if (!IsActive()) {
+        return false;
+    }
+#ifdef _WIN32
+    // Re-arms the handle; the caller re-reads and diffs the catalog anyway.
+    FindNextChangeNotification(reinterpret_cast<HANDLE>(handle_));
+    return true;
+#elif defined(__linux__)
+    bool relevant = false;
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        const ssize_t length = ::read(static_cast<int>(handle_), buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;  // EAGAIN once drained
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            inotify_event event;
+            std::memcpy(&event, buffer + offset, sizeof(event));
+            if ((event.mask & IN_Q_OVERFLOW) != 0) {
+                relevant = true;
+            } else if (event.len > 0) {
+                const char* name = buffer + offset + sizeof(inotify_event);
+                relevant = relevant || jsonName_ == name || binaryName_ == name;
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event.len);
+        }
+    }
+    return relevant;
+#else
+    return false;
+#endif
+}
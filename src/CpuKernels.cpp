@@ -0,0 +1,145 @@
+#include "CpuKernels.hpp"
+
+#include "CpuKernelTemplates.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#define HWL_X86_CPUID 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define HWL_X86_CPUID 1
+#endif
+
+namespace {
+
+#ifdef HWL_X86_CPUID
+
+struct CpuidRegisters {
+    unsigned eax = 0;
+    unsigned ebx = 0;
+    unsigned ecx = 0;
+    unsigned edx = 0;
+};
+
+CpuidRegisters Cpuid(unsigned leaf, unsigned subleaf) {
+    CpuidRegisters registers;
+#ifdef _MSC_VER
+    int values[4] = {0};
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    registers = {static_cast<unsigned>(values[0]), static_cast<unsigned>(values[1]), static_cast<unsigned>(values[2]),
+                 static_cast<unsigned>(values[3])};
+#else
+    __cpuid_count(leaf, subleaf, registers.eax, registers.ebx, registers.ecx, registers.edx);
+#endif
+    return registers;
+}
+
+// XCR0: which register files the OS saves on a context switch.
+std::uint64_t EnabledRegisterState() {
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned low = 0;
+    unsigned high = 0;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return (static_cast<std::uint64_t>(high) << 32) | low;
+#endif
+}
+
+constexpr unsigned Bit(unsigned index) {
+    return 1u << index;
+}
+
+SimdIsa QuerySimdIsa() {
+    const unsigned maxLeaf = Cpuid(0, 0).eax;
+    if (maxLeaf < 1) {
+        return SimdIsa::Scalar;
+    }
+    const CpuidRegisters features = Cpuid(1, 0);
+    if ((features.ecx & Bit(20)) == 0) {
+        return SimdIsa::Scalar;
+    }
+    // AVX state is only usable once the OS enabled XSAVE and saves YMM.
+    constexpr std::uint64_t kYmmState = 0x6;   // SSE + AVX
+    constexpr std::uint64_t kZmmState = 0xE6;  // plus opmask and both ZMM halves
+    const bool osSaves = (features.ecx & Bit(27)) != 0;
+    const std::uint64_t state = osSaves ? EnabledRegisterState() : 0;
+    const bool avx = (features.ecx & Bit(28)) != 0 && (state & kYmmState) == kYmmState;
+    const bool fma = (features.ecx & Bit(12)) != 0;
+    const CpuidRegisters extended = maxLeaf >= 7 ? Cpuid(7, 0) : CpuidRegisters{};
+    if (!avx || !fma || (extended.ebx & Bit(5)) == 0) {
+        return SimdIsa::Sse42;
+    }
+    if ((extended.ebx & Bit(16)) == 0 || (state & kZmmState) != kZmmState) {
+        return SimdIsa::Avx2;
+    }
+    return SimdIsa::Avx512;
+}
+
+#endif
+
+const CpuKernelTable& KernelTable(SimdIsa isa) {
+    static const CpuKernelTable scalar = ScalarCpuKernels();
+    static const CpuKernelTable sse42 = Sse42CpuKernels();
+    static const CpuKernelTable avx2 = Avx2CpuKernels();
+    static const CpuKernelTable avx512 = Avx512CpuKernels();
+    switch (isa) {
+        case SimdIsa::Sse42:
+            return sse42;
+        case SimdIsa::Avx2:
+            return avx2;
+        case SimdIsa::Avx512:
+            return avx512;
+        case SimdIsa::Scalar:
+            break;
+    }
+    return scalar;
+}
+
+}  // namespace
+
+const char* SimdIsaName(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::Scalar:
+            return "scalar";
+        case SimdIsa::Sse42:
+            return "SSE4.2";
+        case SimdIsa::Avx2:
+            return "AVX2";
+        case SimdIsa::Avx512:
+            return "AVX-512";
+    }
+    return "unknown";
+}
+
+const char* CpuKernelName(CpuKernel kernel) {
+    switch (kernel) {
+        case CpuKernel::FmaF32:
+            return "fma.f32";
+        case CpuKernel::FmaF64:
+            return "fma.f64";
+        case CpuKernel::DotF32:
+            return "dot.f32";
+        case CpuKernel::DotF64:
+            return "dot.f64";
+        case CpuKernel::AluI32:
+            return "alu.i32";
+        case CpuKernel::AluI64:
+            return "alu.i64";
+    }
+    return "unknown";
+}
+
+SimdIsa DetectSimdIsa() {
+#ifdef HWL_X86_CPUID
+    static const SimdIsa detected = QuerySimdIsa();
+    return detected;
+#else
+    return SimdIsa::Scalar;
+#endif
+}
+
+KernelFn FindCpuKernel(CpuKernel kernel, SimdIsa isa) {
+    return KernelTable(isa).kernels[static_cast<size_t>(kernel)];
+}
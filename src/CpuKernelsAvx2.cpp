@@ -0,0 +1,71 @@
+// 256-bit vectors with FMA3 (Haswell / Zen and later).
+#include "CpuKernelTemplates.hpp"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+
+namespace {
+
+struct Avx2F32 {
+    using Scalar = float;
+    using Vec = __m256;
+    static constexpr int kLanes = 8;
+
+    static Vec Set1(float value) { return _mm256_set1_ps(value); }
+    static Vec Load(const float* source) { return _mm256_loadu_ps(source); }
+    static void Store(float* target, Vec value) { _mm256_storeu_ps(target, value); }
+    static Vec MulAdd(Vec a, Vec b, Vec c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+struct Avx2F64 {
+    using Scalar = double;
+    using Vec = __m256d;
+    static constexpr int kLanes = 4;
+
+    static Vec Set1(double value) { return _mm256_set1_pd(value); }
+    static Vec Load(const double* source) { return _mm256_loadu_pd(source); }
+    static void Store(double* target, Vec value) { _mm256_storeu_pd(target, value); }
+    static Vec MulAdd(Vec a, Vec b, Vec c) { return _mm256_fmadd_pd(a, b, c); }
+};
+
+struct Avx2I32 {
+    using Scalar = std::uint32_t;
+    using Vec = __m256i;
+    static constexpr int kLanes = 8;
+
+    static Vec Set1(std::uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+    static void Store(std::uint32_t* target, Vec value) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), value);
+    }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_epi32(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+    static Vec ShiftRight(Vec value) { return _mm256_srli_epi32(value, kAluShift); }
+};
+
+struct Avx2I64 {
+    using Scalar = std::uint64_t;
+    using Vec = __m256i;
+    static constexpr int kLanes = 4;
+
+    static Vec Set1(std::uint64_t value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+    static void Store(std::uint64_t* target, Vec value) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), value);
+    }
+    static Vec Add(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm256_xor_si256(a, b); }
+    static Vec ShiftRight(Vec value) { return _mm256_srli_epi64(value, kAluShift); }
+};
+
+}  // namespace
+
+CpuKernelTable Avx2CpuKernels() {
+    return MakeCpuKernelTable<Avx2F32, Avx2F64, Avx2I32, Avx2I64>();
+}
+
+#else
+
+CpuKernelTable Avx2CpuKernels() {
+    return {};
+}
+
+#endif
@@ -0,0 +1,69 @@
+// 512-bit vectors; everything here is in the AVX-512 Foundation subset.
+#include "CpuKernelTemplates.hpp"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+namespace {
+
+struct Avx512F32 {
+    using Scalar = float;
+    using Vec = __m512;
+    static constexpr int kLanes = 16;
+
+    static Vec Set1(float value) { return _mm512_set1_ps(value); }
+    static Vec Load(const float* source) { return _mm512_loadu_ps(source); }
+    static void Store(float* target, Vec value) { _mm512_storeu_ps(target, value); }
+    static Vec MulAdd(Vec a, Vec b, Vec c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+struct Avx512F64 {
+    using Scalar = double;
+    using Vec = __m512d;
+    static constexpr int kLanes = 8;
+
+    static Vec Set1(double value) { return _mm512_set1_pd(value); }
+    static Vec Load(const double* source) { return _mm512_loadu_pd(source); }
+    static void Store(double* target, Vec value) { _mm512_storeu_pd(target, value); }
+    static Vec MulAdd(Vec a, Vec b, Vec c) { return _mm512_fmadd_pd(a, b, c); }
+};
+
+struct Avx512I32 {
+    using Scalar = std::uint32_t;
+    using Vec = __m512i;
+    static constexpr int kLanes = 16;
+
+    static Vec Set1(std::uint32_t value) { return _mm512_set1_epi32(static_cast<int>(value)); }
+    static void Store(std::uint32_t* target, Vec value) { _mm512_storeu_si512(target, value); }
+    static Vec Add(Vec a, Vec b) { return _mm512_add_epi32(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm512_xor_si512(a, b); }
+    // The all-lanes zero-masking form; the plain one trips GCC 12's
+    // -Wmaybe-uninitialized in its own header. Codegen is the same.
+    static Vec ShiftRight(Vec value) { return _mm512_maskz_srli_epi32(0xFFFF, value, kAluShift); }
+};
+
+struct Avx512I64 {
+    using Scalar = std::uint64_t;
+    using Vec = __m512i;
+    static constexpr int kLanes = 8;
+
+    static Vec Set1(std::uint64_t value) { return _mm512_set1_epi64(static_cast<long long>(value)); }
+    static void Store(std::uint64_t* target, Vec value) { _mm512_storeu_si512(target, value); }
+    static Vec Add(Vec a, Vec b) { return _mm512_add_epi64(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm512_xor_si512(a, b); }
+    static Vec ShiftRight(Vec value) { return _mm512_maskz_srli_epi64(0xFF, value, kAluShift); }
+};
+
+}  // namespace
+
+CpuKernelTable Avx512CpuKernels() {
+    return MakeCpuKernelTable<Avx512F32, Avx512F64, Avx512I32, Avx512I64>();
+}
+
+#else
+
+CpuKernelTable Avx512CpuKernels() {
+    return {};
+}
+
+#endif
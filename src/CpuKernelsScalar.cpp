@@ -0,0 +1,27 @@
+// Built without auto-vectorization (see CMakeLists.txt), so these are the
+// one-lane baselines the vector levels are compared against.
+#include "CpuKernelTemplates.hpp"
+
+namespace {
+
+template <typename T>
+struct ScalarOps {
+    using Scalar = T;
+    using Vec = T;
+    static constexpr int kLanes = 1;
+
+    static Vec Set1(T value) { return value; }
+    static Vec Load(const T* source) { return *source; }
+    static void Store(T* target, Vec value) { *target = value; }
+    static Vec MulAdd(Vec a, Vec b, Vec c) { return a * b + c; }
+    static Vec Add(Vec a, Vec b) { return a + b; }
+    static Vec Xor(Vec a, Vec b) { return a ^ b; }
+    static Vec ShiftRight(Vec value) { return value >> kAluShift; }
+};
+
+}  // namespace
+
+CpuKernelTable ScalarCpuKernels() {
+    return MakeCpuKernelTable<ScalarOps<float>, ScalarOps<double>, ScalarOps<std::uint32_t>,
+                              ScalarOps<std::uint64_t>>();
+}
@@ -0,0 +1,67 @@
+// 128-bit vectors; SSE has no fused multiply-add, so MulAdd is two ops.
+#include "CpuKernelTemplates.hpp"
+
+#if defined(__SSE4_2__) || defined(_M_X64)
+#include <immintrin.h>
+
+namespace {
+
+struct Sse42F32 {
+    using Scalar = float;
+    using Vec = __m128;
+    static constexpr int kLanes = 4;
+
+    static Vec Set1(float value) { return _mm_set1_ps(value); }
+    static Vec Load(const float* source) { return _mm_loadu_ps(source); }
+    static void Store(float* target, Vec value) { _mm_storeu_ps(target, value); }
+    static Vec MulAdd(Vec a, Vec b, Vec c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+};
+
+struct Sse42F64 {
+    using Scalar = double;
+    using Vec = __m128d;
+    static constexpr int kLanes = 2;
+
+    static Vec Set1(double value) { return _mm_set1_pd(value); }
+    static Vec Load(const double* source) { return _mm_loadu_pd(source); }
+    static void Store(double* target, Vec value) { _mm_storeu_pd(target, value); }
+    static Vec MulAdd(Vec a, Vec b, Vec c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+};
+
+struct Sse42I32 {
+    using Scalar = std::uint32_t;
+    using Vec = __m128i;
+    static constexpr int kLanes = 4;
+
+    static Vec Set1(std::uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); }
+    static void Store(std::uint32_t* target, Vec value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(target), value); }
+    static Vec Add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+    static Vec ShiftRight(Vec value) { return _mm_srli_epi32(value, kAluShift); }
+};
+
+struct Sse42I64 {
+    using Scalar = std::uint64_t;
+    using Vec = __m128i;
+    static constexpr int kLanes = 2;
+
+    static Vec Set1(std::uint64_t value) { return _mm_set1_epi64x(static_cast<long long>(value)); }
+    static void Store(std::uint64_t* target, Vec value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(target), value); }
+    static Vec Add(Vec a, Vec b) { return _mm_add_epi64(a, b); }
+    static Vec Xor(Vec a, Vec b) { return _mm_xor_si128(a, b); }
+    static Vec ShiftRight(Vec value) { return _mm_srli_epi64(value, kAluShift); }
+};
+
+}  // namespace
+
+CpuKernelTable Sse42CpuKernels() {
+    return MakeCpuKernelTable<Sse42F32, Sse42F64, Sse42I32, Sse42I64>();
+}
+
+#else
+
+CpuKernelTable Sse42CpuKernels() {
+    return {};
+}
+
+#endif
@@ -0,0 +1,272 @@
+#include "CpuTopology.hpp"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+#include <bit>
+#include <memory>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+
+constexpr unsigned kGroupSize = 64;  // logical processors per processor group
+
+std::vector<LogicalCpu> QueryTopologyWindows() {
+    std::vector<LogicalCpu> cpus;
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &bufferSize);
+    std::unique_ptr<BYTE[]> buffer(new BYTE[bufferSize]);
+    if (!GetLogicalProcessorInformationEx(RelationProcessorCore,
+                                          reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.get()),
+                                          &bufferSize)) {
+        return cpus;
+    }
+    // Efficiency classes rank the cores; the highest is the fastest.
+    std::vector<BYTE> classes;
+    unsigned core = 0;
+    for (BYTE* ptr = buffer.get(); ptr < buffer.get() + bufferSize;) {
+        auto entry = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(ptr);
+        if (entry->Relationship == RelationProcessorCore) {
+            for (WORD group = 0; group < entry->Processor.GroupCount; ++group) {
+                const GROUP_AFFINITY& affinity = entry->Processor.GroupMask[group];
+                for (unsigned bit = 0; bit < kGroupSize; ++bit) {
+                    if ((affinity.Mask >> bit) & 1) {
+                        cpus.push_back({affinity.Group * kGroupSize + bit, core, CoreType::Uniform});
+                        classes.push_back(entry->Processor.EfficiencyClass);
+                    }
+                }
+            }
+            ++core;
+        }
+        ptr += entry->Size;
+    }
+    const auto [lowest, highest] = std::minmax_element(classes.begin(), classes.end());
+    if (!classes.empty() && *lowest != *highest) {
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            cpus[i].type = classes[i] == *highest ? CoreType::Performance : CoreType::Efficiency;
+        }
+    }
+    std::sort(cpus.begin(), cpus.end(), [](const LogicalCpu& a, const LogicalCpu& b) { return a.index < b.index; });
+    return cpus;
+}
+
+std::vector<CacheLevel> QueryCachesWindows() {
+    std::vector<CacheLevel> caches;
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformationEx(RelationCache, nullptr, &bufferSize);
+    std::unique_ptr<BYTE[]> buffer(new BYTE[bufferSize]);
+    if (!GetLogicalProcessorInformationEx(RelationCache,
+                                          reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.get()),
+                                          &bufferSize)) {
+        return caches;
+    }
+    for (BYTE* ptr = buffer.get(); ptr < buffer.get() + bufferSize;) {
+        auto entry = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(ptr);
+        const CACHE_RELATIONSHIP& cache = entry->Cache;
+        // Only the instances serving logical processor 0 of group 0.
+        if (entry->Relationship == RelationCache && (cache.Type == CacheData || cache.Type == CacheUnified) &&
+            cache.GroupMask.Group == 0 && (cache.GroupMask.Mask & 1) != 0) {
+            const auto sharedBy = static_cast<unsigned>(std::popcount(cache.GroupMask.Mask));
+            caches.push_back({cache.Level, cache.CacheSize, sharedBy});
+        }
+        ptr += entry->Size;
+    }
+    return caches;
+}
+
+#elif defined(__linux__)
+
+// A sysfs CPU list such as "0-7,16-23"; empty when the file is missing.
+std::set<unsigned> ReadCpuList(const std::filesystem::path& path) {
+    std::set<unsigned> cpus;
+    std::ifstream file(path);
+    std::string list;
+    if (!(file >> list)) {
+        return cpus;
+    }
+    for (size_t start = 0; start < list.size();) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        const std::string range = list.substr(start, end - start);
+        const size_t dash = range.find('-');
+        const auto first = static_cast<unsigned>(std::strtoul(range.c_str(), nullptr, 10));
+        auto last = first;
+        if (dash != std::string::npos) {
+            last = static_cast<unsigned>(std::strtoul(range.c_str() + dash + 1, nullptr, 10));
+        }
+        for (unsigned cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+        start = end + 1;
+    }
+    return cpus;
+}
+
+long ReadSysfsNumber(const std::filesystem::path& path, long fallback) {
+    std::ifstream file(path);
+    long value = fallback;
+    file >> value;
+    return file ? value : fallback;
+}
+
+std::vector<LogicalCpu> QueryTopologyLinux() {
+    const std::filesystem::path root = "/sys/devices/system/cpu";
+    std::vector<LogicalCpu> cpus;
+    std::map<std::pair<long, long>, unsigned> cores;  // (package, core id) -> dense core number
+    std::vector<long> capacities;
+    for (const unsigned index : ReadCpuList(root / "online")) {
+        const std::filesystem::path topology = root / ("cpu" + std::to_string(index)) / "topology";
+        const std::pair<long, long> key{ReadSysfsNumber(topology / "physical_package_id", 0),
+                                        ReadSysfsNumber(topology / "core_id", index)};
+        const auto core = cores.try_emplace(key, static_cast<unsigned>(cores.size())).first->second;
+        cpus.push_back({index, core, CoreType::Uniform});
+        capacities.push_back(ReadSysfsNumber(root / ("cpu" + std::to_string(index)) / "cpu_capacity", 0));
+    }
+
+    // Intel hybrid parts expose one PMU per core type; Arm big.LITTLE
+    // gives each CPU a relative capacity instead.
+    const std::set<unsigned> big = ReadCpuList("/sys/devices/cpu_core/cpus");
+    const std::set<unsigned> little = ReadCpuList("/sys/devices/cpu_atom/cpus");
+    const auto [lowest, highest] = std::minmax_element(capacities.begin(), capacities.end());
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        if (!big.empty() && !little.empty()) {
+            cpus[i].type = big.count(cpus[i].index) != 0 ? CoreType::Performance : CoreType::Efficiency;
+        } else if (!capacities.empty() && *lowest != *highest) {
+            cpus[i].type = capacities[i] == *highest ? CoreType::Performance : CoreType::Efficiency;
+        }
+    }
+    return cpus;
+}
+
+// "48K", "2048K" or "32M".
+std::uint64_t ParseCacheSize(const std::string& text) {
+    char* suffix = nullptr;
+    std::uint64_t bytes = std::strtoull(text.c_str(), &suffix, 10);
+    if (*suffix == 'K') {
+        bytes <<= 10;
+    } else if (*suffix == 'M') {
+        bytes <<= 20;
+    } else if (*suffix == 'G') {
+        bytes <<= 30;
+    }
+    return bytes;
+}
+
+std::vector<CacheLevel> QueryCachesLinux() {
+    std::vector<CacheLevel> caches;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/cpu/cpu0/cache", error)) {
+        std::ifstream typeFile(entry.path() / "type");
+        std::ifstream sizeFile(entry.path() / "size");
+        std::string type;
+        std::string size;
+        if (!(typeFile >> type) || !(sizeFile >> size) || (type != "Data" && type != "Unified")) {
+            continue;
+        }
+        CacheLevel cache;
+        cache.level = static_cast<unsigned>(ReadSysfsNumber(entry.path() / "level", 0));
+        cache.bytes = ParseCacheSize(size);
+        cache.sharedBy =
+            std::max<unsigned>(1, static_cast<unsigned>(ReadCpuList(entry.path() / "shared_cpu_list").size()));
+        if (cache.level > 0 && cache.bytes > 0) {
+            caches.push_back(cache);
+        }
+    }
+    return caches;
+}
+
+#elif defined(__APPLE__)
+
+// On Apple silicon these describe the performance cores' caches.
+std::vector<CacheLevel> QueryCachesApple() {
+    std::vector<CacheLevel> caches;
+    std::uint64_t sharing[8] = {};  // logical CPUs per instance; [0] is memory, [n] is Ln
+    size_t sharingSize = sizeof(sharing);
+    sysctlbyname("hw.cacheconfig", sharing, &sharingSize, nullptr, 0);
+    const char* names[] = {"hw.l1dcachesize", "hw.l2cachesize", "hw.l3cachesize"};
+    for (unsigned level = 1; level <= 3; ++level) {
+        std::int64_t bytes = 0;
+        size_t size = sizeof(bytes);
+        if (sysctlbyname(names[level - 1], &bytes, &size, nullptr, 0) == 0 && bytes > 0) {
+            caches.push_back({level, static_cast<std::uint64_t>(bytes),
+                              std::max<unsigned>(1, static_cast<unsigned>(sharing[level]))});
+        }
+    }
+    return caches;
+}
+
+#endif
+
+}  // namespace
+
+std::vector<LogicalCpu> QueryCpuTopology() {
+#ifdef _WIN32
+    return QueryTopologyWindows();
+#elif defined(__linux__)
+    return QueryTopologyLinux();
+#else
+    return {};
+#endif
+}
+
+std::vector<CacheLevel> QueryCacheLevels() {
+#ifdef _WIN32
+    std::vector<CacheLevel> caches = QueryCachesWindows();
+#elif defined(__linux__)
+    std::vector<CacheLevel> caches = QueryCachesLinux();
+#elif defined(__APPLE__)
+    std::vector<CacheLevel> caches = QueryCachesApple();
+#else
+    std::vector<CacheLevel> caches;
+#endif
+    std::sort(caches.begin(), caches.end(), [](const CacheLevel& a, const CacheLevel& b) { return a.level < b.level; });
+    return caches;
+}
+
+const char* CoreTypeName(CoreType type) {
+    switch (type) {
+        case CoreType::Performance:
+            return "P-core";
+        case CoreType::Efficiency:
+            return "E-core";
+        case CoreType::Uniform:
+            break;
+    }
+    return "core";
+}
+
+bool PinCurrentThread(const LogicalCpu& cpu) {
+#ifdef _WIN32
+    GROUP_AFFINITY affinity{};
+    affinity.Group = static_cast<WORD>(cpu.index / kGroupSize);
+    affinity.Mask = KAFFINITY(1) << (cpu.index % kGroupSize);
+    return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu.index, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
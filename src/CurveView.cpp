@@ -0,0 +1,119 @@
+#include "CurveView.hpp"
+
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPalette>
+
+#include <algorithm>
+#include <string_view>
+
+#include "BenchmarkRunner.hpp"
+
+namespace {
+
+constexpr int kLeftMargin = 56;  // room for the y axis labels
+constexpr int kMargin = 8;
+constexpr int kBottomMargin = 20;
+
+std::optional<BenchmarkCurve> FindCurve(const std::optional<BenchmarkResultData>& result, std::string_view name) {
+    if (result) {
+        for (const BenchmarkCurve& curve : result->curves) {
+            if (curve.name == name && !curve.points.empty()) {
+                return curve;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+CurveView::CurveView(QWidget* parent) : QWidget(parent) {
+    setMinimumHeight(120);
+    setVisible(false);
+}
+
+void CurveView::SetRuns(const std::optional<BenchmarkResultData>& baseline,
+                        const std::optional<BenchmarkResultData>& current) {
+    baseline_ = FindCurve(baseline, kSustainedCurve);
+    current_ = FindCurve(current, kSustainedCurve);
+    const auto steadyPoint = [](const std::optional<BenchmarkResultData>& result) -> std::optional<CurvePoint> {
+        const auto curve = FindCurve(result, kSteadyStateCurve);
+        return curve ? std::optional<CurvePoint>(curve->points.front()) : std::nullopt;
+    };
+    baselineSteady_ = steadyPoint(baseline);
+    currentSteady_ = steadyPoint(current);
+    setVisible(baseline_ || current_);
+    update();
+}
+
+QSize CurveView::sizeHint() const {
+    return {480, 160};
+}
+
+void CurveView::paintEvent(QPaintEvent*) {
+    if (!baseline_ && !current_) {
+        return;
+    }
+    // Both runs share the axes: time from 0 to the longer run, throughput
+    // from 0 to a tenth above the highest interval.
+    double maxX = 0.0;
+    double maxY = 0.0;
+    for (const auto* curve : {&baseline_, &current_}) {
+        if (*curve) {
+            for (const CurvePoint& point : (*curve)->points) {
+                maxX = std::max(maxX, point.x);
+                maxY = std::max(maxY, point.y);
+            }
+        }
+    }
+    if (maxX <= 0.0 || maxY <= 0.0) {
+        return;
+    }
+    maxY *= 1.1;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    const QRectF plot(kLeftMargin, kMargin, width() - kLeftMargin - kMargin, height() - kMargin - kBottomMargin);
+    const auto map = [&](double x, double y) {
+        return QPointF(plot.left() + x / maxX * plot.width(), plot.bottom() - y / maxY * plot.height());
+    };
+
+    const QColor text = palette().color(QPalette::WindowText);
+    painter.setPen(text);
+    painter.drawLine(plot.bottomLeft(), plot.bottomRight());
+    painter.drawLine(plot.bottomLeft(), plot.topLeft());
+    const QString yUnit = QString::fromStdString((current_ ? current_ : baseline_)->yUnit);
+    const QString xUnit = QString::fromStdString((current_ ? current_ : baseline_)->xUnit);
+    const QRectF yLabels(0, plot.top(), kLeftMargin - 4, plot.height());
+    painter.drawText(yLabels, Qt::AlignRight | Qt::AlignTop, QString::number(maxY, 'g', 3));
+    painter.drawText(yLabels, Qt::AlignRight | Qt::AlignVCenter, yUnit);
+    painter.drawText(yLabels, Qt::AlignRight | Qt::AlignBottom, QStringLiteral("0"));
+    const QRectF xLabels(plot.left(), plot.bottom() + 2, plot.width(), kBottomMargin - 2);
+    painter.drawText(xLabels, Qt::AlignLeft | Qt::AlignTop, QStringLiteral("0"));
+    painter.drawText(xLabels, Qt::AlignRight | Qt::AlignTop,
+                     QString::number(maxX, 'g', 3) + QStringLiteral(" ") + xUnit);
+
+    const auto draw = [&](const std::optional<BenchmarkCurve>& curve, const std::optional<CurvePoint>& steady,
+                          const QColor& color) {
+        if (!curve) {
+            return;
+        }
+        QPainterPath path(map(curve->points.front().x, curve->points.front().y));
+        for (const CurvePoint& point : curve->points) {
+            path.lineTo(map(point.x, point.y));
+        }
+        painter.setPen(QPen(color, 1.5));
+        painter.drawPath(path);
+        if (steady) {
+            painter.setPen(QPen(color, 1.0, Qt::DashLine));
+            painter.drawLine(map(steady->x, steady->y), map(curve->points.back().x, steady->y));
+            painter.setBrush(color);
+            painter.drawEllipse(map(steady->x, steady->y), 3.0, 3.0);
+            painter.setBrush(Qt::NoBrush);
+        }
+    };
+    draw(baseline_, baselineSteady_, palette().color(QPalette::Disabled, QPalette::WindowText));
+    draw(current_, currentSteady_, palette().color(QPalette::Highlight));
+}
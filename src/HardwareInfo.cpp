@@ -1,25 +1,63 @@
 #include "HardwareInfo.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <cwchar>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <vector>
 
 #ifdef _WIN32
 #include <Windows.h>
+#include <winternl.h>
+#include <d3dkmthk.h>
 #include <dxgi1_6.h>
 #include <intrin.h>
 #include <wrl/client.h>
 #elif defined(__APPLE__)
 #include <array>
 #include <cstdio>
+#include <cstdlib>
 #include <sstream>
 #include <string>
 #include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #endif
 
 namespace {
 
+#if defined(_WIN32) || defined(__linux__)
+// The PCI vendor ID is what DXGI and sysfs report; macOS names the vendor.
+std::wstring VendorFromId(unsigned vendorId) {
+    switch (vendorId) {
+        case 0x10DE:
+            return L"NVIDIA";
+        case 0x1002:
+        case 0x1022:
+            return L"AMD";
+        case 0x8086:
+            return L"Intel";
+        default: {
+            wchar_t buffer[16];
+            std::swprintf(buffer, std::size(buffer), L"0x%04X", vendorId);
+            return buffer;
+        }
+    }
+}
+
+std::string FormatPciBusId(unsigned domain, unsigned bus, unsigned device, unsigned function) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%08X:%02X:%02X.%X", domain, bus, device, function);
+    return buffer;
+}
+#endif
+
 #ifdef _WIN32
 
 using Microsoft::WRL::ComPtr;
@@ -43,6 +81,20 @@ CpuInfo ReadCpuInfo() {
     *reinterpret_cast<int*>(vendor + 8) = cpuInfo[2];
     info.vendor = vendor;
 
+    if (cpuInfo[0] >= 1) {
+        __cpuid(cpuInfo, 1);
+        const auto signature = static_cast<unsigned>(cpuInfo[0]);
+        info.stepping = signature & 0xF;
+        info.family = (signature >> 8) & 0xF;
+        info.model = (signature >> 4) & 0xF;
+        if (info.family == 0xF) {
+            info.family += (signature >> 20) & 0xFF;
+        }
+        if (info.family == 0x6 || info.family >= 0xF) {
+            info.model += ((signature >> 16) & 0xF) << 4;
+        }
+    }
+
     int brand[4] = {0};
     char brandString[49] = {0};
     for (int i = 0; i < 3; ++i) {
@@ -72,21 +124,29 @@ CpuInfo ReadCpuInfo() {
     return info;
 }
 
-std::wstring VendorFromId(UINT vendorId) {
-    switch (vendorId) {
-        case 0x10DE:
-            return L"NVIDIA";
-        case 0x1002:
-        case 0x1022:
-            return L"AMD";
-        case 0x8086:
-            return L"Intel";
-        default: {
-            wchar_t buffer[16];
-            swprintf_s(buffer, L"0x%04X", vendorId);
-            return buffer;
-        }
+// DXGI has no PCI location, but the kernel-mode adapter behind its LUID
+// does. D3DKMT reports no domain; Windows puts every GPU in domain 0.
+// Empty for adapters without one, such as the software rasterizer.
+std::string PciBusIdFromLuid(const LUID& luid) {
+    D3DKMT_OPENADAPTERFROMLUID open{};
+    open.AdapterLuid = luid;
+    if (D3DKMTOpenAdapterFromLuid(&open) != 0) {
+        return {};
     }
+    D3DKMT_ADAPTERADDRESS address{};
+    D3DKMT_QUERYADAPTERINFO query{};
+    query.hAdapter = open.hAdapter;
+    query.Type = KMTQAITYPE_ADAPTERADDRESS;
+    query.pPrivateDriverData = &address;
+    query.PrivateDriverDataSize = sizeof(address);
+    const NTSTATUS status = D3DKMTQueryAdapterInfo(&query);
+    D3DKMT_CLOSEADAPTER close{};
+    close.hAdapter = open.hAdapter;
+    D3DKMTCloseAdapter(&close);
+    if (status != 0) {
+        return {};
+    }
+    return FormatPciBusId(0, address.BusNumber, address.DeviceNumber, address.FunctionNumber);
 }
 
 std::vector<GpuInfo> QueryGpus() {
@@ -105,6 +165,11 @@ std::vector<GpuInfo> QueryGpus() {
             gpu.vendor = VendorFromId(desc.VendorId);
             gpu.dedicatedVideoMemoryMB = static_cast<size_t>(desc.DedicatedVideoMemory / (1024 * 1024));
             gpu.adapterIndex = index;
+            gpu.vendorId = desc.VendorId;
+            gpu.deviceId = desc.DeviceId;
+            gpu.subsystemId = desc.SubSysId;
+            gpu.revision = desc.Revision;
+            gpu.pciBusId = PciBusIdFromLuid(desc.AdapterLuid);
             gpus.push_back(std::move(gpu));
         }
         adapter.Reset();
@@ -129,20 +194,29 @@ std::wstring ToWide(const std::string& value) {
     return std::wstring(value.begin(), value.end());
 }
 
-CpuInfo ReadCpuInfoMac() {
-    CpuInfo info;
+// Empty when the key is missing.
+std::string ReadSysctlString(const char* name) {
     size_t length = 0;
-    if (sysctlbyname("machdep.cpu.brand_string", nullptr, &length, nullptr, 0) == 0 && length > 0) {
-        std::string brand(length, '\0');
-        sysctlbyname("machdep.cpu.brand_string", brand.data(), &length, nullptr, 0);
-        if (!brand.empty() && brand.back() == '\0') {
-            brand.pop_back();
-        }
-        info.name = brand;
+    if (sysctlbyname(name, nullptr, &length, nullptr, 0) != 0 || length == 0) {
+        return {};
+    }
+    std::string value(length, '\0');
+    if (sysctlbyname(name, value.data(), &length, nullptr, 0) != 0) {
+        return {};
     }
+    value.resize(length);
+    if (!value.empty() && value.back() == '\0') {
+        value.pop_back();
+    }
+    return value;
+}
+
+CpuInfo ReadCpuInfoMac() {
+    CpuInfo info;
+    info.name = ReadSysctlString("machdep.cpu.brand_string");
 
     char vendorBuffer[64] = {0};
-    length = sizeof(vendorBuffer);
+    size_t length = sizeof(vendorBuffer);
     if (sysctlbyname("machdep.cpu.vendor", vendorBuffer, &length, nullptr, 0) == 0) {
         info.vendor = vendorBuffer;
     } else if (info.name.find("Apple") != std::string::npos) {
@@ -160,9 +234,33 @@ CpuInfo ReadCpuInfoMac() {
     if (sysctlbyname("hw.physicalcpu", &physical, &length, nullptr, 0) == 0) {
         info.physicalCores = physical;
     }
+
+    // Only Intel Macs report CPUID values; Apple silicon leaves them zero.
+    uint32_t family = 0;
+    uint32_t model = 0;
+    uint32_t stepping = 0;
+    length = sizeof(family);
+    if (sysctlbyname("machdep.cpu.family", &family, &length, nullptr, 0) == 0) {
+        length = sizeof(model);
+        sysctlbyname("machdep.cpu.model", &model, &length, nullptr, 0);
+        length = sizeof(stepping);
+        sysctlbyname("machdep.cpu.stepping", &stepping, &length, nullptr, 0);
+        info.family = family;
+        info.model = model;
+        info.stepping = stepping;
+    }
     return info;
 }
 
+// "AMD (0x1002)" and "0x67df" both yield the hex number, or 0.
+unsigned ParseHexId(const std::string& value) {
+    const auto prefix = value.find("0x");
+    if (prefix == std::string::npos) {
+        return 0;
+    }
+    return static_cast<unsigned>(std::strtoul(value.c_str() + prefix + 2, nullptr, 16));
+}
+
 std::vector<GpuInfo> QueryGpusMac() {
     std::vector<GpuInfo> gpus;
     FILE* pipe = popen("system_profiler SPDisplaysDataType", "r");
@@ -186,6 +284,11 @@ std::vector<GpuInfo> QueryGpusMac() {
         } else if (line.rfind("Vendor:", 0) == 0) {
             std::string value = Trim(line.substr(std::strlen("Vendor:")));
             current.vendor = ToWide(value);
+            current.vendorId = ParseHexId(value);
+        } else if (line.rfind("Device ID:", 0) == 0) {
+            current.deviceId = ParseHexId(line);
+        } else if (line.rfind("Revision ID:", 0) == 0) {
+            current.revision = ParseHexId(line);
         } else if (line.rfind("VRAM", 0) == 0) {
             auto colon = line.find(':');
             if (colon != std::string::npos) {
@@ -211,8 +314,105 @@ std::vector<GpuInfo> QueryGpusMac() {
     return gpus;
 }
 
+#elif defined(__linux__)
+
+// A sysfs attribute such as "0x10de", or 0 when unreadable.
+unsigned ReadSysfsHex(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::string value;
+    if (!(file >> value)) {
+        return 0;
+    }
+    return static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 16));
+}
+
+// The device's name from the pci.ids database lspci uses ("NVIDIA
+// Corporation AD102 [GeForce RTX 4090]"), or empty when it is missing or
+// lacks the device.
+std::string PciIdsName(unsigned vendorId, unsigned deviceId) {
+    std::ifstream file("/usr/share/hwdata/pci.ids");
+    if (!file) {
+        file.open("/usr/share/misc/pci.ids");
+    }
+    std::string vendorName;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line[0] != '\t') {
+            if (!vendorName.empty() || line[0] == 'C') {
+                break;  // past the vendor, or into the device class list
+            }
+            if (line.size() > 6 && std::strtoul(line.substr(0, 4).c_str(), nullptr, 16) == vendorId) {
+                vendorName = line.substr(6);
+            }
+        } else if (!vendorName.empty() && line.size() > 7 && line[1] != '\t' &&
+                   std::strtoul(line.substr(1, 4).c_str(), nullptr, 16) == deviceId) {
+            return vendorName + ' ' + line.substr(7);
+        }
+    }
+    return {};
+}
+
+// Display controllers (PCI class 0x03) from sysfs, in slot order. sysfs
+// has IDs but no names, so those come from pci.ids when installed.
+std::vector<GpuInfo> QueryGpusLinux() {
+    std::vector<std::filesystem::path> slots;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/bus/pci/devices", error)) {
+        if ((ReadSysfsHex(entry.path() / "class") >> 16) == 0x03) {
+            slots.push_back(entry.path());
+        }
+    }
+    std::sort(slots.begin(), slots.end());
+
+    std::vector<GpuInfo> gpus;
+    for (const auto& slot : slots) {
+        GpuInfo gpu;
+        gpu.adapterIndex = static_cast<unsigned>(gpus.size());
+        gpu.vendorId = ReadSysfsHex(slot / "vendor");
+        gpu.deviceId = ReadSysfsHex(slot / "device");
+        gpu.subsystemId = (ReadSysfsHex(slot / "subsystem_device") << 16) | ReadSysfsHex(slot / "subsystem_vendor");
+        gpu.revision = ReadSysfsHex(slot / "revision");
+        gpu.vendor = VendorFromId(gpu.vendorId);
+        unsigned domain = 0;
+        unsigned bus = 0;
+        unsigned device = 0;
+        unsigned function = 0;
+        if (std::sscanf(slot.filename().c_str(), "%x:%x:%x.%x", &domain, &bus, &device, &function) == 4) {
+            gpu.pciBusId = FormatPciBusId(domain, bus, device, function);
+        }
+        const std::string name = PciIdsName(gpu.vendorId, gpu.deviceId);
+        gpu.name = name.empty() ? gpu.vendor + L" display adapter" : std::wstring(name.begin(), name.end());
+        gpus.push_back(std::move(gpu));
+    }
+    return gpus;
+}
+
 #endif  // platform selection
 
+// FNV-1a; strings are length-prefixed so adjacent fields cannot blur.
+class FingerprintHasher {
+public:
+    void Add(std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash_ = (hash_ ^ ((value >> (i * 8)) & 0xff)) * 1099511628211ull;
+        }
+    }
+    void Add(const std::string& text) {
+        Add(static_cast<std::uint64_t>(text.size()));
+        for (const char c : text) {
+            hash_ = (hash_ ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+    }
+
+    std::uint64_t Value() const { return hash_; }
+
+private:
+    std::uint64_t hash_ = 14695981039346656037ull;
+};
+
 }  // namespace
 
 HardwareSnapshot HardwareInfoService::QueryHardware() const {
@@ -223,8 +423,88 @@ HardwareSnapshot HardwareInfoService::QueryHardware() const {
 #elif defined(__APPLE__)
     snapshot.cpu = ReadCpuInfoMac();
     snapshot.gpus = QueryGpusMac();
+#elif defined(__linux__)
+    snapshot.cpu.name = "Unsupported platform";
+    snapshot.gpus = QueryGpusLinux();
 #else
     snapshot.cpu.name = "Unsupported platform";
 #endif
     return snapshot;
 }
+
+std::vector<GpuInfo> HardwareInfoService::EnumerateGpus() const {
+#ifdef _WIN32
+    return QueryGpus();
+#elif defined(__APPLE__)
+    return QueryGpusMac();
+#elif defined(__linux__)
+    return QueryGpusLinux();
+#else
+    return {};
+#endif
+}
+
+std::uint64_t HardwareInfoService::Fingerprint() const {
+    CpuInfo cpu;
+    std::string machine;
+#ifdef _WIN32
+    cpu = ReadCpuInfo();
+#elif defined(__APPLE__)
+    cpu = ReadCpuInfoMac();
+    machine = ReadSysctlString("hw.model");
+#else
+    cpu.name = "Unsupported platform";
+#endif
+    FingerprintHasher hasher;
+    hasher.Add(cpu.name);
+    hasher.Add(cpu.vendor);
+    hasher.Add(cpu.logicalCores);
+    hasher.Add(cpu.physicalCores);
+    hasher.Add(cpu.family);
+    hasher.Add(cpu.model);
+    hasher.Add(cpu.stepping);
+    hasher.Add(machine);
+    return hasher.Value();
+}
+
+std::vector<GpuChange> DiffGpus(const std::vector<GpuInfo>& before, const std::vector<GpuInfo>& after) {
+    const auto same = [](GpuInfo a, const GpuInfo& b) {
+        a.adapterIndex = b.adapterIndex;
+        return a == b;
+    };
+    // Longest common subsequence; adapter lists are a handful long.
+    const size_t rows = before.size();
+    const size_t columns = after.size();
+    std::vector<size_t> common((rows + 1) * (columns + 1), 0);
+    const auto at = [&](size_t i, size_t j) -> size_t& { return common[i * (columns + 1) + j]; };
+    for (size_t i = rows; i-- > 0;) {
+        for (size_t j = columns; j-- > 0;) {
+            at(i, j) = same(before[i], after[j]) ? at(i + 1, j + 1) + 1 : std::max(at(i + 1, j), at(i, j + 1));
+        }
+    }
+    std::vector<bool> kept(rows, false);
+    std::vector<bool> added(columns, true);
+    for (size_t i = 0, j = 0; i < rows && j < columns;) {
+        if (same(before[i], after[j])) {
+            kept[i++] = true;
+            added[j++] = false;
+        } else if (at(i + 1, j) >= at(i, j + 1)) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+
+    std::vector<GpuChange> changes;
+    for (size_t i = rows; i-- > 0;) {
+        if (!kept[i]) {
+            changes.push_back({GpuChange::Kind::Removed, i, before[i]});
+        }
+    }
+    for (size_t j = 0; j < columns; ++j) {
+        if (added[j]) {
+            changes.push_back({GpuChange::Kind::Added, j, after[j]});
+        }
+    }
+    return changes;
+}
@@ -0,0 +1,178 @@
+#include "HardwareKeys.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <functional>
+
+namespace {
+
+// Splits "a:b:c" into at most `maxParts` fields; nullopt on more.
+std::optional<std::vector<std::string_view>> SplitFields(std::string_view text, size_t maxParts) {
+    std::vector<std::string_view> parts;
+    while (true) {
+        const size_t colon = text.find(':');
+        parts.push_back(text.substr(0, colon));
+        if (parts.size() > maxParts) {
+            return std::nullopt;
+        }
+        if (colon == std::string_view::npos) {
+            return parts;
+        }
+        text.remove_prefix(colon + 1);
+    }
+}
+
+std::optional<std::uint32_t> ParseHex(std::string_view text, std::uint32_t max) {
+    std::uint32_t value = 0;
+    const char* end = text.data() + text.size();
+    const auto result = std::from_chars(text.data(), end, value, 16);
+    if (text.empty() || result.ec != std::errc() || result.ptr != end || value > max) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::vector<std::uint32_t> Merge(const std::vector<std::uint32_t>* exact, const std::vector<std::uint32_t>* wildcard) {
+    std::vector<std::uint32_t> indices;
+    if (exact) {
+        indices = *exact;
+    }
+    if (wildcard) {
+        indices.insert(indices.end(), wildcard->begin(), wildcard->end());
+        std::inplace_merge(indices.begin(), indices.end() - static_cast<std::ptrdiff_t>(wildcard->size()),
+                           indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    }
+    return indices;
+}
+
+template <typename Map, typename Key>
+void AddIndex(Map& map, const Key& key, std::uint32_t profileIndex) {
+    auto& indices = map[key];
+    // Profiles are added in catalog order, so this keeps the list sorted.
+    if (indices.empty() || indices.back() != profileIndex) {
+        indices.push_back(profileIndex);
+    }
+}
+
+template <typename Map, typename Key>
+const std::vector<std::uint32_t>* FindIndex(const Map& map, const Key& key) {
+    const auto it = map.find(key);
+    return it == map.end() ? nullptr : &it->second;
+}
+
+size_t Mix(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+}  // namespace
+
+std::optional<CpuIdKey> CpuIdKey::Parse(std::string_view text) {
+    const auto parts = SplitFields(text, 4);
+    if (!parts || parts->size() < 3 || (*parts)[0].empty()) {
+        return std::nullopt;
+    }
+    CpuIdKey key;
+    key.vendor = (*parts)[0];
+    const auto family = ParseHex((*parts)[1], 0xFFFF);
+    const auto model = ParseHex((*parts)[2], 0xFFFF);
+    if (!family || !model) {
+        return std::nullopt;
+    }
+    key.family = *family;
+    key.model = *model;
+    if (parts->size() == 4) {
+        key.stepping = ParseHex((*parts)[3], 0xF);
+        if (!key.stepping) {
+            return std::nullopt;
+        }
+    }
+    return key;
+}
+
+std::optional<CpuIdKey> CpuIdKey::FromInfo(const CpuInfo& info) {
+    if (info.vendor.empty() || info.family == 0) {
+        return std::nullopt;
+    }
+    return CpuIdKey{info.vendor, info.family, info.model, info.stepping};
+}
+
+bool CpuIdKey::Covers(const CpuIdKey& device) const {
+    return vendor == device.vendor && family == device.family && model == device.model &&
+           (!stepping || stepping == device.stepping);
+}
+
+std::optional<PciIdKey> PciIdKey::Parse(std::string_view text) {
+    const auto parts = SplitFields(text, 3);
+    if (!parts || parts->size() < 2) {
+        return std::nullopt;
+    }
+    const auto vendor = ParseHex((*parts)[0], 0xFFFF);
+    const auto device = ParseHex((*parts)[1], 0xFFFF);
+    if (!vendor || !device) {
+        return std::nullopt;
+    }
+    PciIdKey key;
+    key.vendorId = static_cast<std::uint16_t>(*vendor);
+    key.deviceId = static_cast<std::uint16_t>(*device);
+    if (parts->size() == 3) {
+        key.subsystemId = ParseHex((*parts)[2], 0xFFFFFFFFu);
+        if (!key.subsystemId) {
+            return std::nullopt;
+        }
+    }
+    return key;
+}
+
+std::optional<PciIdKey> PciIdKey::FromInfo(const GpuInfo& info) {
+    if (info.vendorId == 0) {
+        return std::nullopt;
+    }
+    PciIdKey key{static_cast<std::uint16_t>(info.vendorId), static_cast<std::uint16_t>(info.deviceId), std::nullopt};
+    if (info.subsystemId != 0) {
+        key.subsystemId = info.subsystemId;
+    }
+    return key;
+}
+
+bool PciIdKey::Covers(const PciIdKey& device) const {
+    return vendorId == device.vendorId && deviceId == device.deviceId &&
+           (!subsystemId || subsystemId == device.subsystemId);
+}
+
+size_t CpuIdKeyHash::operator()(const CpuIdKey& key) const {
+    size_t hash = std::hash<std::string_view>{}(key.vendor);
+    hash = Mix(hash, (static_cast<size_t>(key.family) << 16) | key.model);
+    return Mix(hash, key.stepping ? *key.stepping + 1 : 0);
+}
+
+size_t PciIdKeyHash::operator()(const PciIdKey& key) const {
+    const size_t hash = Mix((static_cast<size_t>(key.vendorId) << 16) | key.deviceId, 0);
+    return Mix(hash, key.subsystemId ? static_cast<size_t>(*key.subsystemId) + 1 : 0);
+}
+
+void HardwareIdIndex::AddCpu(const CpuIdKey& key, std::uint32_t profileIndex) {
+    AddIndex(cpu_, key, profileIndex);
+}
+
+void HardwareIdIndex::AddGpu(const PciIdKey& key, std::uint32_t profileIndex) {
+    AddIndex(gpu_, key, profileIndex);
+}
+
+std::vector<std::uint32_t> HardwareIdIndex::FindCpu(const CpuIdKey& device) const {
+    if (cpu_.empty()) {
+        return {};
+    }
+    CpuIdKey wildcard = device;
+    wildcard.stepping.reset();
+    return Merge(device.stepping ? FindIndex(cpu_, device) : nullptr, FindIndex(cpu_, wildcard));
+}
+
+std::vector<std::uint32_t> HardwareIdIndex::FindGpu(const PciIdKey& device) const {
+    if (gpu_.empty()) {
+        return {};
+    }
+    PciIdKey wildcard = device;
+    wildcard.subsystemId.reset();
+    return Merge(device.subsystemId ? FindIndex(gpu_, device) : nullptr, FindIndex(gpu_, wildcard));
+}
@@ -0,0 +1,133 @@
+#include "HardwareWatcher.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <dxgi1_6.h>
+#elif defined(__linux__)
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+// Whether a kernel uevent ("add@/devices/...\0ACTION=add\0SUBSYSTEM=pci\0
+// PCI_CLASS=30000\0...") announces a display controller (PCI class 0x03)
+// arriving or leaving.
+bool IsDisplayHotplug(std::string_view message) {
+    bool attached = false;
+    bool pci = false;
+    bool display = false;
+    while (!message.empty()) {
+        const size_t end = message.find('\0');
+        const std::string_view field = message.substr(0, end);
+        if (field == "ACTION=add" || field == "ACTION=remove") {
+            attached = true;
+        } else if (field == "SUBSYSTEM=pci") {
+            pci = true;
+        } else if (field.starts_with("PCI_CLASS=")) {
+            const std::string value(field.substr(10));
+            display = (std::strtoul(value.c_str(), nullptr, 16) >> 16) == 0x03;
+        }
+        message.remove_prefix(end == std::string_view::npos ? message.size() : end + 1);
+    }
+    return attached && pci && display;
+}
+
+#endif
+
+}  // namespace
+
+HardwareWatcher::HardwareWatcher() {
+#ifdef _WIN32
+    IDXGIFactory7* factory = nullptr;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory)))) {
+        return;  // DXGI 1.6 needs Windows 10 1803 or later
+    }
+    HANDLE event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    DWORD cookie = 0;
+    if (!event || FAILED(factory->RegisterAdaptersChangedEvent(event, &cookie))) {
+        if (event) {
+            CloseHandle(event);
+        }
+        factory->Release();
+        return;
+    }
+    factory_ = factory;
+    cookie_ = cookie;
+    handle_ = reinterpret_cast<std::intptr_t>(event);
+#elif defined(__linux__)
+    const int fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        return;
+    }
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;  // kernel uevents, before udev processes them
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return;
+    }
+    handle_ = fd;
+#endif
+}
+
+HardwareWatcher::~HardwareWatcher() {
+    if (!IsActive()) {
+        return;
+    }
+#ifdef _WIN32
+    auto* factory = static_cast<IDXGIFactory7*>(factory_);
+    factory->UnregisterAdaptersChangedEvent(cookie_);
+    factory->Release();
+    CloseHandle(reinterpret_cast<HANDLE>(handle_));
+#elif defined(__linux__)
+    ::close(static_cast<int>(handle_));
+#endif
+}
+
+bool HardwareWatcher::ConsumeEvents() {
+    if (!IsActive()) {
+        return false;
+    }
+#ifdef _WIN32
+    return true;  // the auto-reset event re-arms itself
+#elif defined(__linux__)
+    bool relevant = false;
+    char buffer[8192];
+    while (true) {
+        sockaddr_nl sender{};
+        socklen_t senderLength = sizeof(sender);
+        const ssize_t length = ::recvfrom(static_cast<int>(handle_), buffer, sizeof(buffer), 0,
+                                          reinterpret_cast<sockaddr*>(&sender), &senderLength);
+        if (length < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == ENOBUFS) {
+                relevant = true;  // the socket overflowed and events were lost
+                continue;
+            }
+            break;  // EAGAIN once drained
+        }
+        // Only the kernel (port 0) is trusted; anyone may send to the group.
+        if (sender.nl_pid == 0) {
+            relevant = relevant || IsDisplayHotplug(std::string_view(buffer, static_cast<size_t>(length)));
+        }
+    }
+    return relevant;
+#else
+    return false;
+#endif
+}
+
+std::vector<GpuChange> HardwareWatcher::CollectChanges(const std::vector<GpuInfo>& current) const {
+    return DiffGpus(current, HardwareInfoService().EnumerateGpus());
+}
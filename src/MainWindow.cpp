@@ -1,6 +1,7 @@
 #include "MainWindow.hpp"
 
-#include <QApplication>
+#include <QCheckBox>
+#include <QComboBox>
 #include <QCoreApplication>
 #include <QGridLayout>
 #include <QGroupBox>
@@ -8,19 +9,43 @@
 #include <QLabel>
 #include <QListWidget>
 #include <QMessageBox>
+#include <QProgressBar>
 #include <QPushButton>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QStandardPaths>
 #include <QStatusBar>
 #include <QString>
 #include <QStringList>
+#include <QTimer>
 #include <QVBoxLayout>
 
+#ifdef _WIN32
+#include <QWinEventNotifier>
+#else
+#include <QSocketNotifier>
+#endif
+
 #include <algorithm>
 #include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
+#include "BenchmarkHistory.hpp"
 #include "BenchmarkRunner.hpp"
+#include "BenchmarkStats.hpp"
+#include "CatalogWatcher.hpp"
+#include "CurveView.hpp"
 #include "HardwareInfo.hpp"
+#include "HardwareWatcher.hpp"
+#include "PerformanceIndex.hpp"
+#include "PowerThrottler.hpp"
+#include "ProfileCatalog.hpp"
 #include "ProfileEngine.hpp"
 #include "ProfileLoader.hpp"
+#include "StartupCache.hpp"
 
 namespace {
 
@@ -35,6 +60,122 @@ QString JoinGpuNames(const std::vector<GpuInfo>& gpus) {
     return names.join(QStringLiteral(" • "));
 }
 
+QString ToQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+}
+
+// Editors often write a file several times per save; wait for them to
+// settle before re-reading the catalog.
+constexpr int kReloadDebounceMs = 200;
+// A hotplugged GPU arrives as a burst of events (its functions, bridges),
+// and on removal sysfs lingers briefly after the event.
+constexpr int kHotplugSettleMs = 500;
+// Upper end of the sustained-run spin box; laptops settle within minutes.
+constexpr int kMaxSustainedSeconds = 600;
+
+void ApplyGpuChange(std::vector<GpuInfo>& gpus, const GpuChange& change) {
+    const auto at = gpus.begin() + static_cast<std::ptrdiff_t>(change.index);
+    if (change.kind == GpuChange::Kind::Added) {
+        gpus.insert(at, change.gpu);
+    } else {
+        gpus.erase(at);
+    }
+}
+
+QString AdapterLabel(const std::vector<GpuInfo>& gpus, size_t adapter) {
+    return QStringLiteral("GPU %1: %2").arg(adapter).arg(QString::fromWCharArray(gpus[adapter].name.c_str()));
+}
+
+// List row for a candidate SKU; its target is only synthesized once the
+// row is picked.
+QString CandidateLabel(std::string_view profileLabel) {
+    return QStringLiteral("Mimic %1 (estimated)").arg(ToQString(profileLabel));
+}
+
+QString DescribeDiff(const CatalogDiff& diff) {
+    const auto count = [](const ProfileChanges& changes) {
+        return QStringLiteral("%1 added, %2 changed, %3 removed")
+            .arg(changes.added.size())
+            .arg(changes.changed.size())
+            .arg(changes.removed.size());
+    };
+    return QStringLiteral("CPU %1; GPU %2").arg(count(diff.cpu), count(diff.gpu));
+}
+
+// " (-12.3%, significant, p = 0.001)" after a current score, from the
+// Mann-Whitney test of its samples against the baseline's; empty when
+// either side is missing or has too few samples.
+QString DescribeChange(const std::optional<BenchmarkResultData>& baseline,
+                       const std::optional<BenchmarkResultData>& current) {
+    if (!baseline || !current || baseline->unit != current->unit) {
+        return QString();
+    }
+    const SampleComparison comparison = CompareSamples(baseline->samples, current->samples);
+    if (!comparison.enoughSamples) {
+        return QString();
+    }
+    return QStringLiteral(" (%1%2%, %3, p = %4)")
+        .arg(comparison.change >= 0.0 ? QStringLiteral("+") : QString())
+        .arg(comparison.change * 100.0, 0, 'f', 1)
+        .arg(comparison.significant ? QStringLiteral("significant") : QStringLiteral("within noise"))
+        .arg(comparison.pValue, 0, 'g', 2);
+}
+
+// "\nChange from the baseline:\nsha256 -12.0%..." for each kernel both
+// runs measured.
+QString DescribeKernelChanges(const std::optional<BenchmarkResultData>& baseline,
+                              const BenchmarkResultData& current) {
+    if (!baseline) {
+        return {};
+    }
+    QString text;
+    for (const KernelScore& kernel : current.kernels) {
+        for (const KernelScore& before : baseline->kernels) {
+            if (before.kernel == kernel.kernel && before.isa == kernel.isa && before.gops > 0.0) {
+                text += QStringLiteral("\n%1 %2%")
+                            .arg(QString::fromStdString(kernel.kernel))
+                            .arg((kernel.gops / before.gops - 1.0) * 100.0, 0, 'f', 1);
+                break;
+            }
+        }
+    }
+    return text.isEmpty() ? text : QStringLiteral("\nChange from the baseline:") + text;
+}
+
+QString ScoreName(const std::string& kernel) {
+    if (kernel == kCpuScore) {
+        return QStringLiteral("CPU");
+    }
+    if (kernel == kGpuScore) {
+        return QStringLiteral("GPU");
+    }
+    if (kernel == kMemoryScore) {
+        return QStringLiteral("Memory");
+    }
+    if (kernel == kWorkloadScore) {
+        return QStringLiteral("Workloads");
+    }
+    if (kernel == kSustainedScore) {
+        return QStringLiteral("Sustained");
+    }
+    return kernel == kScalingScore ? QStringLiteral("Scaling") : QString::fromStdString(kernel);
+}
+
+// "; CPU 4.1% below its last 5 runs (p = 0.003)" per regressed score.
+QString DescribeRegressions(const std::vector<RegressionCheck>& checks) {
+    QString text;
+    for (const RegressionCheck& check : checks) {
+        if (check.regressed) {
+            text += QStringLiteral("; %1 %2% below its last %3 runs (p = %4)")
+                        .arg(ScoreName(check.kernel))
+                        .arg(-check.comparison.change * 100.0, 0, 'f', 1)
+                        .arg(check.baselineRuns)
+                        .arg(check.comparison.pValue, 0, 'g', 2);
+        }
+    }
+    return text;
+}
+
 }  // namespace
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
@@ -65,10 +206,13 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
 
     auto* gpuBox = new QGroupBox(QStringLiteral("GPU Downgrade Targets"), this);
     auto* gpuLayout = new QVBoxLayout;
+    gpuAdapterBox_ = new QComboBox(this);
+    gpuAdapterBox_->setVisible(false);  // shown once a second adapter is detected
+    gpuLayout->addWidget(gpuAdapterBox_);
     gpuList_ = new QListWidget(this);
     gpuLayout->addWidget(gpuList_);
     auto* gpuButtonRow = new QHBoxLayout;
-    applyGpuButton_ = new QPushButton(QStringLiteral("Apply GPU Target"), this);
+    applyGpuButton_ = new QPushButton(QStringLiteral("Apply GPU Targets"), this);
     gpuButtonRow->addStretch();
     gpuButtonRow->addWidget(applyGpuButton_);
     gpuLayout->addLayout(gpuButtonRow);
@@ -91,7 +235,60 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     runCurrentButton_ = new QPushButton(QStringLiteral("Run Current Benchmark"), this);
     benchmarkButtons->addWidget(runBaselineButton_);
     benchmarkButtons->addWidget(runCurrentButton_);
+    cancelBenchmarkButton_ = new QPushButton(QStringLiteral("Cancel"), this);
+    cancelBenchmarkButton_->setEnabled(false);
+    benchmarkButtons->addWidget(cancelBenchmarkButton_);
+    benchmarkButtons->addWidget(new QLabel(QStringLiteral("Runs:"), this));
+    repetitionsBox_ = new QSpinBox(this);
+    repetitionsBox_->setRange(5, 200);
+    repetitionsBox_->setValue(BenchmarkOptions().repetitions);
+    repetitionsBox_->setToolTip(
+        QStringLiteral("Timed runs behind the CPU, GPU and workload scores (after a warmup run); more runs take longer "
+                       "but narrow the confidence interval"));
+    benchmarkButtons->addWidget(repetitionsBox_);
+    perCoreCheck_ = new QCheckBox(QStringLiteral("Per core"), this);
+    perCoreCheck_->setToolTip(
+        QStringLiteral("Also time each logical CPU alone and each core's SMT siblings together, pinned, "
+                       "grouped by core type (takes longer)"));
+    benchmarkButtons->addWidget(perCoreCheck_);
+    memoryCheck_ = new QCheckBox(QStringLiteral("Memory"), this);
+    memoryCheck_->setToolTip(
+        QStringLiteral("Also sweep the working set from L1 to DRAM (bandwidth and load latency) and run STREAM "
+                       "copy/scale/add/triad over 1, 2, 4... threads (a few seconds more)"));
+    benchmarkButtons->addWidget(memoryCheck_);
+    hugePagesCheck_ = new QCheckBox(QStringLiteral("Huge pages"), this);
+    hugePagesCheck_->setToolTip(
+        QStringLiteral("Back the memory suite's buffers with huge pages (on Windows this needs the \"Lock pages "
+                       "in memory\" right); compare with a run without to see the cost of TLB misses"));
+    hugePagesCheck_->setEnabled(false);
+    benchmarkButtons->addWidget(hugePagesCheck_);
+    workloadsCheck_ = new QCheckBox(QStringLiteral("Workloads"), this);
+    workloadsCheck_->setToolTip(
+        QStringLiteral("Also run the workload suite on all threads: LZ compression and decompression, SHA-256, "
+                       "CRC-32C, tree search, radix sort, word counting and a cloth physics step, combined into "
+                       "one score (about a second more)"));
+    benchmarkButtons->addWidget(workloadsCheck_);
+    scalingCheck_ = new QCheckBox(QStringLiteral("Scaling"), this);
+    scalingCheck_->setToolTip(
+        QStringLiteral("Also run every CPU kernel on 1, 2, 4... threads, one per core before any SMT sibling, for "
+                       "the speedup and efficiency at each count, the serial fraction and the SMT yield (a few "
+                       "seconds more); the current run is checked against the selected target's core and thread "
+                       "limits"));
+    benchmarkButtons->addWidget(scalingCheck_);
+    benchmarkButtons->addWidget(new QLabel(QStringLiteral("Sustained:"), this));
+    sustainedBox_ = new QSpinBox(this);
+    sustainedBox_->setRange(0, kMaxSustainedSeconds);
+    sustainedBox_->setSuffix(QStringLiteral(" s"));
+    sustainedBox_->setSpecialValueText(QStringLiteral("Off"));
+    sustainedBox_->setToolTip(
+        QStringLiteral("Also load every thread for this long and sample throughput four times a second, to see "
+                       "how the clocks settle once heat and power limits kick in; scored on the steady state"));
+    benchmarkButtons->addWidget(sustainedBox_);
     benchmarkLayout->addLayout(benchmarkButtons);
+    benchmarkProgress_ = new QProgressBar(this);
+    benchmarkProgress_->setRange(0, 1000);
+    benchmarkProgress_->setValue(0);
+    benchmarkLayout->addWidget(benchmarkProgress_);
 
     auto* grid = new QGridLayout;
     grid->addWidget(new QLabel(QStringLiteral("CPU Baseline:"), this), 0, 0);
@@ -114,7 +311,34 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     gpuExpectedLabel_ = new QLabel(QStringLiteral("N/A"), this);
     grid->addWidget(gpuExpectedLabel_, 2, 3);
 
+    grid->addWidget(new QLabel(QStringLiteral("Memory Baseline:"), this), 3, 0);
+    memoryBaselineLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(memoryBaselineLabel_, 3, 1);
+    grid->addWidget(new QLabel(QStringLiteral("Memory Current:"), this), 3, 2);
+    memoryCurrentLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(memoryCurrentLabel_, 3, 3);
+    grid->addWidget(new QLabel(QStringLiteral("Workloads Baseline:"), this), 4, 0);
+    workloadsBaselineLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(workloadsBaselineLabel_, 4, 1);
+    grid->addWidget(new QLabel(QStringLiteral("Workloads Current:"), this), 4, 2);
+    workloadsCurrentLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(workloadsCurrentLabel_, 4, 3);
+    grid->addWidget(new QLabel(QStringLiteral("Sustained Baseline:"), this), 5, 0);
+    sustainedBaselineLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(sustainedBaselineLabel_, 5, 1);
+    grid->addWidget(new QLabel(QStringLiteral("Sustained Current:"), this), 5, 2);
+    sustainedCurrentLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(sustainedCurrentLabel_, 5, 3);
+    grid->addWidget(new QLabel(QStringLiteral("Scaling Baseline:"), this), 6, 0);
+    scalingBaselineLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(scalingBaselineLabel_, 6, 1);
+    grid->addWidget(new QLabel(QStringLiteral("Scaling Current:"), this), 6, 2);
+    scalingCurrentLabel_ = new QLabel(QStringLiteral("N/A"), this);
+    grid->addWidget(scalingCurrentLabel_, 6, 3);
+
     benchmarkLayout->addLayout(grid);
+    sustainedCurve_ = new CurveView(this);
+    benchmarkLayout->addWidget(sustainedCurve_);
     benchmarkBox->setLayout(benchmarkLayout);
     mainLayout->addWidget(benchmarkBox);
 
@@ -123,24 +347,73 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     statusBar()->showMessage(QStringLiteral("Initializing..."));
 
     connect(cpuList_, &QListWidget::currentRowChanged, this, &MainWindow::HandleCpuSelection);
+    connect(gpuAdapterBox_, &QComboBox::currentIndexChanged, this, &MainWindow::HandleGpuAdapterChanged);
     connect(gpuList_, &QListWidget::currentRowChanged, this, &MainWindow::HandleGpuSelection);
     connect(applyCpuButton_, &QPushButton::clicked, this, &MainWindow::ApplyCpuTarget);
-    connect(applyGpuButton_, &QPushButton::clicked, this, &MainWindow::ApplyGpuTarget);
+    connect(applyGpuButton_, &QPushButton::clicked, this, &MainWindow::ApplyGpuTargets);
     connect(restoreButton_, &QPushButton::clicked, this, &MainWindow::RestoreDefaults);
     connect(runBaselineButton_, &QPushButton::clicked, this, &MainWindow::RunBaselineBenchmark);
     connect(runCurrentButton_, &QPushButton::clicked, this, &MainWindow::RunCurrentBenchmark);
+    connect(cancelBenchmarkButton_, &QPushButton::clicked, this, &MainWindow::CancelBenchmark);
+    connect(memoryCheck_, &QCheckBox::toggled, hugePagesCheck_, &QCheckBox::setEnabled);
+
+    reloadTimer_ = new QTimer(this);
+    reloadTimer_->setSingleShot(true);
+    reloadTimer_->setInterval(kReloadDebounceMs);
+    connect(reloadTimer_, &QTimer::timeout, this, &MainWindow::ReloadProfiles);
+
+    hotplugTimer_ = new QTimer(this);
+    hotplugTimer_->setSingleShot(true);
+    hotplugTimer_->setInterval(kHotplugSettleMs);
+    connect(hotplugTimer_, &QTimer::timeout, this, &MainWindow::ApplyHardwareChanges);
 
     InitializeState();
 }
 
+MainWindow::~MainWindow() {
+    // The probe, the catalog load and the benchmark post back to this
+    // window, so they have to finish first; a result still queued is
+    // dropped along with the window.
+    if (probeThread_.joinable()) {
+        probeThread_.join();
+    }
+    if (catalogThread_.joinable()) {
+        catalogThread_.join();
+    }
+    if (benchmarkControl_) {
+        benchmarkControl_->Cancel();
+    }
+    if (benchmarkThread_.joinable()) {
+        benchmarkThread_.join();
+    }
+    // The notifiers must go before the watchers close their handles.
+    delete catalogNotifier_;
+    delete hardwareNotifier_;
+}
+
 void MainWindow::InitializeState() {
     HardwareInfoService infoService;
-    state_.snapshot = infoService.QueryHardware();
+    hardwareFingerprint_ = infoService.Fingerprint();
+    startupCachePath_ = ResolveStartupCachePath();
+    // Warm start: while the cheap fingerprint agrees, take the cached
+    // snapshot instead of probing and confirm it with a full probe in the
+    // background.
+    std::optional<StartupCacheEntry> cached = StartupCache(startupCachePath_).Load();
+    if (cached && cached->hardwareFingerprint != hardwareFingerprint_) {
+        cached.reset();
+    }
+    state_.snapshot = cached ? cached->snapshot : infoService.QueryHardware();
+    if (cached) {
+        StartHardwareRevalidation();
+    }
+    StartHardwareWatch();
 
     ProfileLoader loader;
-    std::filesystem::path profilePath = ResolveProfilesPath();
+    profilePath_ = ResolveProfilesPath();
+    // Watch even if the first load fails, so fixing the file recovers.
+    StartCatalogWatch();
     try {
-        state_.profiles = loader.LoadFromFile(profilePath);
+        state_.profiles = loader.LoadCatalog(profilePath_, state_.snapshot);
     } catch (const std::exception& ex) {
         QMessageBox::critical(this, QStringLiteral("Hardware Limiter"),
                               QStringLiteral("Failed to load profiles:\n%1").arg(ex.what()));
@@ -153,12 +426,15 @@ void MainWindow::InitializeState() {
         return;
     }
 
-    state_.engine.Refresh(state_.snapshot, state_.profiles);
-    state_.cpuOptions = state_.engine.CpuOptions();
-    state_.gpuOptions = state_.engine.GpuOptions();
-    state_.cpuNominalFrequencyMHz = state_.engine.CpuNominalFrequencyMHz();
-    state_.gpuNominalClockMHz = state_.engine.GpuNominalFrequencyMHz();
-    state_.gpuNominalPowerWatts = state_.engine.GpuNominalPowerWatts();
+    // The cached matches hold as long as the catalog is the one they were
+    // made against.
+    const bool restored = cached && cached->catalogHash == state_.profiles.SourceHash() &&
+                          state_.engine.Restore(cached->matched, state_.profiles);
+    if (!restored) {
+        state_.engine.Refresh(state_.snapshot, state_.profiles);
+        SaveStartupCache();
+    }
+    SyncEngineResults();
     state_.initialized = true;
 
     PopulateLists();
@@ -166,17 +442,443 @@ void MainWindow::InitializeState() {
     UpdateButtonStates();
     UpdateBenchmarkLabels();
     UpdateStatus(QStringLiteral("Ready"));
+    StartFullCatalogLoad();
+}
+
+// A partial catalog shows the matched targets quickly but cannot rank
+// them. Load the whole catalog in the background and compile it to
+// profiles.bin, so the candidates arrive shortly and the next launch maps
+// the image instead of falling back to the JSON again.
+void MainWindow::StartFullCatalogLoad() {
+    if (!state_.profiles.IsPartial() || catalogLoading_) {
+        return;
+    }
+    if (catalogThread_.joinable()) {
+        catalogThread_.join();  // the previous load's, already finished
+    }
+    catalogLoading_ = true;
+    catalogThread_ = std::thread([this, path = profilePath_] {
+        std::optional<ProfileCatalog> full;
+        try {
+            full = ProfileLoader().LoadCatalog(path);
+        } catch (const std::exception&) {
+            // Keep the partial catalog; a reload after fixing the file recovers.
+        }
+        if (full && !full->IsMapped()) {
+            // Best effort: an unwritable directory only costs the next
+            // launch another JSON fallback.
+            std::filesystem::path binaryPath = path;
+            binaryPath.replace_extension(".bin");
+            try {
+                ProfileCatalog::WriteImage(binaryPath, full->Image());
+            } catch (const std::exception&) {
+            }
+        }
+        QMetaObject::invokeMethod(
+            this, [this, full = std::move(full)] {
+                catalogLoading_ = false;
+                if (full) {
+                    HandleFullCatalog(*full);
+                }
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+// Swaps the full catalog in for the partial one it was loaded behind. A
+// reload or an edited file may have replaced the catalog meanwhile; then
+// the result is stale and dropped.
+void MainWindow::HandleFullCatalog(const ProfileCatalog& full) {
+    if (!state_.profiles.IsPartial() || full.SourceHash() != state_.profiles.SourceHash()) {
+        return;
+    }
+    const std::string cpuTargetId = SelectedCpuTargetId();
+    const std::vector<std::string> gpuTargetIds = SelectedGpuTargetIds();
+    ClearSelection();
+    state_.profiles = full;
+    if (!state_.engine.Rebind(state_.profiles)) {
+        state_.engine.Refresh(state_.snapshot, state_.profiles);
+    }
+    SyncEngineResults();
+    PopulateLists();
+    RestoreSelection(cpuTargetId, gpuTargetIds);
+    UpdateButtonStates();
+    UpdateBenchmarkLabels();
+    SaveStartupCache();
+}
+
+void MainWindow::StartHardwareRevalidation() {
+    probeThread_ = std::thread([this] {
+        HardwareSnapshot probed = HardwareInfoService().QueryHardware();
+        QMetaObject::invokeMethod(
+            this, [this, probed = std::move(probed)] { HandleProbedHardware(probed); }, Qt::QueuedConnection);
+    });
+}
+
+// Result of the background probe on a warm start. Any difference from the
+// cached snapshot drops the cache and re-matches against the real hardware.
+void MainWindow::HandleProbedHardware(const HardwareSnapshot& probed) {
+    if (probed == state_.snapshot) {
+        return;
+    }
+    StartupCache(startupCachePath_).Invalidate();
+    state_.snapshot = probed;
+    UpdateSnapshotLabel();
+    if (state_.initialized) {
+        RematchHardware(QStringLiteral("Hardware changed since the last launch; options refreshed"));
+    }
+}
+
+// Full re-match against the changed `state_.snapshot`, keeping the
+// selections that are still offered.
+void MainWindow::RematchHardware(const QString& status) {
+    QString message = status;
+    const std::string cpuTargetId = SelectedCpuTargetId();
+    const std::vector<std::string> gpuTargetIds = SelectedGpuTargetIds();
+    ClearSelection();
+    if (state_.profiles.IsPartial()) {
+        // The JSON fallback only kept profiles matching the previous hardware.
+        try {
+            state_.profiles = ProfileLoader().LoadCatalog(profilePath_, state_.snapshot);
+        } catch (const std::exception& ex) {
+            message = QStringLiteral("Hardware changed, but reloading profiles failed: %1").arg(ex.what());
+        }
+    }
+    state_.engine.Refresh(state_.snapshot, state_.profiles);
+    SyncEngineResults();
+    PopulateLists();
+    RestoreSelection(cpuTargetId, gpuTargetIds);
+    SaveStartupCache();
+    UpdateStatus(message);
+    StartFullCatalogLoad();
+}
+
+// Best effort: a cache that cannot be written only costs the next launch
+// a full probe.
+void MainWindow::SaveStartupCache() {
+    if (startupCachePath_.empty()) {
+        return;
+    }
+    StartupCacheEntry entry;
+    entry.hardwareFingerprint = hardwareFingerprint_;
+    entry.catalogHash = state_.profiles.SourceHash();
+    entry.snapshot = state_.snapshot;
+    entry.matched = state_.engine.Matched();
+    StartupCache(startupCachePath_).Save(entry);
+}
+
+void MainWindow::StartCatalogWatch() {
+    catalogWatcher_ = std::make_unique<CatalogWatcher>(profilePath_);
+    if (!catalogWatcher_->IsActive()) {
+        return;
+    }
+#ifdef _WIN32
+    auto* notifier = new QWinEventNotifier(reinterpret_cast<Qt::HANDLE>(catalogWatcher_->NativeHandle()), this);
+    connect(notifier, &QWinEventNotifier::activated, this, &MainWindow::HandleCatalogActivity);
+#else
+    auto* notifier =
+        new QSocketNotifier(static_cast<qintptr>(catalogWatcher_->NativeHandle()), QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &MainWindow::HandleCatalogActivity);
+#endif
+    catalogNotifier_ = notifier;
+}
+
+void MainWindow::HandleCatalogActivity() {
+    if (catalogWatcher_->ConsumeChanges()) {
+        reloadTimer_->start();  // restarts a pending countdown
+    }
+}
+
+void MainWindow::StartHardwareWatch() {
+    hardwareWatcher_ = std::make_unique<HardwareWatcher>();
+    if (!hardwareWatcher_->IsActive()) {
+        return;
+    }
+#ifdef _WIN32
+    auto* notifier = new QWinEventNotifier(reinterpret_cast<Qt::HANDLE>(hardwareWatcher_->NativeHandle()), this);
+    connect(notifier, &QWinEventNotifier::activated, this, &MainWindow::HandleHardwareActivity);
+#else
+    auto* notifier =
+        new QSocketNotifier(static_cast<qintptr>(hardwareWatcher_->NativeHandle()), QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &MainWindow::HandleHardwareActivity);
+#endif
+    hardwareNotifier_ = notifier;
+}
+
+void MainWindow::HandleHardwareActivity() {
+    if (hardwareWatcher_->ConsumeEvents()) {
+        hotplugTimer_->start();  // restarts a pending countdown
+    }
+}
+
+// Adapters added or removed while running. Only those are matched or
+// dropped; the others keep their options, candidates and selections. A
+// hardware-filtered catalog may lack the new adapter's profiles, so that
+// case takes the full reload and re-match instead.
+void MainWindow::ApplyHardwareChanges() {
+    const std::vector<GpuChange> changes = hardwareWatcher_->CollectChanges(state_.snapshot.gpus);
+    if (changes.empty()) {
+        return;
+    }
+    QStringList described;
+    for (const auto& change : changes) {
+        described << QStringLiteral("%1 %2")
+                         .arg(change.kind == GpuChange::Kind::Added ? QStringLiteral("added")
+                                                                    : QStringLiteral("removed"))
+                         .arg(QString::fromWCharArray(change.gpu.name.c_str()));
+    }
+    const QString status = QStringLiteral("GPU %1").arg(described.join(QStringLiteral(", ")));
+    const bool incremental = state_.initialized && !state_.profiles.IsPartial();
+    for (const auto& change : changes) {
+        ApplyGpuChange(state_.snapshot.gpus, change);
+        if (!state_.initialized) {
+            continue;
+        }
+        // Adapter state moves along, so selections stay with their adapter.
+        const auto at = state_.gpus.begin() + static_cast<std::ptrdiff_t>(change.index);
+        if (change.kind == GpuChange::Kind::Added) {
+            state_.gpus.insert(at, GpuAdapterState{});
+            if (state_.gpus.size() > 1 && state_.currentGpu >= change.index) {
+                ++state_.currentGpu;
+            }
+        } else {
+            state_.gpus.erase(at);
+            if (state_.currentGpu > change.index) {
+                --state_.currentGpu;
+            }
+        }
+        if (!incremental) {
+            continue;
+        }
+        if (change.kind == GpuChange::Kind::Added) {
+            state_.engine.AddGpuAdapter(change.index, change.gpu, state_.profiles);
+            SyncGpuAdapter(change.index);
+        } else {
+            state_.engine.RemoveGpuAdapter(change.index);
+        }
+    }
+    if (!incremental) {
+        UpdateSnapshotLabel();
+        if (state_.initialized) {
+            RematchHardware(status);
+        }
+        return;
+    }
+    PopulateGpuAdapters();
+    UpdateSnapshotLabel();
+    UpdateButtonStates();
+    UpdateBenchmarkLabels();
+    SaveStartupCache();
+    UpdateStatus(status);
+}
+
+void MainWindow::ReloadProfiles() {
+    ProfileLoader loader;
+    ProfileCatalog next;
+    try {
+        // Full load, so the diff covers every profile and not only the
+        // ones the startup filter kept.
+        next = loader.LoadCatalog(profilePath_);
+    } catch (const std::exception& ex) {
+        UpdateStatus(QStringLiteral("Profile reload failed, keeping previous catalog: %1").arg(ex.what()));
+        return;
+    }
+    // Same source as the full catalog in use: only profiles.bin was
+    // rewritten, e.g. by StartFullCatalogLoad.
+    if (state_.initialized && !state_.profiles.IsPartial() && next.SourceHash() == state_.profiles.SourceHash()) {
+        return;
+    }
+
+    const CatalogDiff diff = ProfileCatalog::Diff(state_.profiles, next);
+    const std::string cpuTargetId = SelectedCpuTargetId();
+    const std::vector<std::string> gpuTargetIds = SelectedGpuTargetIds();
+    const bool refresh = !state_.initialized || state_.engine.IsAffectedBy(diff, state_.snapshot, next);
+    // Against the hardware-filtered startup catalog every unmatched profile
+    // shows up as added, so the counts would mislead.
+    const bool describeDiff = !state_.profiles.IsPartial() && !diff.Empty();
+
+    // Rows and candidates index the old catalog; selections come back by id.
+    ClearSelection();
+    state_.profiles = std::move(next);
+
+    if (refresh || !state_.engine.Rebind(state_.profiles)) {
+        state_.engine.Refresh(state_.snapshot, state_.profiles);
+        if (!state_.initialized) {
+            state_.initialized = true;
+            cpuList_->setEnabled(true);
+            gpuList_->setEnabled(true);
+        }
+    }
+    // Any profile may have moved in the index, so the candidates are
+    // re-ranked even when the options only rebound.
+    SyncEngineResults();
+    PopulateLists();
+    RestoreSelection(cpuTargetId, gpuTargetIds);
+    UpdateButtonStates();
+    UpdateBenchmarkLabels();
+    SaveStartupCache();
+    if (describeDiff) {
+        UpdateStatus(QStringLiteral("Profiles reloaded (%1)").arg(DescribeDiff(diff)));
+    } else {
+        UpdateStatus(diff.Empty() ? QStringLiteral("Profiles reloaded, no changes")
+                                  : QStringLiteral("Profiles reloaded"));
+    }
+}
+
+// Copies the per-refresh engine results into the app state; selections
+// are left to RestoreSelection. A hardware-filtered catalog holds too few
+// profiles to rank, so it offers no candidates until the full catalog
+// from StartFullCatalogLoad (or a reload) replaces it.
+void MainWindow::SyncEngineResults() {
+    const bool rank = !state_.profiles.IsPartial();
+    state_.cpuNominalFrequencyMHz = state_.engine.CpuNominalFrequencyMHz();
+    state_.cpuCandidates = rank ? state_.engine.CpuCandidates(state_.profiles) : std::vector<std::uint32_t>();
+    state_.gpus.resize(state_.engine.GpuAdapterCount());
+    for (size_t i = 0; i < state_.gpus.size(); ++i) {
+        SyncGpuAdapter(i);
+    }
+}
+
+void MainWindow::SyncGpuAdapter(size_t adapter) {
+    const bool rank = !state_.profiles.IsPartial();
+    GpuAdapterState& state = state_.gpus[adapter];
+    state.candidates = rank ? state_.engine.GpuCandidates(adapter, state_.profiles) : std::vector<std::uint32_t>();
+    state.nominalClockMHz = state_.engine.GpuNominalFrequencyMHz(adapter);
+    state.nominalPowerWatts = state_.engine.GpuNominalPowerWatts(adapter);
 }
 
 void MainWindow::PopulateLists() {
     cpuList_->clear();
-    for (const auto& option : state_.cpuOptions) {
-        cpuList_->addItem(QString::fromStdString(option.label));
+    for (const auto option : state_.engine.CpuOptions()) {
+        cpuList_->addItem(ToQString(state_.profiles.CpuTarget(option).Label()));
+    }
+    const auto cpuProfiles = state_.profiles.CpuProfiles();
+    for (const std::uint32_t candidate : state_.cpuCandidates) {
+        cpuList_->addItem(CandidateLabel(cpuProfiles[candidate].Label()));
+    }
+    PopulateGpuAdapters();
+}
+
+// Refills the adapter picker and the current adapter's list, leaving the
+// CPU list (and its selection) alone.
+void MainWindow::PopulateGpuAdapters() {
+    {
+        const QSignalBlocker blocker(gpuAdapterBox_);
+        gpuAdapterBox_->clear();
+        for (size_t i = 0; i < state_.gpus.size(); ++i) {
+            gpuAdapterBox_->addItem(AdapterLabel(state_.snapshot.gpus, i));
+        }
+        if (state_.currentGpu >= state_.gpus.size()) {
+            state_.currentGpu = 0;
+        }
+        gpuAdapterBox_->setCurrentIndex(state_.gpus.empty() ? -1 : static_cast<int>(state_.currentGpu));
     }
+    gpuAdapterBox_->setVisible(state_.gpus.size() > 1);
+    PopulateGpuList();
+}
+
+// Shows the current adapter's options with its own selection; the list
+// signals are blocked so refilling it does not clear that selection.
+void MainWindow::PopulateGpuList() {
+    const QSignalBlocker blocker(gpuList_);
     gpuList_->clear();
-    for (const auto& option : state_.gpuOptions) {
-        gpuList_->addItem(QString::fromStdString(option.label));
+    if (state_.currentGpu >= state_.gpus.size()) {
+        return;
+    }
+    const GpuAdapterState& adapter = state_.gpus[state_.currentGpu];
+    for (const auto option : state_.engine.GpuOptions(state_.currentGpu)) {
+        gpuList_->addItem(ToQString(state_.profiles.GpuTarget(option).Label()));
+    }
+    const auto gpuProfiles = state_.profiles.GpuProfiles();
+    for (const std::uint32_t candidate : adapter.candidates) {
+        gpuList_->addItem(CandidateLabel(gpuProfiles[candidate].Label()));
+    }
+    gpuList_->setCurrentRow(adapter.selected ? adapter.selectedRow : -1);
+}
+
+// Rows list the engine's options, then the candidates; a listed tier is
+// copied out of the catalog, a candidate's target synthesized here.
+std::optional<CpuThrottleTarget> MainWindow::CpuTargetAtRow(int row) const {
+    const auto options = state_.engine.CpuOptions();
+    if (row < 0) {
+        return std::nullopt;
+    }
+    const auto index = static_cast<size_t>(row);
+    if (index < options.size()) {
+        return state_.profiles.CpuTarget(options[index]).Materialize();
+    }
+    if (index - options.size() < state_.cpuCandidates.size()) {
+        return state_.engine.SynthesizeCpuTarget(state_.cpuCandidates[index - options.size()], state_.profiles);
+    }
+    return std::nullopt;
+}
+
+std::optional<GpuThrottleTarget> MainWindow::GpuTargetAtRow(size_t adapter, int row) const {
+    const auto options = state_.engine.GpuOptions(adapter);
+    const auto& candidates = state_.gpus[adapter].candidates;
+    if (row < 0) {
+        return std::nullopt;
+    }
+    const auto index = static_cast<size_t>(row);
+    if (index < options.size()) {
+        return state_.profiles.GpuTarget(options[index]).Materialize();
+    }
+    if (index - options.size() < candidates.size()) {
+        return state_.engine.SynthesizeGpuTarget(adapter, candidates[index - options.size()], state_.profiles);
+    }
+    return std::nullopt;
+}
+
+std::string MainWindow::SelectedCpuTargetId() const {
+    return state_.selectedCpu ? state_.selectedCpu->id : std::string();
+}
+
+// Per adapter; empty where nothing is selected.
+std::vector<std::string> MainWindow::SelectedGpuTargetIds() const {
+    std::vector<std::string> ids;
+    for (const auto& adapter : state_.gpus) {
+        ids.push_back(adapter.selected ? adapter.selected->id : std::string());
+    }
+    return ids;
+}
+
+void MainWindow::ClearSelection() {
+    state_.selectedCpu.reset();
+    for (auto& adapter : state_.gpus) {
+        adapter.selected.reset();
+        adapter.selectedRow = -1;
+    }
+}
+
+// Reselects the targets with the given ids, if they are still offered;
+// an empty id means nothing was selected. `gpuTargetIds` is per adapter.
+// Candidates are matched by synthesizing their targets, which is cheap
+// next to a reload.
+void MainWindow::RestoreSelection(const std::string& cpuTargetId, const std::vector<std::string>& gpuTargetIds) {
+    const auto findRow = [](const std::string& id, size_t rows, const auto& targetAt) {
+        for (size_t row = 0; !id.empty() && row < rows; ++row) {
+            const auto target = targetAt(static_cast<int>(row));
+            if (target && target->id == id) {
+                return static_cast<int>(row);
+            }
+        }
+        return -1;
+    };
+    const int cpuRow = findRow(cpuTargetId, state_.engine.CpuOptions().size() + state_.cpuCandidates.size(),
+                               [&](int row) { return CpuTargetAtRow(row); });
+    for (size_t i = 0; i < state_.gpus.size() && i < gpuTargetIds.size(); ++i) {
+        GpuAdapterState& adapter = state_.gpus[i];
+        adapter.selectedRow = findRow(gpuTargetIds[i], state_.engine.GpuOptions(i).size() + adapter.candidates.size(),
+                                      [&](int row) { return GpuTargetAtRow(i, row); });
+        adapter.selected = GpuTargetAtRow(i, adapter.selectedRow);
     }
+
+    // setCurrentRow only signals on a change, so also resolve directly.
+    cpuList_->setCurrentRow(cpuRow);
+    HandleCpuSelection(cpuRow);
+    PopulateGpuList();
+    UpdateButtonStates();
+    UpdateBenchmarkLabels();
 }
 
 void MainWindow::UpdateSnapshotLabel() {
@@ -193,21 +895,26 @@ void MainWindow::UpdateSnapshotLabel() {
 }
 
 void MainWindow::HandleCpuSelection(int row) {
-    if (row >= 0 && row < static_cast<int>(state_.cpuOptions.size())) {
-        state_.selectedCpu = state_.cpuOptions[static_cast<size_t>(row)];
-    } else {
-        state_.selectedCpu.reset();
-    }
+    state_.selectedCpu = CpuTargetAtRow(row);
     UpdateButtonStates();
     UpdateBenchmarkLabels();
 }
 
+void MainWindow::HandleGpuAdapterChanged(int index) {
+    if (index < 0 || index >= static_cast<int>(state_.gpus.size())) {
+        return;
+    }
+    state_.currentGpu = static_cast<size_t>(index);
+    PopulateGpuList();
+}
+
 void MainWindow::HandleGpuSelection(int row) {
-    if (row >= 0 && row < static_cast<int>(state_.gpuOptions.size())) {
-        state_.selectedGpu = state_.gpuOptions[static_cast<size_t>(row)];
-    } else {
-        state_.selectedGpu.reset();
+    if (state_.currentGpu >= state_.gpus.size()) {
+        return;
     }
+    GpuAdapterState& adapter = state_.gpus[state_.currentGpu];
+    adapter.selected = GpuTargetAtRow(state_.currentGpu, row);
+    adapter.selectedRow = adapter.selected ? row : -1;
     UpdateButtonStates();
     UpdateBenchmarkLabels();
 }
@@ -217,36 +924,90 @@ void MainWindow::ApplyCpuTarget() {
         UpdateStatus(QStringLiteral("Select a CPU target first"));
         return;
     }
-    if (state_.selectedCpu->requiresConfirmation) {
-        const auto label = QString::fromStdString(state_.selectedCpu->label);
+    const CpuThrottleTarget& target = *state_.selectedCpu;
+    if (target.requiresConfirmation) {
+        const auto label = ToQString(target.label);
         if (!ConfirmHighImpact(label)) {
             UpdateStatus(QStringLiteral("Action cancelled by user"));
             return;
         }
     }
-    auto result = state_.throttler.ApplyCpuTarget(*state_.selectedCpu);
+    auto result = state_.throttler.ApplyCpuTarget(target);
+    if (result.success) {
+        appliedCpuTarget_ = target.id;
+    }
     UpdateStatus(QString::fromWCharArray(result.message.c_str()));
 }
 
-void MainWindow::ApplyGpuTarget() {
-    if (!state_.selectedGpu) {
+// Applies every adapter's selected target at once; the adapters are
+// configured concurrently and the status line reports each one.
+void MainWindow::ApplyGpuTargets() {
+    std::vector<GpuAdapterTarget> targets;
+    std::vector<size_t> adapters;
+    QStringList report;
+    QStringList highImpact;
+    for (size_t i = 0; i < state_.gpus.size(); ++i) {
+        if (!state_.gpus[i].selected) {
+            continue;
+        }
+        const GpuThrottleTarget& target = *state_.gpus[i].selected;
+        auto device = NvidiaSmiDevice(state_.snapshot.gpus[i]);
+        if (!device) {
+            report << QStringLiteral("GPU %1: not an NVIDIA adapter at a known PCI location").arg(i);
+            continue;
+        }
+        if (target.requiresConfirmation) {
+            highImpact << ToQString(target.label);
+        }
+        targets.push_back({*std::move(device), target});
+        adapters.push_back(i);
+    }
+    if (targets.empty() && report.isEmpty()) {
         UpdateStatus(QStringLiteral("Select a GPU target first"));
         return;
     }
-    if (state_.selectedGpu->requiresConfirmation) {
-        const auto label = QString::fromStdString(state_.selectedGpu->label);
-        if (!ConfirmHighImpact(label)) {
-            UpdateStatus(QStringLiteral("Action cancelled by user"));
-            return;
+    if (!highImpact.isEmpty() && !ConfirmHighImpact(highImpact.join(QStringLiteral("\", \"")))) {
+        UpdateStatus(QStringLiteral("Action cancelled by user"));
+        return;
+    }
+    const auto results = state_.throttler.ApplyGpuTargets(targets);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (adapters[i] == 0 && results[i].result.success) {
+            appliedGpuTarget_ = targets[i].target.id;
         }
+        report << QStringLiteral("GPU %1: %2")
+                      .arg(adapters[i])
+                      .arg(QString::fromWCharArray(results[i].result.message.c_str()));
     }
-    auto result = state_.throttler.ApplyGpuTarget(*state_.selectedGpu);
-    UpdateStatus(QString::fromWCharArray(result.message.c_str()));
+    UpdateStatus(report.join(QStringLiteral("; ")));
 }
 
 void MainWindow::RestoreDefaults() {
     auto result = state_.throttler.RestoreDefaults();
-    UpdateStatus(QString::fromWCharArray(result.message.c_str()));
+    if (result.success) {
+        appliedCpuTarget_.clear();
+    }
+    QStringList report;
+    report << QString::fromWCharArray(result.message.c_str());
+
+    std::vector<GpuAdapterDefaults> defaults;
+    std::vector<size_t> adapters;
+    for (size_t i = 0; i < state_.gpus.size(); ++i) {
+        if (auto device = NvidiaSmiDevice(state_.snapshot.gpus[i])) {
+            defaults.push_back({*std::move(device)});
+            adapters.push_back(i);
+        }
+    }
+    const auto results = state_.throttler.RestoreGpuDefaults(defaults);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (adapters[i] == 0 && results[i].result.success) {
+            appliedGpuTarget_.clear();
+        }
+        report << QStringLiteral("GPU %1: %2")
+                      .arg(adapters[i])
+                      .arg(QString::fromWCharArray(results[i].result.message.c_str()));
+    }
+    UpdateStatus(report.join(QStringLiteral("; ")));
 }
 
 void MainWindow::UpdateStatus(const QString& text) {
@@ -259,7 +1020,8 @@ void MainWindow::UpdateStatus(const QString& text) {
 
 void MainWindow::UpdateButtonStates() {
     const bool hasCpu = state_.selectedCpu.has_value();
-    const bool hasGpu = state_.selectedGpu.has_value();
+    const bool hasGpu = std::any_of(state_.gpus.begin(), state_.gpus.end(),
+                                    [](const GpuAdapterState& adapter) { return adapter.selected.has_value(); });
     applyCpuButton_->setEnabled(hasCpu);
     applyGpuButton_->setEnabled(hasGpu);
     restoreButton_->setEnabled(state_.initialized);
@@ -273,31 +1035,161 @@ void MainWindow::RunCurrentBenchmark() {
     RunBenchmark(false);
 }
 
+// The run happens on benchmarkThread_ with a copy of the snapshot, so the
+// window stays usable; progress, each finished part and the final report
+// are posted back to this thread. Every measured part goes into the
+// history, and a baseline takes the parts the history already has for
+// this configuration instead of measuring them again.
 void MainWindow::RunBenchmark(bool baseline) {
-    BenchmarkRunner runner;
-    QApplication::setOverrideCursor(Qt::BusyCursor);
-    UpdateStatus(baseline ? QStringLiteral("Running baseline benchmark...")
-                          : QStringLiteral("Running current benchmark..."));
-    const auto report = runner.Run(state_.snapshot);
-    QApplication::restoreOverrideCursor();
+    if (benchmarkControl_) {
+        return;
+    }
+    BenchmarkOptions options;
+    options.cpuMode = perCoreCheck_->isChecked() ? CpuBenchmarkMode::PerCore : CpuBenchmarkMode::Aggregate;
+    options.memory = memoryCheck_->isChecked();
+    options.memoryOptions.hugePages = hugePagesCheck_->isChecked();
+    options.repetitions = repetitionsBox_->value();
+    benchmarkBaseline_ = baseline;
+    options.workloads = workloadsCheck_->isChecked();
+    benchmarkMemory_ = options.memory;
+    benchmarkWorkloads_ = options.workloads;
+    options.sustainedSeconds = sustainedBox_->value();
+    benchmarkSustained_ = options.sustainedSeconds > 0;
+    options.scaling = scalingCheck_->isChecked();
+    benchmarkScaling_ = options.scaling;
 
+    if (!benchmarkHistory_) {
+        benchmarkHistory_ = std::make_unique<BenchmarkHistory>(BenchmarkHistory::DefaultPath());
+    }
+    const BenchmarkRunKeys keys =
+        MakeRunKeys(hardwareFingerprint_, appliedCpuTarget_, appliedGpuTarget_, options);
+    BenchmarkReport reused;
     if (baseline) {
-        state_.benchmark.baselineCpu = report.cpu;
-        state_.benchmark.baselineGpu = report.gpu;
+        reused = ReuseStoredRuns(*benchmarkHistory_, keys, options);
+    }
+    const bool anyReused =
+        reused.cpu || reused.gpu || reused.memory || reused.workloads || reused.sustained || reused.scaling;
+    if (!options.cpu && !options.gpu && !options.memory && !options.workloads && options.sustainedSeconds == 0 &&
+        !options.scaling) {
+        StoreBenchmarkReport(reused, true);
+        UpdateStatus(QStringLiteral("Baseline taken from the benchmark history"));
+        return;
+    }
+    if (anyReused) {
+        StoreBenchmarkReport(reused, false);
+    }
+
+    benchmarkControl_ = std::make_shared<BenchmarkControl>([this](const BenchmarkProgress& progress) {
+        QMetaObject::invokeMethod(
+            this, [this, progress] { HandleBenchmarkProgress(progress); }, Qt::QueuedConnection);
+    });
+
+    if (benchmarkThread_.joinable()) {
+        benchmarkThread_.join();  // the previous run's, already finished
+    }
+    SetBenchmarkRunning(true);
+    benchmarkProgress_->setValue(0);
+    if (anyReused) {
+        UpdateStatus(QStringLiteral("Running baseline benchmark (the rest from the history)..."));
     } else {
-        state_.benchmark.currentCpu = report.cpu;
-        state_.benchmark.currentGpu = report.gpu;
+        UpdateStatus(baseline ? QStringLiteral("Running baseline benchmark...")
+                              : QStringLiteral("Running current benchmark..."));
+    }
+    // Only this thread uses the history until the run finishes.
+    benchmarkThread_ = std::thread([this, control = benchmarkControl_, snapshot = state_.snapshot, options, keys,
+                                    reused, history = benchmarkHistory_.get()] {
+        BenchmarkReport report =
+            BenchmarkRunner().Run(snapshot, options, control.get(), [this](const BenchmarkReport& partial) {
+                QMetaObject::invokeMethod(
+                    this, [this, partial] { StoreBenchmarkReport(partial, false); }, Qt::QueuedConnection);
+            });
+        std::vector<RegressionCheck> checks = RecordRuns(*history, keys, options, report);
+        for (auto [slot, stored] : {std::pair{&report.cpu, &reused.cpu}, std::pair{&report.gpu, &reused.gpu},
+                                    std::pair{&report.memory, &reused.memory},
+                                    std::pair{&report.workloads, &reused.workloads},
+                                    std::pair{&report.sustained, &reused.sustained},
+                                    std::pair{&report.scaling, &reused.scaling}}) {
+            if (*stored) {
+                *slot = *stored;
+            }
+        }
+        QMetaObject::invokeMethod(
+            this, [this, report, checks = std::move(checks)] { FinishBenchmark(report, checks); },
+            Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::CancelBenchmark() {
+    if (benchmarkControl_) {
+        benchmarkControl_->Cancel();
+        cancelBenchmarkButton_->setEnabled(false);
+        UpdateStatus(QStringLiteral("Cancelling benchmark..."));
+    }
+}
+
+void MainWindow::HandleBenchmarkProgress(const BenchmarkProgress& progress) {
+    if (!benchmarkControl_ || benchmarkControl_->Cancelled()) {
+        return;
+    }
+    benchmarkProgress_->setValue(static_cast<int>(progress.fraction * benchmarkProgress_->maximum()));
+    UpdateStatus(QStringLiteral("Benchmarking: %1").arg(QString::fromStdString(progress.step)));
+}
+
+// Partial reports only carry the parts done so far, so they only replace
+// those; a complete one also clears what the run found nothing for (no
+// GPU compute device, say), as a fresh run should.
+void MainWindow::StoreBenchmarkReport(const BenchmarkReport& report, bool complete) {
+    const auto store = [complete](std::optional<BenchmarkResultData>& slot,
+                                  const std::optional<BenchmarkResultData>& result) {
+        if (result || complete) {
+            slot = result;
+        }
+    };
+    BenchmarkSnapshot& benchmark = state_.benchmark;
+    store(benchmarkBaseline_ ? benchmark.baselineCpu : benchmark.currentCpu, report.cpu);
+    store(benchmarkBaseline_ ? benchmark.baselineGpu : benchmark.currentGpu, report.gpu);
+    if (benchmarkMemory_) {
+        store(benchmarkBaseline_ ? benchmark.baselineMemory : benchmark.currentMemory, report.memory);
+    }
+    if (benchmarkWorkloads_) {
+        store(benchmarkBaseline_ ? benchmark.baselineWorkloads : benchmark.currentWorkloads, report.workloads);
+    }
+    if (benchmarkSustained_) {
+        store(benchmarkBaseline_ ? benchmark.baselineSustained : benchmark.currentSustained, report.sustained);
+    }
+    if (benchmarkScaling_) {
+        store(benchmarkBaseline_ ? benchmark.baselineScaling : benchmark.currentScaling, report.scaling);
     }
     UpdateBenchmarkLabels();
-    UpdateStatus(QStringLiteral("Benchmark complete"));
+}
+
+void MainWindow::FinishBenchmark(const BenchmarkReport& report, const std::vector<RegressionCheck>& checks) {
+    if (benchmarkThread_.joinable()) {
+        benchmarkThread_.join();
+    }
+    benchmarkControl_.reset();
+    StoreBenchmarkReport(report, !report.cancelled);
+    SetBenchmarkRunning(false);
+    benchmarkProgress_->setValue(report.cancelled ? 0 : benchmarkProgress_->maximum());
+    UpdateStatus((report.cancelled ? QStringLiteral("Benchmark cancelled") : QStringLiteral("Benchmark complete")) +
+                 DescribeRegressions(checks));
+}
+
+void MainWindow::SetBenchmarkRunning(bool running) {
+    runBaselineButton_->setEnabled(!running);
+    runCurrentButton_->setEnabled(!running);
+    cancelBenchmarkButton_->setEnabled(running);
 }
 
 QString MainWindow::FormatScoreLabel(const std::optional<BenchmarkResultData>& data) const {
     if (!data) {
         return QStringLiteral("N/A");
     }
-    return QString::number(data->score, 'f', 2) + QStringLiteral(" ") +
-           QString::fromStdString(data->unit);
+    QString text = QString::number(data->score, 'f', 2) + QStringLiteral(" ") + QString::fromStdString(data->unit);
+    if (data->stats.samples > 1) {
+        text += QStringLiteral(" \u00B1 ") + QString::number(data->stats.mad, 'f', 2);  // MAD
+    }
+    return text;
 }
 
 void MainWindow::UpdateBenchmarkLabels() {
@@ -305,7 +1197,8 @@ void MainWindow::UpdateBenchmarkLabels() {
     cpuBaselineLabel_->setToolTip(state_.benchmark.baselineCpu
                                       ? QString::fromStdString(state_.benchmark.baselineCpu->details)
                                       : QString());
-    cpuCurrentLabel_->setText(FormatScoreLabel(state_.benchmark.currentCpu));
+    cpuCurrentLabel_->setText(FormatScoreLabel(state_.benchmark.currentCpu) +
+                              DescribeChange(state_.benchmark.baselineCpu, state_.benchmark.currentCpu));
     cpuCurrentLabel_->setToolTip(state_.benchmark.currentCpu
                                      ? QString::fromStdString(state_.benchmark.currentCpu->details)
                                      : QString());
@@ -322,7 +1215,8 @@ void MainWindow::UpdateBenchmarkLabels() {
     gpuBaselineLabel_->setToolTip(state_.benchmark.baselineGpu
                                       ? QString::fromStdString(state_.benchmark.baselineGpu->details)
                                       : QString());
-    gpuCurrentLabel_->setText(FormatScoreLabel(state_.benchmark.currentGpu));
+    gpuCurrentLabel_->setText(FormatScoreLabel(state_.benchmark.currentGpu) +
+                              DescribeChange(state_.benchmark.baselineGpu, state_.benchmark.currentGpu));
     gpuCurrentLabel_->setToolTip(state_.benchmark.currentGpu
                                      ? QString::fromStdString(state_.benchmark.currentGpu->details)
                                      : QString());
@@ -334,6 +1228,66 @@ void MainWindow::UpdateBenchmarkLabels() {
     } else {
         gpuExpectedLabel_->setText(QStringLiteral("N/A"));
     }
+
+    // Profiles cap clocks and power but say nothing about memory, so there
+    // is no expected memory score; baseline and current compare directly.
+    memoryBaselineLabel_->setText(FormatScoreLabel(state_.benchmark.baselineMemory));
+    memoryBaselineLabel_->setToolTip(state_.benchmark.baselineMemory
+                                         ? QString::fromStdString(state_.benchmark.baselineMemory->details)
+                                         : QString());
+    memoryCurrentLabel_->setText(FormatScoreLabel(state_.benchmark.currentMemory) +
+                                 DescribeChange(state_.benchmark.baselineMemory, state_.benchmark.currentMemory));
+    memoryCurrentLabel_->setToolTip(state_.benchmark.currentMemory
+                                        ? QString::fromStdString(state_.benchmark.currentMemory->details)
+                                        : QString());
+
+    // Neither is there an expected workload score, but each workload's
+    // change is listed, since a target can cost one far more than another.
+    workloadsBaselineLabel_->setText(FormatScoreLabel(state_.benchmark.baselineWorkloads));
+    workloadsBaselineLabel_->setToolTip(state_.benchmark.baselineWorkloads
+                                            ? QString::fromStdString(state_.benchmark.baselineWorkloads->details)
+                                            : QString());
+    workloadsCurrentLabel_->setText(
+        FormatScoreLabel(state_.benchmark.currentWorkloads) +
+        DescribeChange(state_.benchmark.baselineWorkloads, state_.benchmark.currentWorkloads));
+    workloadsCurrentLabel_->setToolTip(
+        state_.benchmark.currentWorkloads
+            ? QString::fromStdString(state_.benchmark.currentWorkloads->details) +
+                  DescribeKernelChanges(state_.benchmark.baselineWorkloads, *state_.benchmark.currentWorkloads)
+            : QString());
+
+    sustainedBaselineLabel_->setText(FormatScoreLabel(state_.benchmark.baselineSustained));
+    sustainedBaselineLabel_->setToolTip(state_.benchmark.baselineSustained
+                                            ? QString::fromStdString(state_.benchmark.baselineSustained->details)
+                                            : QString());
+    sustainedCurrentLabel_->setText(
+        FormatScoreLabel(state_.benchmark.currentSustained) +
+        DescribeChange(state_.benchmark.baselineSustained, state_.benchmark.currentSustained));
+    sustainedCurrentLabel_->setToolTip(state_.benchmark.currentSustained
+                                           ? QString::fromStdString(state_.benchmark.currentSustained->details)
+                                           : QString());
+    sustainedCurve_->SetRuns(state_.benchmark.baselineSustained, state_.benchmark.currentSustained);
+
+    // The current run is read against the selected target's core and
+    // thread limits, as the expected CPU score is against its caps.
+    scalingBaselineLabel_->setText(FormatScoreLabel(state_.benchmark.baselineScaling));
+    scalingBaselineLabel_->setToolTip(state_.benchmark.baselineScaling
+                                          ? QString::fromStdString(state_.benchmark.baselineScaling->details)
+                                          : QString());
+    scalingCurrentLabel_->setText(FormatScoreLabel(state_.benchmark.currentScaling) +
+                                  DescribeChange(state_.benchmark.baselineScaling, state_.benchmark.currentScaling));
+    QString scalingTip;
+    if (state_.benchmark.currentScaling) {
+        scalingTip = QString::fromStdString(state_.benchmark.currentScaling->details);
+        if (state_.selectedCpu) {
+            const std::string comparison = CompareScaling(*state_.benchmark.currentScaling,
+                                                          state_.selectedCpu->maxCores, state_.selectedCpu->maxThreads);
+            if (!comparison.empty()) {
+                scalingTip += QStringLiteral("\n") + QString::fromStdString(comparison);
+            }
+        }
+    }
+    scalingCurrentLabel_->setToolTip(scalingTip);
 }
 
 std::optional<double> MainWindow::ComputeExpectedCpuScore() const {
@@ -342,34 +1296,26 @@ std::optional<double> MainWindow::ComputeExpectedCpuScore() const {
         return std::nullopt;
     }
     const double base = state_.benchmark.baselineCpu->score;
-    const double percent = state_.selectedCpu->maxPercent > 0
-                               ? static_cast<double>(state_.selectedCpu->maxPercent) / 100.0
-                               : 1.0;
-    double freqFactor = 1.0;
-    if (state_.cpuNominalFrequencyMHz > 0 && state_.selectedCpu->maxFrequencyMHz > 0) {
-        freqFactor = static_cast<double>(state_.selectedCpu->maxFrequencyMHz) /
-                     static_cast<double>(state_.cpuNominalFrequencyMHz);
-    }
-    const double factor = std::clamp(std::min(percent, freqFactor), 0.05, 1.0);
+    const CpuThrottleTarget& target = *state_.selectedCpu;
+    const double projected = ProjectedCpuFactor(target.maxPercent, target.maxFrequencyMHz,
+                                                static_cast<int>(state_.cpuNominalFrequencyMHz));
+    const double factor = std::clamp(projected, 0.05, 1.0);
     return base * factor;
 }
 
+// The GPU benchmark runs on the default adapter, so the projection uses
+// the first adapter's selection.
 std::optional<double> MainWindow::ComputeExpectedGpuScore() const {
-    if (!state_.benchmark.baselineGpu || !state_.selectedGpu ||
+    if (!state_.benchmark.baselineGpu || state_.gpus.empty() || !state_.gpus.front().selected ||
         state_.benchmark.baselineGpu->score <= 0.0) {
         return std::nullopt;
     }
-    double freqFactor = 1.0;
-    if (state_.gpuNominalClockMHz > 0 && state_.selectedGpu->maxFrequencyMHz > 0) {
-        freqFactor = static_cast<double>(state_.selectedGpu->maxFrequencyMHz) /
-                     static_cast<double>(state_.gpuNominalClockMHz);
-    }
-    double powerFactor = 1.0;
-    if (state_.gpuNominalPowerWatts > 0 && state_.selectedGpu->powerLimitWatts > 0) {
-        powerFactor = static_cast<double>(state_.selectedGpu->powerLimitWatts) /
-                      static_cast<double>(state_.gpuNominalPowerWatts);
-    }
-    const double factor = std::clamp(std::min(freqFactor, powerFactor), 0.05, 1.0);
+    const GpuAdapterState& adapter = state_.gpus.front();
+    const GpuThrottleTarget& target = *adapter.selected;
+    const double projected =
+        ProjectedGpuFactor(target.maxFrequencyMHz, target.powerLimitWatts, static_cast<int>(adapter.nominalClockMHz),
+                           static_cast<int>(adapter.nominalPowerWatts));
+    const double factor = std::clamp(projected, 0.05, 1.0);
     return state_.benchmark.baselineGpu->score * factor;
 }
 
@@ -396,9 +1342,23 @@ std::filesystem::path MainWindow::ResolveProfilesPath() const {
 #else
     path = std::filesystem::path(appDir.toStdString()) / "profiles.json";
 #endif
-    if (std::filesystem::exists(path)) {
+    std::filesystem::path compiled = path;
+    compiled.replace_extension(".bin");
+    if (std::filesystem::exists(path) || std::filesystem::exists(compiled)) {
         return path;
     }
     std::filesystem::path fallback = std::filesystem::current_path() / "resources" / "profiles.json";
     return fallback;
 }
+
+std::filesystem::path MainWindow::ResolveStartupCachePath() const {
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (dir.isEmpty()) {
+        return {};
+    }
+#ifdef _WIN32
+    return std::filesystem::path(dir.toStdWString()) / "startup.bin";
+#else
+    return std::filesystem::path(dir.toStdString()) / "startup.bin";
+#endif
+}
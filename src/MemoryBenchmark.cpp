@@ -0,0 +1,469 @@
+#include "MemoryBenchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkStats.hpp"
+#include "CpuTopology.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+constexpr std::uint64_t kKiB = 1024;
+constexpr std::uint64_t kMiB = 1024 * kKiB;
+constexpr std::uint64_t kSweepFirst = 4 * kKiB;
+constexpr std::uint64_t kSweepMin = 64 * kMiB;   // the sweep ends past twice the largest cache, at least here
+constexpr std::uint64_t kSweepCap = 256 * kMiB;
+constexpr std::uint64_t kStreamMin = 64 * kMiB;  // bytes per STREAM array, all threads together
+constexpr std::uint64_t kStreamCap = 256 * kMiB;
+constexpr double kPointSeconds = 0.003;  // per timed call at one sweep size
+constexpr int kPointRepeats = 3;         // timed calls per sweep size and measure; the fastest counts
+constexpr RepeatOptions kStreamRepeats{1, 5};  // per STREAM kernel and thread count; the median counts
+constexpr size_t kLine = 64;
+constexpr double kSweepShare = 0.25;  // of the suite's progress; STREAM is the rest
+
+#ifdef __linux__
+constexpr size_t kHugePage = 2 * kMiB;
+#endif
+
+#ifdef _WIN32
+bool EnableLockMemoryPrivilege() {
+    HANDLE token = nullptr;
+    if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+        return false;
+    }
+    TOKEN_PRIVILEGES privileges{};
+    privileges.PrivilegeCount = 1;
+    privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+    // AdjustTokenPrivileges succeeds without granting a right the account
+    // lacks; only ERROR_SUCCESS means it is enabled.
+    const bool enabled = LookupPrivilegeValueW(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid) &&
+                         AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+                         GetLastError() == ERROR_SUCCESS;
+    CloseHandle(token);
+    return enabled;
+}
+#endif
+
+// One anonymous mapping for a benchmark buffer; Data() is null if the
+// allocation failed.
+class MemoryRegion {
+public:
+    MemoryRegion(size_t bytes, bool hugePages) {
+#ifdef _WIN32
+        if (hugePages && EnableLockMemoryPrivilege()) {
+            if (const SIZE_T large = GetLargePageMinimum(); large != 0) {
+                data_ = VirtualAlloc(nullptr, (bytes + large - 1) / large * large,
+                                     MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (data_) {
+                    backing_ = "large pages";
+                    return;
+                }
+            }
+        }
+        data_ = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        backing_ = hugePages ? "base pages (large pages refused)" : "base pages";
+#else
+#ifdef __linux__
+        if (hugePages) {
+            size_ = (bytes + kHugePage - 1) / kHugePage * kHugePage;
+            base_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (base_ != MAP_FAILED) {
+                data_ = base_;
+                backing_ = "huge pages (hugetlbfs)";
+                return;
+            }
+            // No reserved huge pages: ask for transparent ones instead, on
+            // a mapping aligned to a huge page so all of it qualifies.
+            size_ = bytes + kHugePage;
+        } else {
+            size_ = bytes;
+        }
+#else
+        size_ = bytes;
+#endif
+        base_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            return;
+        }
+        data_ = base_;
+#ifdef __linux__
+        if (hugePages) {
+            const auto address = reinterpret_cast<std::uintptr_t>(base_);
+            data_ = reinterpret_cast<void*>((address + kHugePage - 1) / kHugePage * kHugePage);
+            backing_ = madvise(data_, bytes, MADV_HUGEPAGE) == 0 ? "transparent huge pages"
+                                                                 : "base pages (transparent huge pages disabled)";
+        } else {
+            // Keep THP's "always" mode out of the base-page run.
+            madvise(data_, bytes, MADV_NOHUGEPAGE);
+        }
+#else
+        if (hugePages) {
+            backing_ = "base pages (no huge pages on this OS)";
+        }
+#endif
+#endif
+    }
+
+    ~MemoryRegion() {
+#ifdef _WIN32
+        if (data_) {
+            VirtualFree(data_, 0, MEM_RELEASE);
+        }
+#else
+        if (base_) {
+            munmap(base_, size_);
+        }
+#endif
+    }
+
+    MemoryRegion(const MemoryRegion&) = delete;
+    MemoryRegion& operator=(const MemoryRegion&) = delete;
+
+    void* Data() const { return data_; }
+    const char* Backing() const { return backing_; }
+
+private:
+    void* data_ = nullptr;
+    const char* backing_ = "base pages";
+#ifndef _WIN32
+    void* base_ = nullptr;  // the mapping; data_ may start past it
+    size_t size_ = 0;
+#endif
+};
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Times `run(count)` with the count doubled until one call takes at least
+// kPointSeconds, then twice more at that count; returns the fastest
+// call's seconds per unit of count.
+template <typename Run>
+double TimePerUnit(Run&& run, std::uint64_t count) {
+    const auto time = [&] {
+        const auto start = std::chrono::steady_clock::now();
+        run(count);
+        return SecondsSince(start);
+    };
+    double best = time();
+    while (best < kPointSeconds && count < (std::uint64_t(1) << 40)) {
+        count *= 2;
+        best = time();
+    }
+    for (int repeat = 1; repeat < kPointRepeats; ++repeat) {
+        best = std::min(best, time());
+    }
+    return best / static_cast<double>(count);
+}
+
+// Four accumulators, so the loads and not the adds set the pace.
+std::uint64_t ReadPass(const std::uint64_t* words, size_t count) {
+    std::uint64_t sums[4] = {};
+    for (size_t i = 0; i < count; i += 4) {
+        sums[0] += words[i];
+        sums[1] += words[i + 1];
+        sums[2] += words[i + 2];
+        sums[3] += words[i + 3];
+    }
+    return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+// Links the first `lines` cache lines of `base` into one cycle in random
+// order: each load's address comes from the previous load, and no
+// prefetcher can guess the next line. The links are written in address
+// order, which keeps setting up the DRAM sizes short.
+void LinkChase(std::byte* base, size_t lines, std::mt19937_64& random) {
+    std::vector<std::uint32_t> order(lines);
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), random);
+    std::vector<std::uint32_t> next(lines);
+    for (size_t i = 0; i < lines; ++i) {
+        next[order[i]] = order[(i + 1) % lines];
+    }
+    for (size_t line = 0; line < lines; ++line) {
+        *reinterpret_cast<std::byte**>(base + line * kLine) = base + size_t(next[line]) * kLine;
+    }
+}
+
+std::byte* Chase(std::byte* at, std::uint64_t loads) {
+    for (std::uint64_t i = 0; i < loads; ++i) {
+        at = *reinterpret_cast<std::byte**>(at);
+    }
+    return at;
+}
+
+// The sweep sizes: 4 KiB, 6 KiB, 8 KiB, 12 KiB... (two per octave) up to
+// the first one past twice the largest cache.
+std::vector<std::uint64_t> SweepSizes(const std::vector<CacheLevel>& caches) {
+    std::uint64_t largest = 0;
+    for (const auto& cache : caches) {
+        largest = std::max(largest, cache.bytes);
+    }
+    const std::uint64_t last = std::clamp(2 * largest, kSweepMin, kSweepCap);
+    std::vector<std::uint64_t> sizes;
+    for (std::uint64_t size = kSweepFirst; sizes.empty() || sizes.back() < last; size *= 2) {
+        sizes.push_back(size);
+        if (size * 3 / 2 < last) {
+            sizes.push_back(size * 3 / 2);
+        }
+    }
+    return sizes;
+}
+
+// STREAM's four kernels, as in McCalpin's reference code.
+enum class StreamKernel { Copy, Scale, Add, Triad };
+constexpr std::array kStreamKernels = {StreamKernel::Copy, StreamKernel::Scale, StreamKernel::Add,
+                                       StreamKernel::Triad};
+constexpr double kStreamScalar = 3.0;
+
+// Bytes moved per element: two arrays touched for copy and scale, three
+// for add and triad (write-allocate traffic not counted, like STREAM).
+double StreamBytes(StreamKernel kernel) {
+    return kernel == StreamKernel::Copy || kernel == StreamKernel::Scale ? 16.0 : 24.0;
+}
+
+void RunStreamKernel(StreamKernel kernel, double* a, double* b, double* c, size_t count) {
+    switch (kernel) {
+        case StreamKernel::Copy:
+            for (size_t i = 0; i < count; ++i) {
+                c[i] = a[i];
+            }
+            break;
+        case StreamKernel::Scale:
+            for (size_t i = 0; i < count; ++i) {
+                b[i] = kStreamScalar * c[i];
+            }
+            break;
+        case StreamKernel::Add:
+            for (size_t i = 0; i < count; ++i) {
+                c[i] = a[i] + b[i];
+            }
+            break;
+        case StreamKernel::Triad:
+            for (size_t i = 0; i < count; ++i) {
+                a[i] = b[i] + kStreamScalar * c[i];
+            }
+            break;
+    }
+}
+
+// GB/s of every timed call, per kernel, with `threads` workers, each
+// allocating and first touching its own three arrays of `count` doubles
+// (so they land on its NUMA node), all started together behind a
+// barrier. `next(k)` runs before kernel k; once it returns false the
+// workers skip the remaining calls and the result is empty, as it is if
+// any worker could not allocate.
+template <typename Next>
+std::vector<std::vector<double>> MeasureStream(unsigned threads, size_t count, bool hugePages, Next&& next) {
+    const int calls = kStreamRepeats.warmup + kStreamRepeats.repetitions;
+    std::barrier sync(static_cast<std::ptrdiff_t>(threads) + 1);
+    std::atomic<bool> allocated = true;
+    std::atomic<bool> stopped = false;
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            MemoryRegion region(3 * count * sizeof(double), hugePages);
+            auto* a = static_cast<double*>(region.Data());
+            double* b = a ? a + count : nullptr;
+            double* c = a ? b + count : nullptr;
+            if (a) {
+                std::fill(a, a + count, 1.0);
+                std::fill(b, b + count, 2.0);
+                std::fill(c, c + count, 0.0);
+            } else {
+                allocated = false;
+            }
+            for (const StreamKernel kernel : kStreamKernels) {
+                for (int call = 0; call < calls; ++call) {
+                    sync.arrive_and_wait();
+                    if (a && !stopped) {
+                        RunStreamKernel(kernel, a, b, c, count);
+                        ClobberMemory();
+                    }
+                    sync.arrive_and_wait();
+                }
+            }
+            if (a) {
+                DoNotOptimize(a[count - 1]);
+            }
+        });
+    }
+
+    std::vector<std::vector<double>> rates;
+    for (size_t k = 0; k < kStreamKernels.size(); ++k) {
+        const StreamKernel kernel = kStreamKernels[k];
+        if (!stopped && !next(k)) {
+            stopped = true;
+        }
+        rates.push_back(Repeat(
+            [&] {
+                sync.arrive_and_wait();
+                const auto start = std::chrono::steady_clock::now();
+                sync.arrive_and_wait();
+                return StreamBytes(kernel) * static_cast<double>(count) * threads / SecondsSince(start) / 1e9;
+            },
+            kStreamRepeats));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return allocated && !stopped ? rates : std::vector<std::vector<double>>();
+}
+
+std::string FormatBytes(std::uint64_t bytes) {
+    char buffer[32];
+    if (bytes >= kMiB) {
+        std::snprintf(buffer, sizeof(buffer), "%g MiB", static_cast<double>(bytes) / kMiB);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%g KiB", static_cast<double>(bytes) / kKiB);
+    }
+    return buffer;
+}
+
+std::string FormatValue(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), value < 10.0 ? "%.2f" : "%.1f", value);
+    return buffer;
+}
+
+}  // namespace
+
+std::optional<BenchmarkResultData> MemoryBenchmark::Run(const HardwareSnapshot& snapshot,
+                                                        const MemoryBenchmarkOptions& options,
+                                                        BenchmarkControl* control) const {
+    BenchmarkControl detached;
+    const BenchmarkControl& active = control ? *control : detached;
+    unsigned threads = snapshot.cpu.logicalCores;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const std::vector<CacheLevel> caches = QueryCacheLevels();
+    const std::vector<std::uint64_t> sizes = SweepSizes(caches);
+
+    MemoryRegion sweep(sizes.back(), options.hugePages);
+    if (!sweep.Data()) {
+        return std::nullopt;
+    }
+    auto* base = static_cast<std::byte*>(sweep.Data());
+    std::mt19937_64 random(0x5EED);
+    BenchmarkCurve read{kReadCurve, "KiB", "GB/s", {}};
+    BenchmarkCurve latency{kLatencyCurve, "KiB", "ns", {}};
+    std::string sweepDetails;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        const std::uint64_t size = sizes[i];
+        if (!active.Advance(kSweepShare * static_cast<double>(i) / static_cast<double>(sizes.size()),
+                            "Memory working set " + FormatBytes(size))) {
+            return std::nullopt;
+        }
+        const size_t lines = size / kLine;
+        LinkChase(base, lines, random);
+        const double kib = static_cast<double>(size) / kKiB;
+
+        const auto* words = reinterpret_cast<const std::uint64_t*>(base);
+        const double passSeconds = TimePerUnit(
+            [&](std::uint64_t passes) {
+                for (std::uint64_t pass = 0; pass < passes; ++pass) {
+                    DoNotOptimize(ReadPass(words, size / sizeof(std::uint64_t)));
+                    ClobberMemory();  // or the pass could be hoisted out of the loop
+                }
+            },
+            1);
+        read.points.push_back({kib, static_cast<double>(size) / passSeconds / 1e9});
+
+        // The read passes left the working set cached and its pages mapped
+        // in the TLB, as far as they fit.
+        std::byte* at = base;
+        const double loadSeconds = TimePerUnit([&](std::uint64_t loads) { at = Chase(at, loads); }, 1024);
+        DoNotOptimize(at);
+        latency.points.push_back({kib, loadSeconds * 1e9});
+
+        sweepDetails += "\n" + FormatBytes(size) + ": " + FormatValue(read.points.back().y) + " GB/s, " +
+                        FormatValue(latency.points.back().y) + " ns";
+    }
+
+    // Each array at least four times the caches of the whole machine (the
+    // STREAM rule), within a cap that keeps the run short.
+    std::uint64_t cacheTotal = 0;
+    for (const auto& cache : caches) {
+        cacheTotal += cache.bytes * std::max(1u, threads / cache.sharedBy);
+    }
+    const std::uint64_t arrayBytes = std::clamp(4 * cacheTotal, kStreamMin, kStreamCap);
+    std::vector<unsigned> threadCounts;
+    for (unsigned count = 1; count < threads; count *= 2) {
+        threadCounts.push_back(count);
+    }
+    threadCounts.push_back(threads);
+
+    std::vector<BenchmarkCurve> stream;
+    for (const char* name : kStreamCurves) {
+        stream.push_back({name, "threads", "GB/s", {}});
+    }
+    std::string streamDetails;
+    std::vector<double> triad;  // on all threads: the score's samples
+    for (size_t i = 0; i < threadCounts.size(); ++i) {
+        const unsigned count = threadCounts[i];
+        const size_t elements = static_cast<size_t>(arrayBytes / count / sizeof(double));
+        const auto next = [&](size_t k) {
+            const double done = (static_cast<double>(i) + static_cast<double>(k) / kStreamKernels.size()) /
+                                static_cast<double>(threadCounts.size());
+            return active.Advance(kSweepShare + (1.0 - kSweepShare) * done,
+                                  std::string("Memory STREAM ") + kStreamCurves[k] + ", " + std::to_string(count) +
+                                      (count == 1 ? " thread" : " threads"));
+        };
+        const std::vector<std::vector<double>> rates = MeasureStream(count, elements, options.hugePages, next);
+        if (rates.empty()) {
+            return std::nullopt;
+        }
+        streamDetails += "\n" + std::to_string(count) + (count == 1 ? " thread:" : " threads:");
+        for (size_t k = 0; k < rates.size(); ++k) {
+            const double median = SummarizeSamples(rates[k]).median;
+            stream[k].points.push_back({static_cast<double>(count), median});
+            streamDetails += (k == 0 ? " " : " / ") + FormatValue(median);
+        }
+        triad = rates.back();
+    }
+
+    std::string cacheDetails;
+    for (const auto& cache : caches) {
+        cacheDetails += (cacheDetails.empty() ? "" : ", ") + std::string("L") + std::to_string(cache.level) + " " +
+                        FormatBytes(cache.bytes);
+    }
+
+    BenchmarkResultData result;
+    result.stats = SummarizeSamples(triad);
+    result.score = result.stats.median;
+    result.samples = std::move(triad);
+    result.unit = "GB/s";
+    result.details = "Triad on " + std::to_string(threads) + (threads == 1 ? " thread, " : " threads, ") +
+                     FormatBytes(arrayBytes) + " per array\nGB/s: " + FormatStats(result.stats) +
+                     "\nPages: " + sweep.Backing() +
+                     "\nCaches: " + (cacheDetails.empty() ? std::string("unknown") : cacheDetails) +
+                     "\nWorking set: read (1 thread), load latency" + sweepDetails +
+                     "\nSTREAM GB/s (median of " + std::to_string(kStreamRepeats.repetitions) +
+                     "), copy / scale / add / triad:" + streamDetails;
+    result.curves.push_back(std::move(read));
+    result.curves.push_back(std::move(latency));
+    for (auto& curve : stream) {
+        result.curves.push_back(std::move(curve));
+    }
+    return result;
+}
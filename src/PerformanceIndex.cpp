@@ -0,0 +1,255 @@
+#include "PerformanceIndex.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "ProfileCatalog.hpp"
+
+namespace {
+
+constexpr int kMaxSweeps = 500;
+constexpr double kTolerance = 1e-6;
+
+// Log-score of `to` relative to `from`, as measured by one listed tier.
+struct Ratio {
+    std::uint32_t from;
+    std::uint32_t to;
+    double logRatio;
+};
+
+std::string_view MimickedLabel(std::string_view label) {
+    constexpr std::string_view prefix = "Mimic ";
+    if (label.starts_with(prefix)) {
+        label.remove_prefix(prefix.size());
+    }
+    return label;
+}
+
+// Least-squares fit of the log-scores to the tier ratios by Gauss-Seidel
+// sweeps, then each linked group shifted so its mean matches the mean of
+// its prior (the ratios fix scores only up to such a shift); a profile no
+// ratio touches keeps its prior. Returns scores normalized to a maximum
+// of 1.
+std::vector<double> FitScores(const std::vector<double>& prior, const std::vector<Ratio>& ratios,
+                              const std::vector<std::uint32_t>& groups) {
+    const size_t count = prior.size();
+    // Per profile, the (neighbour, offset) pairs with s[profile] ~ s[neighbour] + offset.
+    std::vector<size_t> start(count + 1, 0);
+    for (const auto& ratio : ratios) {
+        ++start[ratio.from + 1];
+        ++start[ratio.to + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<std::pair<std::uint32_t, double>> links(start.back());
+    std::vector<size_t> fill(start.begin(), start.end() - 1);
+    for (const auto& ratio : ratios) {
+        links[fill[ratio.to]++] = {ratio.from, ratio.logRatio};
+        links[fill[ratio.from]++] = {ratio.to, -ratio.logRatio};
+    }
+
+    std::vector<double> scores = prior;
+    for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+        double largestStep = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            if (start[i] == start[i + 1]) {
+                continue;
+            }
+            double sum = 0.0;
+            for (size_t k = start[i]; k < start[i + 1]; ++k) {
+                sum += scores[links[k].first] + links[k].second;
+            }
+            const double next = sum / static_cast<double>(start[i + 1] - start[i]);
+            largestStep = std::max(largestStep, std::abs(next - scores[i]));
+            scores[i] = next;
+        }
+        if (largestStep < kTolerance) {
+            break;
+        }
+    }
+
+    std::vector<double> shift(count, 0.0);
+    std::vector<size_t> members(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        shift[groups[i]] += prior[i] - scores[i];
+        ++members[groups[i]];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        scores[i] += shift[groups[i]] / static_cast<double>(members[groups[i]]);
+    }
+
+    const double top = count == 0 ? 0.0 : *std::max_element(scores.begin(), scores.end());
+    for (double& score : scores) {
+        score = std::exp(score - top);
+    }
+    return scores;
+}
+
+std::vector<std::uint32_t> RankByScore(const std::vector<double>& scores) {
+    std::vector<std::uint32_t> ranking(scores.size());
+    std::iota(ranking.begin(), ranking.end(), 0u);
+    std::stable_sort(ranking.begin(), ranking.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return scores[a] > scores[b]; });
+    return ranking;
+}
+
+// Of the profiles whose matchTokens hit `label`, the one with the longest
+// hit ("i7-7700" beats a bare "7700"), or kNoProfile on a tie.
+template <typename Profiles>
+std::uint32_t MostSpecificHit(const Profiles& profiles, std::string_view label,
+                              const std::vector<std::uint32_t>& hits) {
+    if (hits.size() == 1) {
+        return hits.front();
+    }
+    std::string key(label);
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    std::uint32_t best = PerformanceIndex::kNoProfile;
+    size_t bestLength = 0;
+    bool tied = false;
+    for (const std::uint32_t hit : hits) {
+        size_t length = 0;
+        for (std::string_view token : profiles[hit].MatchTokens()) {
+            if (token.size() > length && HardwareMatchKeys::ContainsToken(key, token)) {
+                length = token.size();
+            }
+        }
+        if (length > bestLength) {
+            best = hit;
+            bestLength = length;
+            tied = false;
+        } else if (length == bestLength) {
+            tied = true;
+        }
+    }
+    return tied ? PerformanceIndex::kNoProfile : best;
+}
+
+// Profiles linked by ratios share a group id (the smallest index among
+// them).
+std::vector<std::uint32_t> GroupLinked(size_t count, const std::vector<Ratio>& ratios) {
+    std::vector<std::uint32_t> parent(count);
+    std::iota(parent.begin(), parent.end(), 0u);
+    const auto root = [&](std::uint32_t i) {
+        while (parent[i] != i) {
+            i = parent[i] = parent[parent[i]];
+        }
+        return i;
+    };
+    for (const auto& ratio : ratios) {
+        const std::uint32_t a = root(ratio.from);
+        const std::uint32_t b = root(ratio.to);
+        parent[std::max(a, b)] = std::min(a, b);
+    }
+    for (std::uint32_t i = 0; i < count; ++i) {
+        parent[i] = root(i);
+    }
+    return parent;
+}
+
+// Resolves every listed target to the profile it mimics: the one whose
+// label is the target's label without "Mimic ", else the most specific
+// profile whose matchTokens hit that label. Self-references and
+// ambiguous labels stay unresolved. `factor(profile, target)` is the
+// target's projected performance fraction on its own profile; each
+// resolved target with one in (0, 1) becomes a ratio.
+template <typename Profiles, typename FactorFn>
+std::vector<Ratio> CollectRatios(const Profiles& profiles, const TokenMatcher& matcher, std::uint32_t targetCount,
+                                 std::vector<std::uint32_t>& mimics, FactorFn&& factor) {
+    std::unordered_map<std::string_view, std::uint32_t> byLabel;
+    byLabel.reserve(profiles.size());
+    for (const auto profile : profiles) {
+        byLabel.try_emplace(profile.Label(), profile.Index());
+    }
+
+    mimics.assign(targetCount, PerformanceIndex::kNoProfile);
+    std::vector<Ratio> ratios;
+    std::vector<std::uint32_t> hits;
+    for (const auto profile : profiles) {
+        for (const auto target : profile.Targets()) {
+            const std::string_view label = MimickedLabel(target.Label());
+            std::uint32_t mimicked = PerformanceIndex::kNoProfile;
+            if (const auto it = byLabel.find(label); it != byLabel.end()) {
+                mimicked = it->second;
+            } else {
+                matcher.Match(label, hits);
+                mimicked = MostSpecificHit(profiles, label, hits);
+            }
+            if (mimicked == PerformanceIndex::kNoProfile || mimicked == profile.Index()) {
+                continue;
+            }
+            mimics[target.Index()] = mimicked;
+            const double projected = factor(profile, target);
+            if (projected > 0.0 && projected < 1.0) {
+                ratios.push_back({profile.Index(), mimicked, std::log(projected)});
+            }
+        }
+    }
+    return ratios;
+}
+
+double LogOrZero(int value) {
+    return value > 0 ? std::log(static_cast<double>(value)) : 0.0;
+}
+
+}  // namespace
+
+double ProjectedCpuFactor(int maxPercent, int maxFrequencyMHz, int nominalFrequencyMHz) {
+    const double percent = maxPercent > 0 ? static_cast<double>(maxPercent) / 100.0 : 1.0;
+    double frequency = 1.0;
+    if (nominalFrequencyMHz > 0 && maxFrequencyMHz > 0) {
+        frequency = static_cast<double>(maxFrequencyMHz) / static_cast<double>(nominalFrequencyMHz);
+    }
+    return std::min(percent, frequency);
+}
+
+double ProjectedGpuFactor(int maxFrequencyMHz, int powerLimitWatts, int nominalFrequencyMHz, int nominalPowerWatts) {
+    double frequency = 1.0;
+    if (nominalFrequencyMHz > 0 && maxFrequencyMHz > 0) {
+        frequency = static_cast<double>(maxFrequencyMHz) / static_cast<double>(nominalFrequencyMHz);
+    }
+    double power = 1.0;
+    if (nominalPowerWatts > 0 && powerLimitWatts > 0) {
+        power = static_cast<double>(powerLimitWatts) / static_cast<double>(nominalPowerWatts);
+    }
+    return std::min(frequency, power);
+}
+
+PerformanceIndex::PerformanceIndex(const ProfileCatalog& catalog) {
+    const auto cpuProfiles = catalog.CpuProfiles();
+    const std::uint32_t cpuTargetCount = catalog.Image().empty() ? 0 : catalog.ImageHeader().cpuTargets.id.count;
+    const auto cpuRatios = CollectRatios(
+        cpuProfiles, catalog.CpuMatcher(), cpuTargetCount, cpuTargetMimics_,
+        [](const CpuProfileView& profile, const CpuTargetView& target) {
+            return ProjectedCpuFactor(target.MaxPercent(), target.MaxFrequencyMHz(), profile.NominalFrequencyMHz());
+        });
+    std::vector<double> cpuPrior;
+    cpuPrior.reserve(cpuProfiles.size());
+    for (const auto profile : cpuProfiles) {
+        cpuPrior.push_back(LogOrZero(profile.NominalFrequencyMHz()));
+    }
+    cpuGroups_ = GroupLinked(cpuPrior.size(), cpuRatios);
+    cpuScores_ = FitScores(cpuPrior, cpuRatios, cpuGroups_);
+    cpuRanking_ = RankByScore(cpuScores_);
+
+    const auto gpuProfiles = catalog.GpuProfiles();
+    const std::uint32_t gpuTargetCount = catalog.Image().empty() ? 0 : catalog.ImageHeader().gpuTargets.id.count;
+    const auto gpuRatios = CollectRatios(
+        gpuProfiles, catalog.GpuMatcher(), gpuTargetCount, gpuTargetMimics_,
+        [](const GpuProfileView& profile, const GpuTargetView& target) {
+            return ProjectedGpuFactor(target.MaxFrequencyMHz(), target.PowerLimitWatts(),
+                                      profile.NominalFrequencyMHz(), profile.NominalPowerWatts());
+        });
+    std::vector<double> gpuPrior;
+    gpuPrior.reserve(gpuProfiles.size());
+    for (const auto profile : gpuProfiles) {
+        gpuPrior.push_back(0.5 * (LogOrZero(profile.NominalFrequencyMHz()) + LogOrZero(profile.NominalPowerWatts())));
+    }
+    gpuGroups_ = GroupLinked(gpuPrior.size(), gpuRatios);
+    gpuScores_ = FitScores(gpuPrior, gpuRatios, gpuGroups_);
+    gpuRanking_ = RankByScore(gpuScores_);
+}
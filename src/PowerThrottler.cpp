@@ -1,15 +1,22 @@
 #include "PowerThrottler.hpp"
 
+#include <algorithm>
+#include <cstdlib>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #ifdef _WIN32
 #include <Windows.h>
 #endif
 
+#include "ParallelFor.hpp"
+
 namespace {
 
+constexpr unsigned kNvidiaVendorId = 0x10DE;
+
 #ifdef _WIN32
 std::wstring BuildCommand(const std::wstring& exe, const std::wstring& args) {
     std::wstringstream ss;
@@ -20,13 +27,33 @@ std::wstring BuildCommand(const std::wstring& exe, const std::wstring& args) {
     return ss.str();
 }
 
-std::wstring ToWide(const std::string& value) {
+std::wstring ToWide(std::string_view value) {
     return std::wstring(value.begin(), value.end());
 }
 #endif
 
+// Runs `action` for every adapter on its own thread; the adapters are
+// independent devices, so their nvidia-smi calls need not wait on each
+// other. Each adapter's commands still run in order.
+template <typename Adapter, typename Action>
+std::vector<GpuAdapterResult> ForEachAdapter(std::span<const Adapter> adapters, Action&& action) {
+    std::vector<GpuAdapterResult> results(adapters.size());
+    ParallelFor(adapters.size(), static_cast<unsigned>(adapters.size()), [&](size_t i) {
+        results[i].device = adapters[i].device;
+        results[i].result = action(adapters[i]);
+    });
+    return results;
+}
+
 }  // namespace
 
+std::optional<std::string> NvidiaSmiDevice(const GpuInfo& gpu) {
+    if (gpu.vendorId != kNvidiaVendorId || gpu.pciBusId.empty()) {
+        return std::nullopt;
+    }
+    return gpu.pciBusId;
+}
+
 ThrottleResult PowerThrottler::ApplyCpuTarget(const CpuThrottleTarget& target) {
 #ifdef _WIN32
     auto maxPercent = target.maxPercent > 0 ? target.maxPercent : 100;
@@ -45,7 +72,7 @@ ThrottleResult PowerThrottler::ApplyCpuTarget(const CpuThrottleTarget& target) {
         commands.push_back(L"powercfg /setdcvalueindex SCHEME_CURRENT SUB_PROCESSOR PROCFREQMAX " + freqStr);
     }
 
-    for (const auto& extra : target.extraCommands) {
+    for (std::string_view extra : target.extraCommands) {
         commands.push_back(ToWide(extra));
     }
     commands.push_back(L"powercfg /setactive SCHEME_CURRENT");
@@ -65,15 +92,16 @@ ThrottleResult PowerThrottler::ApplyCpuTarget(const CpuThrottleTarget& target) {
 #endif
 }
 
-ThrottleResult PowerThrottler::ApplyGpuTarget(const GpuThrottleTarget& target) {
+ThrottleResult PowerThrottler::ApplyGpuTarget(const std::string& device, const GpuThrottleTarget& target) {
 #ifdef _WIN32
     if (target.nvidiaSmiArgs.empty()) {
         return {false, L"No GPU commands defined for this target"};
     }
+    const std::wstring select = L"-i " + ToWide(device);
     std::vector<std::wstring> commands;
-    commands.push_back(L"nvidia-smi -i 0 -pm 1");
-    std::wstring args = L"-i 0";
-    for (const auto& part : target.nvidiaSmiArgs) {
+    commands.push_back(L"nvidia-smi " + select + L" -pm 1");
+    std::wstring args = select;
+    for (std::string_view part : target.nvidiaSmiArgs) {
         args += L" ";
         args += ToWide(part);
     }
@@ -87,10 +115,18 @@ ThrottleResult PowerThrottler::ApplyGpuTarget(const GpuThrottleTarget& target) {
     }
     return {true, L"GPU target applied"};
 #else
+    (void)device;
+    (void)target;
     return {false, L"GPU throttling is only supported on Windows"};
 #endif
 }
 
+std::vector<GpuAdapterResult> PowerThrottler::ApplyGpuTargets(std::span<const GpuAdapterTarget> targets) {
+    return ForEachAdapter(targets, [this](const GpuAdapterTarget& adapter) {
+        return ApplyGpuTarget(adapter.device, adapter.target);
+    });
+}
+
 ThrottleResult PowerThrottler::RestoreDefaults() {
 #ifdef _WIN32
     ThrottleResult result = RunCommand(L"powercfg /setacvalueindex SCHEME_CURRENT SUB_PROCESSOR PROCTHROTTLEMAX 100");
@@ -108,21 +144,88 @@ ThrottleResult PowerThrottler::RestoreDefaults() {
 #endif
 }
 
-ThrottleResult PowerThrottler::RunCommand(const std::wstring& commandLine) const {
+ThrottleResult PowerThrottler::RestoreGpuDefaults(const GpuAdapterDefaults& adapter) {
+#ifdef _WIN32
+    const std::wstring device = L"nvidia-smi -i " + ToWide(adapter.device);
+    ThrottleResult result = RunCommand(device + L" -rgc");
+    if (!result.success) {
+        return result;
+    }
+    // The board's default rather than a catalog TDP: partner boards ship
+    // with their own limits, and an unmatched board has no profile at all.
+    std::string output;
+    result = RunCommand(device + L" --query-gpu=power.default_limit --format=csv,noheader,nounits", &output);
+    if (!result.success) {
+        return result;
+    }
+    const double watts = std::strtod(output.c_str(), nullptr);
+    if (!(watts > 0.0)) {
+        // "[N/A]" on boards without power management, which nothing capped.
+        return {true, L"GPU clocks restored; no power limit to restore"};
+    }
+    wchar_t limit[32];
+    swprintf_s(limit, L"%.2f", watts);
+    result = RunCommand(device + L" -pl " + limit);
+    if (!result.success) {
+        return result;
+    }
+    return {true, L"GPU defaults restored"};
+#else
+    (void)adapter;
+    return {false, L"Restore is only supported on Windows"};
+#endif
+}
+
+std::vector<GpuAdapterResult> PowerThrottler::RestoreGpuDefaults(std::span<const GpuAdapterDefaults> adapters) {
+    return ForEachAdapter(adapters, [this](const GpuAdapterDefaults& adapter) { return RestoreGpuDefaults(adapter); });
+}
+
+ThrottleResult PowerThrottler::RunCommand(const std::wstring& commandLine, std::string* output) const {
 #ifdef _WIN32
     std::wstring fullCommand = L"cmd.exe /C " + commandLine;
     STARTUPINFOW si{};
     si.cb = sizeof(si);
     PROCESS_INFORMATION pi{};
 
+    // Only the pipe's write end is inherited; the read end stays here.
+    HANDLE readPipe = nullptr;
+    HANDLE writePipe = nullptr;
+    if (output) {
+        SECURITY_ATTRIBUTES security{sizeof(security), nullptr, TRUE};
+        if (!CreatePipe(&readPipe, &writePipe, &security, 0)) {
+            return {false, L"Failed to capture the output of '" + commandLine + L"'"};
+        }
+        SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+        si.dwFlags |= STARTF_USESTDHANDLES;
+        si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+        si.hStdOutput = writePipe;
+        si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+    }
+
     std::wstring mutableCommand = fullCommand;
-    if (!CreateProcessW(nullptr, mutableCommand.data(), nullptr, nullptr, FALSE,
-                        CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi)) {
-        DWORD error = GetLastError();
+    const BOOL started = CreateProcessW(nullptr, mutableCommand.data(), nullptr, nullptr, output ? TRUE : FALSE,
+                                        CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi);
+    const DWORD error = GetLastError();
+    if (writePipe) {
+        CloseHandle(writePipe);  // so the reads below end when the child exits
+    }
+    if (!started) {
+        if (readPipe) {
+            CloseHandle(readPipe);
+        }
         wchar_t buffer[256];
         swprintf_s(buffer, L"Failed to execute '%s' (error %lu)", commandLine.c_str(), error);
         return {false, buffer};
     }
+    if (output) {
+        // Drained before waiting, so a full pipe cannot stall the child.
+        char chunk[256];
+        DWORD read = 0;
+        while (ReadFile(readPipe, chunk, sizeof(chunk), &read, nullptr) && read > 0) {
+            output->append(chunk, read);
+        }
+        CloseHandle(readPipe);
+    }
 
     WaitForSingleObject(pi.hProcess, INFINITE);
     DWORD exitCode = 1;
@@ -138,6 +241,7 @@ ThrottleResult PowerThrottler::RunCommand(const std::wstring& commandLine) const
     return {true, L"OK"};
 #else
     (void)commandLine;
+    (void)output;
     return {false, L"Commands only run on Windows"};
 #endif
 }
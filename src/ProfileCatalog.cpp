@@ -0,0 +1,800 @@
+#include "ProfileCatalog.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "PerformanceIndex.hpp"
+
+using namespace catalog_image;
+
+namespace {
+
+constexpr size_t kSectionAlignment = 8;
+
+size_t AlignUp(size_t value) {
+    return (value + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+// Read-only mapping of a whole file; the deleter unmaps it.
+std::shared_ptr<const std::byte> MapReadOnly(const std::filesystem::path& path, size_t& size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return nullptr;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        return nullptr;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    return std::shared_ptr<const std::byte>(static_cast<const std::byte*>(view),
+                                            [](const std::byte* p) { UnmapViewOfFile(p); });
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    const size_t length = static_cast<size_t>(info.st_size);
+    void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return nullptr;
+    }
+    size = length;
+    return std::shared_ptr<const std::byte>(static_cast<const std::byte*>(view), [length](const std::byte* p) {
+        ::munmap(const_cast<std::byte*>(p), length);
+    });
+#endif
+}
+
+bool SectionFits(const Section& section, size_t elementSize, size_t imageSize) {
+    if (section.offset % alignof(std::uint32_t) != 0 || section.offset < sizeof(Header)) {
+        return section.count == 0;
+    }
+    return static_cast<std::uint64_t>(section.offset) + static_cast<std::uint64_t>(section.count) * elementSize <=
+           imageSize;
+}
+
+template <typename Record>
+std::span<const Record> Records(const std::byte* data, const Section& section) {
+    return {reinterpret_cast<const Record*>(data + section.offset), section.count};
+}
+
+bool RangeFits(const Range& range, std::uint32_t tableSize) {
+    return static_cast<std::uint64_t>(range.first) + range.count <= tableSize;
+}
+
+bool StringFits(const StringRef& ref, std::uint32_t poolSize) {
+    return static_cast<std::uint64_t>(ref.offset) + ref.length <= poolSize;
+}
+
+bool ColumnsFit(const CpuTargetColumns& columns, size_t imageSize) {
+    const std::uint32_t count = columns.id.count;
+    for (const Section* column : {&columns.id, &columns.label, &columns.maxFrequencyMHz, &columns.maxCores,
+                                  &columns.maxThreads, &columns.maxPercent, &columns.extraCommands, &columns.flags}) {
+        if (column->count != count) {
+            return false;
+        }
+    }
+    return SectionFits(columns.id, sizeof(StringRef), imageSize) &&
+           SectionFits(columns.label, sizeof(StringRef), imageSize) &&
+           SectionFits(columns.maxFrequencyMHz, sizeof(std::int32_t), imageSize) &&
+           SectionFits(columns.maxCores, sizeof(std::int32_t), imageSize) &&
+           SectionFits(columns.maxThreads, sizeof(std::int32_t), imageSize) &&
+           SectionFits(columns.maxPercent, sizeof(std::int32_t), imageSize) &&
+           SectionFits(columns.extraCommands, sizeof(Range), imageSize) &&
+           SectionFits(columns.flags, sizeof(std::uint32_t), imageSize);
+}
+
+bool ColumnsFit(const GpuTargetColumns& columns, size_t imageSize) {
+    const std::uint32_t count = columns.id.count;
+    for (const Section* column : {&columns.id, &columns.label, &columns.maxFrequencyMHz, &columns.powerLimitWatts,
+                                  &columns.nvidiaSmiArgs, &columns.flags}) {
+        if (column->count != count) {
+            return false;
+        }
+    }
+    return SectionFits(columns.id, sizeof(StringRef), imageSize) &&
+           SectionFits(columns.label, sizeof(StringRef), imageSize) &&
+           SectionFits(columns.maxFrequencyMHz, sizeof(std::int32_t), imageSize) &&
+           SectionFits(columns.powerLimitWatts, sizeof(std::int32_t), imageSize) &&
+           SectionFits(columns.nvidiaSmiArgs, sizeof(Range), imageSize) &&
+           SectionFits(columns.flags, sizeof(std::uint32_t), imageSize);
+}
+
+bool StringsFit(std::span<const StringRef> refs, std::uint32_t poolSize) {
+    return std::all_of(refs.begin(), refs.end(), [poolSize](const StringRef& ref) { return StringFits(ref, poolSize); });
+}
+
+bool RangesFit(std::span<const Range> ranges, std::uint32_t tableSize) {
+    return std::all_of(ranges.begin(), ranges.end(), [tableSize](const Range& range) { return RangeFits(range, tableSize); });
+}
+
+// Bounds-checks every section and cross-reference once at open, so the
+// accessors can index the image without further checks.
+bool ValidateImage(const std::byte* data, size_t size) {
+    if (size < sizeof(Header)) {
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.totalSize != size) {
+        return false;
+    }
+    if (!SectionFits(header.cpuProfiles, sizeof(CpuProfileRecord), size) ||
+        !SectionFits(header.gpuProfiles, sizeof(GpuProfileRecord), size) ||
+        !ColumnsFit(header.cpuTargets, size) || !ColumnsFit(header.gpuTargets, size) ||
+        !SectionFits(header.stringRefs, sizeof(StringRef), size) ||
+        !SectionFits(header.stringPool, 1, size)) {
+        return false;
+    }
+
+    const std::uint32_t pool = header.stringPool.count;
+    const std::uint32_t lists = header.stringRefs.count;
+    if (!StringsFit(Records<StringRef>(data, header.stringRefs), pool)) {
+        return false;
+    }
+    for (const auto& record : Records<CpuProfileRecord>(data, header.cpuProfiles)) {
+        if (!StringFits(record.id, pool) || !StringFits(record.label, pool) ||
+            !RangeFits(record.matchTokens, lists) || !RangeFits(record.cpuIds, lists) ||
+            !RangeFits(record.targets, header.cpuTargets.id.count)) {
+            return false;
+        }
+    }
+    for (const auto& record : Records<GpuProfileRecord>(data, header.gpuProfiles)) {
+        if (!StringFits(record.id, pool) || !StringFits(record.label, pool) ||
+            !RangeFits(record.matchTokens, lists) || !RangeFits(record.pciIds, lists) ||
+            !RangeFits(record.targets, header.gpuTargets.id.count)) {
+            return false;
+        }
+    }
+    const auto& cpu = header.cpuTargets;
+    const auto& gpu = header.gpuTargets;
+    return StringsFit(Records<StringRef>(data, cpu.id), pool) && StringsFit(Records<StringRef>(data, cpu.label), pool) &&
+           RangesFit(Records<Range>(data, cpu.extraCommands), lists) &&
+           StringsFit(Records<StringRef>(data, gpu.id), pool) && StringsFit(Records<StringRef>(data, gpu.label), pool) &&
+           RangesFit(Records<Range>(data, gpu.nvidiaSmiArgs), lists);
+}
+
+struct CpuTargetTable {
+    std::vector<StringRef> id;
+    std::vector<StringRef> label;
+    std::vector<std::int32_t> maxFrequencyMHz;
+    std::vector<std::int32_t> maxCores;
+    std::vector<std::int32_t> maxThreads;
+    std::vector<std::int32_t> maxPercent;
+    std::vector<Range> extraCommands;
+    std::vector<std::uint32_t> flags;
+};
+
+struct GpuTargetTable {
+    std::vector<StringRef> id;
+    std::vector<StringRef> label;
+    std::vector<std::int32_t> maxFrequencyMHz;
+    std::vector<std::int32_t> powerLimitWatts;
+    std::vector<Range> nvidiaSmiArgs;
+    std::vector<std::uint32_t> flags;
+};
+
+class ImageBuilder {
+public:
+    StringRef Intern(const std::string& text) {
+        auto it = interned_.find(text);
+        if (it != interned_.end()) {
+            return it->second;
+        }
+        StringRef ref{static_cast<std::uint32_t>(pool_.size()), static_cast<std::uint32_t>(text.size())};
+        pool_ += text;
+        interned_.emplace(text, ref);
+        return ref;
+    }
+
+    Range InternList(const std::vector<std::string>& items) {
+        Range range{static_cast<std::uint32_t>(stringRefs_.size()), static_cast<std::uint32_t>(items.size())};
+        for (const auto& item : items) {
+            stringRefs_.push_back(Intern(item));
+        }
+        return range;
+    }
+
+    std::vector<std::byte> Build(const ProfileDatabase& database, std::uint64_t sourceHash) {
+        std::vector<CpuProfileRecord> cpuProfiles;
+        CpuTargetTable cpuTargets;
+        for (const auto& profile : database.cpuProfiles) {
+            CpuProfileRecord record{};
+            record.id = Intern(profile.id);
+            record.label = Intern(profile.label);
+            record.matchTokens = InternList(profile.matchTokens);
+            record.cpuIds = InternList(profile.cpuIds);
+            record.targets = {static_cast<std::uint32_t>(cpuTargets.id.size()),
+                              static_cast<std::uint32_t>(profile.targets.size())};
+            record.nominalFrequencyMHz = profile.nominalFrequencyMHz;
+            for (const auto& target : profile.targets) {
+                cpuTargets.id.push_back(Intern(target.id));
+                cpuTargets.label.push_back(Intern(target.label));
+                cpuTargets.maxFrequencyMHz.push_back(target.maxFrequencyMHz);
+                cpuTargets.maxCores.push_back(target.maxCores);
+                cpuTargets.maxThreads.push_back(target.maxThreads);
+                cpuTargets.maxPercent.push_back(target.maxPercent);
+                cpuTargets.extraCommands.push_back(InternList(target.extraCommands));
+                cpuTargets.flags.push_back(target.requiresConfirmation ? kRequiresConfirmation : 0);
+            }
+            cpuProfiles.push_back(record);
+        }
+
+        std::vector<GpuProfileRecord> gpuProfiles;
+        GpuTargetTable gpuTargets;
+        for (const auto& profile : database.gpuProfiles) {
+            GpuProfileRecord record{};
+            record.id = Intern(profile.id);
+            record.label = Intern(profile.label);
+            record.matchTokens = InternList(profile.matchTokens);
+            record.pciIds = InternList(profile.pciIds);
+            record.targets = {static_cast<std::uint32_t>(gpuTargets.id.size()),
+                              static_cast<std::uint32_t>(profile.targets.size())};
+            record.nominalFrequencyMHz = profile.nominalFrequencyMHz;
+            record.nominalPowerWatts = profile.nominalPowerWatts;
+            for (const auto& target : profile.targets) {
+                gpuTargets.id.push_back(Intern(target.id));
+                gpuTargets.label.push_back(Intern(target.label));
+                gpuTargets.maxFrequencyMHz.push_back(target.maxFrequencyMHz);
+                gpuTargets.powerLimitWatts.push_back(target.powerLimitWatts);
+                gpuTargets.nvidiaSmiArgs.push_back(InternList(target.nvidiaSmiArgs));
+                gpuTargets.flags.push_back(target.requiresConfirmation ? kRequiresConfirmation : 0);
+            }
+            gpuProfiles.push_back(record);
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.sourceHash = sourceHash;
+
+        // Lay out sections first, then copy each vector into its slot.
+        size_t cursor = AlignUp(sizeof(Header));
+        std::vector<std::pair<const Section*, std::span<const std::byte>>> payloads;
+        auto place = [&](Section& section, const auto& elements) {
+            const auto bytes = std::as_bytes(std::span(elements));
+            section.offset = static_cast<std::uint32_t>(cursor);
+            section.count = static_cast<std::uint32_t>(elements.size());
+            payloads.emplace_back(&section, bytes);
+            cursor = AlignUp(cursor + bytes.size());
+        };
+        place(header.cpuProfiles, cpuProfiles);
+        place(header.gpuProfiles, gpuProfiles);
+        place(header.cpuTargets.id, cpuTargets.id);
+        place(header.cpuTargets.label, cpuTargets.label);
+        place(header.cpuTargets.maxFrequencyMHz, cpuTargets.maxFrequencyMHz);
+        place(header.cpuTargets.maxCores, cpuTargets.maxCores);
+        place(header.cpuTargets.maxThreads, cpuTargets.maxThreads);
+        place(header.cpuTargets.maxPercent, cpuTargets.maxPercent);
+        place(header.cpuTargets.extraCommands, cpuTargets.extraCommands);
+        place(header.cpuTargets.flags, cpuTargets.flags);
+        place(header.gpuTargets.id, gpuTargets.id);
+        place(header.gpuTargets.label, gpuTargets.label);
+        place(header.gpuTargets.maxFrequencyMHz, gpuTargets.maxFrequencyMHz);
+        place(header.gpuTargets.powerLimitWatts, gpuTargets.powerLimitWatts);
+        place(header.gpuTargets.nvidiaSmiArgs, gpuTargets.nvidiaSmiArgs);
+        place(header.gpuTargets.flags, gpuTargets.flags);
+        place(header.stringRefs, stringRefs_);
+        place(header.stringPool, pool_);
+        if (cursor > UINT32_MAX) {
+            throw std::runtime_error("Profile catalog too large for image format");
+        }
+        header.totalSize = static_cast<std::uint32_t>(cursor);
+
+        std::vector<std::byte> image(cursor);
+        std::memcpy(image.data(), &header, sizeof(header));
+        for (const auto& [section, bytes] : payloads) {
+            if (!bytes.empty()) {
+                std::memcpy(image.data() + section->offset, bytes.data(), bytes.size());
+            }
+        }
+        return image;
+    }
+
+private:
+    std::string pool_;
+    std::vector<StringRef> stringRefs_;
+    std::unordered_map<std::string, StringRef> interned_;
+};
+
+template <typename Profiles>
+TokenMatcher BuildMatcher(const Profiles& profiles) {
+    std::vector<TokenMatcher::Pattern> patterns;
+    for (const auto profile : profiles) {
+        for (std::string_view token : profile.MatchTokens()) {
+            patterns.emplace_back(token, profile.Index());
+        }
+    }
+    return TokenMatcher(patterns);
+}
+
+HardwareIdIndex BuildIdIndex(const CatalogList<CpuProfileView>& cpuProfiles,
+                             const CatalogList<GpuProfileView>& gpuProfiles) {
+    HardwareIdIndex index;
+    for (const auto profile : cpuProfiles) {
+        for (std::string_view text : profile.CpuIds()) {
+            if (const auto key = CpuIdKey::Parse(text)) {
+                index.AddCpu(*key, profile.Index());
+            }
+        }
+    }
+    for (const auto profile : gpuProfiles) {
+        for (std::string_view text : profile.PciIds()) {
+            if (const auto key = PciIdKey::Parse(text)) {
+                index.AddGpu(*key, profile.Index());
+            }
+        }
+    }
+    return index;
+}
+
+}  // namespace
+
+ProfileCatalog::ProfileCatalog(std::shared_ptr<const std::byte> data, size_t size, bool mapped)
+    : data_(std::move(data)), size_(size), mapped_(mapped) {
+    auto matchers = std::make_shared<Matchers>();
+    matchers->cpu = BuildMatcher(CpuProfiles());
+    matchers->gpu = BuildMatcher(GpuProfiles());
+    matchers->ids = BuildIdIndex(CpuProfiles(), GpuProfiles());
+    matchers_ = std::move(matchers);
+    performance_ = std::make_shared<LazyPerformance>();
+}
+
+std::optional<ProfileCatalog> ProfileCatalog::Map(const std::filesystem::path& path) {
+    size_t size = 0;
+    auto data = MapReadOnly(path, size);
+    if (!data || !ValidateImage(data.get(), size)) {
+        return std::nullopt;
+    }
+    return ProfileCatalog(std::move(data), size, true);
+}
+
+ProfileCatalog ProfileCatalog::Compile(const ProfileDatabase& database, std::uint64_t sourceHash, bool partial) {
+    auto image = std::make_shared<std::vector<std::byte>>(BuildImage(database, sourceHash));
+    const std::byte* bytes = image->data();
+    const size_t size = image->size();
+    ProfileCatalog catalog(std::shared_ptr<const std::byte>(image, bytes), size, false);
+    catalog.partial_ = partial;
+    return catalog;
+}
+
+std::vector<std::byte> ProfileCatalog::BuildImage(const ProfileDatabase& database, std::uint64_t sourceHash) {
+    ImageBuilder builder;
+    return builder.Build(database, sourceHash);
+}
+
+void ProfileCatalog::WriteImage(const std::filesystem::path& path, std::span<const std::byte> image) {
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            throw std::runtime_error("unable to write " + temp.string());
+        }
+        stream.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!stream) {
+            throw std::runtime_error("short write to " + temp.string());
+        }
+    }
+    std::filesystem::rename(temp, path);
+}
+
+std::uint64_t ProfileCatalog::HashSource(std::string_view text) {
+    // FNV-1a over 8-byte words with an extra xorshift; fast enough to run
+    // on every launch and only used to detect edits to the JSON source.
+    std::uint64_t hash = 14695981039346656037ull ^ text.size();
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, text.data() + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 29;
+    }
+    for (; i < text.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(text[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+std::uint64_t ProfileCatalog::SourceHash() const {
+    return data_ ? ImageHeader().sourceHash : 0;
+}
+
+CatalogList<CpuProfileView> ProfileCatalog::CpuProfiles() const {
+    if (!data_) {
+        return {};
+    }
+    return {this, Range{0, ImageHeader().cpuProfiles.count}};
+}
+
+const TokenMatcher& ProfileCatalog::CpuMatcher() const {
+    static const TokenMatcher empty;
+    return matchers_ ? matchers_->cpu : empty;
+}
+
+const TokenMatcher& ProfileCatalog::GpuMatcher() const {
+    static const TokenMatcher empty;
+    return matchers_ ? matchers_->gpu : empty;
+}
+
+const HardwareIdIndex& ProfileCatalog::IdIndex() const {
+    static const HardwareIdIndex empty;
+    return matchers_ ? matchers_->ids : empty;
+}
+
+struct ProfileCatalog::LazyPerformance {
+    std::once_flag once;
+    PerformanceIndex index;
+};
+
+const PerformanceIndex& ProfileCatalog::Performance() const {
+    static const PerformanceIndex empty;
+    if (!performance_) {
+        return empty;
+    }
+    std::call_once(performance_->once, [this] { performance_->index = PerformanceIndex(*this); });
+    return performance_->index;
+}
+
+CatalogList<GpuProfileView> ProfileCatalog::GpuProfiles() const {
+    if (!data_) {
+        return {};
+    }
+    return {this, Range{0, ImageHeader().gpuProfiles.count}};
+}
+
+ProfileDatabase ProfileCatalog::ToDatabase() const {
+    ProfileDatabase database;
+    const auto cpuProfiles = CpuProfiles();
+    database.cpuProfiles.reserve(cpuProfiles.size());
+    for (const auto profile : cpuProfiles) {
+        database.cpuProfiles.push_back(profile.Materialize());
+    }
+    const auto gpuProfiles = GpuProfiles();
+    database.gpuProfiles.reserve(gpuProfiles.size());
+    for (const auto profile : gpuProfiles) {
+        database.gpuProfiles.push_back(profile.Materialize());
+    }
+    return database;
+}
+
+std::string_view ProfileCatalog::String(StringRef ref) const {
+    const char* pool = reinterpret_cast<const char*>(data_.get() + ImageHeader().stringPool.offset);
+    return {pool + ref.offset, ref.length};
+}
+
+std::string_view ProfileCatalog::ListString(std::uint32_t index) const {
+    return String(At<StringRef>(ImageHeader().stringRefs, index));
+}
+
+std::string_view CatalogStringAccessor::At(const ProfileCatalog* catalog, std::uint32_t index) {
+    return catalog->ListString(index);
+}
+
+namespace {
+
+std::vector<std::string> MaterializeList(const StringListView& list) {
+    std::vector<std::string> items;
+    items.reserve(list.size());
+    for (std::string_view item : list) {
+        items.emplace_back(item);
+    }
+    return items;
+}
+
+// FNV-1a over the fields in order; strings are length-prefixed so that
+// moving text between adjacent fields changes the hash.
+class FieldHasher {
+public:
+    void Add(std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash_ = (hash_ ^ ((value >> (i * 8)) & 0xff)) * 1099511628211ull;
+        }
+    }
+    void Add(std::string_view text) {
+        Add(static_cast<std::uint64_t>(text.size()));
+        for (const char c : text) {
+            hash_ = (hash_ ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+    }
+    void Add(const StringListView& list) {
+        Add(static_cast<std::uint64_t>(list.size()));
+        for (std::string_view item : list) {
+            Add(item);
+        }
+    }
+    void Add(int value) { Add(static_cast<std::uint64_t>(static_cast<std::uint32_t>(value))); }
+    void Add(bool value) { Add(static_cast<std::uint64_t>(value)); }
+
+    std::uint64_t Value() const { return hash_; }
+
+private:
+    std::uint64_t hash_ = 14695981039346656037ull;
+};
+
+template <typename Profile>
+void DiffProfiles(const CatalogList<Profile>& before, const CatalogList<Profile>& after, ProfileChanges& changes) {
+    std::unordered_map<std::string_view, std::uint64_t> previous;
+    previous.reserve(before.size());
+    for (const auto profile : before) {
+        previous.try_emplace(profile.Id(), profile.Fingerprint());
+    }
+    std::unordered_set<std::string_view> seen;
+    seen.reserve(after.size());
+    for (const auto profile : after) {
+        if (!seen.insert(profile.Id()).second) {
+            continue;
+        }
+        const auto it = previous.find(profile.Id());
+        if (it == previous.end()) {
+            changes.added.emplace_back(profile.Id());
+        } else {
+            if (it->second != profile.Fingerprint()) {
+                changes.changed.emplace_back(profile.Id());
+            }
+            previous.erase(it);
+        }
+    }
+    for (const auto profile : before) {
+        if (previous.erase(profile.Id()) != 0) {
+            changes.removed.emplace_back(profile.Id());
+        }
+    }
+}
+
+}  // namespace
+
+CatalogDiff ProfileCatalog::Diff(const ProfileCatalog& before, const ProfileCatalog& after) {
+    CatalogDiff diff;
+    DiffProfiles(before.CpuProfiles(), after.CpuProfiles(), diff.cpu);
+    DiffProfiles(before.GpuProfiles(), after.GpuProfiles(), diff.gpu);
+    return diff;
+}
+
+template <typename T>
+const T& CpuTargetView::Column(Section CpuTargetColumns::*column) const {
+    return catalog_->At<T>(catalog_->ImageHeader().cpuTargets.*column, index_);
+}
+
+std::string_view CpuTargetView::Id() const {
+    return catalog_->String(Column<StringRef>(&CpuTargetColumns::id));
+}
+
+std::string_view CpuTargetView::Label() const {
+    return catalog_->String(Column<StringRef>(&CpuTargetColumns::label));
+}
+
+int CpuTargetView::MaxFrequencyMHz() const {
+    return Column<std::int32_t>(&CpuTargetColumns::maxFrequencyMHz);
+}
+
+int CpuTargetView::MaxCores() const {
+    return Column<std::int32_t>(&CpuTargetColumns::maxCores);
+}
+
+int CpuTargetView::MaxThreads() const {
+    return Column<std::int32_t>(&CpuTargetColumns::maxThreads);
+}
+
+int CpuTargetView::MaxPercent() const {
+    return Column<std::int32_t>(&CpuTargetColumns::maxPercent);
+}
+
+StringListView CpuTargetView::ExtraCommands() const {
+    return {catalog_, Column<Range>(&CpuTargetColumns::extraCommands)};
+}
+
+bool CpuTargetView::RequiresConfirmation() const {
+    return (Column<std::uint32_t>(&CpuTargetColumns::flags) & kRequiresConfirmation) != 0;
+}
+
+CpuThrottleTarget CpuTargetView::Materialize() const {
+    CpuThrottleTarget target;
+    target.id = Id();
+    target.label = Label();
+    target.maxFrequencyMHz = MaxFrequencyMHz();
+    target.maxCores = MaxCores();
+    target.maxThreads = MaxThreads();
+    target.maxPercent = MaxPercent();
+    target.extraCommands = MaterializeList(ExtraCommands());
+    target.requiresConfirmation = RequiresConfirmation();
+    return target;
+}
+
+template <typename T>
+const T& GpuTargetView::Column(Section GpuTargetColumns::*column) const {
+    return catalog_->At<T>(catalog_->ImageHeader().gpuTargets.*column, index_);
+}
+
+std::string_view GpuTargetView::Id() const {
+    return catalog_->String(Column<StringRef>(&GpuTargetColumns::id));
+}
+
+std::string_view GpuTargetView::Label() const {
+    return catalog_->String(Column<StringRef>(&GpuTargetColumns::label));
+}
+
+int GpuTargetView::MaxFrequencyMHz() const {
+    return Column<std::int32_t>(&GpuTargetColumns::maxFrequencyMHz);
+}
+
+int GpuTargetView::PowerLimitWatts() const {
+    return Column<std::int32_t>(&GpuTargetColumns::powerLimitWatts);
+}
+
+StringListView GpuTargetView::NvidiaSmiArgs() const {
+    return {catalog_, Column<Range>(&GpuTargetColumns::nvidiaSmiArgs)};
+}
+
+bool GpuTargetView::RequiresConfirmation() const {
+    return (Column<std::uint32_t>(&GpuTargetColumns::flags) & kRequiresConfirmation) != 0;
+}
+
+GpuThrottleTarget GpuTargetView::Materialize() const {
+    GpuThrottleTarget target;
+    target.id = Id();
+    target.label = Label();
+    target.maxFrequencyMHz = MaxFrequencyMHz();
+    target.powerLimitWatts = PowerLimitWatts();
+    target.nvidiaSmiArgs = MaterializeList(NvidiaSmiArgs());
+    target.requiresConfirmation = RequiresConfirmation();
+    return target;
+}
+
+const CpuProfileRecord& CpuProfileView::Record() const {
+    return catalog_->At<CpuProfileRecord>(catalog_->ImageHeader().cpuProfiles, index_);
+}
+
+std::string_view CpuProfileView::Id() const {
+    return catalog_->String(Record().id);
+}
+
+std::string_view CpuProfileView::Label() const {
+    return catalog_->String(Record().label);
+}
+
+StringListView CpuProfileView::MatchTokens() const {
+    return {catalog_, Record().matchTokens};
+}
+
+StringListView CpuProfileView::CpuIds() const {
+    return {catalog_, Record().cpuIds};
+}
+
+CatalogList<CpuTargetView> CpuProfileView::Targets() const {
+    return {catalog_, Record().targets};
+}
+
+CpuProfile CpuProfileView::Materialize() const {
+    CpuProfile profile;
+    profile.id = Id();
+    profile.label = Label();
+    profile.matchTokens = MaterializeList(MatchTokens());
+    profile.cpuIds = MaterializeList(CpuIds());
+    const auto targets = Targets();
+    profile.targets.reserve(targets.size());
+    for (const auto target : targets) {
+        profile.targets.push_back(target.Materialize());
+    }
+    profile.nominalFrequencyMHz = NominalFrequencyMHz();
+    return profile;
+}
+
+std::uint64_t CpuProfileView::Fingerprint() const {
+    FieldHasher hasher;
+    hasher.Add(Id());
+    hasher.Add(Label());
+    hasher.Add(MatchTokens());
+    hasher.Add(CpuIds());
+    hasher.Add(NominalFrequencyMHz());
+    const auto targets = Targets();
+    hasher.Add(static_cast<std::uint64_t>(targets.size()));
+    for (const auto target : targets) {
+        hasher.Add(target.Id());
+        hasher.Add(target.Label());
+        hasher.Add(target.MaxFrequencyMHz());
+        hasher.Add(target.MaxCores());
+        hasher.Add(target.MaxThreads());
+        hasher.Add(target.MaxPercent());
+        hasher.Add(target.ExtraCommands());
+        hasher.Add(target.RequiresConfirmation());
+    }
+    return hasher.Value();
+}
+
+const GpuProfileRecord& GpuProfileView::Record() const {
+    return catalog_->At<GpuProfileRecord>(catalog_->ImageHeader().gpuProfiles, index_);
+}
+
+std::string_view GpuProfileView::Id() const {
+    return catalog_->String(Record().id);
+}
+
+std::string_view GpuProfileView::Label() const {
+    return catalog_->String(Record().label);
+}
+
+StringListView GpuProfileView::MatchTokens() const {
+    return {catalog_, Record().matchTokens};
+}
+
+StringListView GpuProfileView::PciIds() const {
+    return {catalog_, Record().pciIds};
+}
+
+CatalogList<GpuTargetView> GpuProfileView::Targets() const {
+    return {catalog_, Record().targets};
+}
+
+GpuProfile GpuProfileView::Materialize() const {
+    GpuProfile profile;
+    profile.id = Id();
+    profile.label = Label();
+    profile.matchTokens = MaterializeList(MatchTokens());
+    profile.pciIds = MaterializeList(PciIds());
+    const auto targets = Targets();
+    profile.targets.reserve(targets.size());
+    for (const auto target : targets) {
+        profile.targets.push_back(target.Materialize());
+    }
+    profile.nominalFrequencyMHz = NominalFrequencyMHz();
+    profile.nominalPowerWatts = NominalPowerWatts();
+    return profile;
+}
+
+std::uint64_t GpuProfileView::Fingerprint() const {
+    FieldHasher hasher;
+    hasher.Add(Id());
+    hasher.Add(Label());
+    hasher.Add(MatchTokens());
+    hasher.Add(PciIds());
+    hasher.Add(NominalFrequencyMHz());
+    hasher.Add(NominalPowerWatts());
+    const auto targets = Targets();
+    hasher.Add(static_cast<std::uint64_t>(targets.size()));
+    for (const auto target : targets) {
+        hasher.Add(target.Id());
+        hasher.Add(target.Label());
+        hasher.Add(target.MaxFrequencyMHz());
+        hasher.Add(target.PowerLimitWatts());
+        hasher.Add(target.NvidiaSmiArgs());
+        hasher.Add(target.RequiresConfirmation());
+    }
+    return hasher.Value();
+}
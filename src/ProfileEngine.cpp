@@ -1,62 +1,500 @@
 #include "ProfileEngine.hpp"
 
 #include <algorithm>
-#include <cctype>
+#include <cmath>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "ParallelFor.hpp"
+#include "PerformanceIndex.hpp"
 
 namespace {
 
-std::string ToLower(std::string value) {
-    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
-        return static_cast<char>(std::tolower(c));
-    });
-    return value;
+// Profiles keyed for the device by ID win; token matching is the fallback
+// for devices no profile has an ID entry for. Either way the indices are
+// ascending, so options keep the catalog order. `indices` is scratch space
+// that callers matching many snapshots reuse.
+void MatchCpuProfiles(const HardwareMatchKeys& keys, const ProfileCatalog& catalog,
+                      std::vector<std::uint32_t>& indices) {
+    if (keys.cpuId) {
+        indices = catalog.IdIndex().FindCpu(*keys.cpuId);
+        if (!indices.empty()) {
+            return;
+        }
+    }
+    catalog.CpuMatcher().Match(keys.cpu, indices);
+}
+
+void MatchGpuProfiles(const GpuMatchKeys& adapter, const ProfileCatalog& catalog,
+                      std::vector<std::uint32_t>& indices) {
+    if (adapter.id) {
+        indices = catalog.IdIndex().FindGpu(*adapter.id);
+        if (!indices.empty()) {
+            return;
+        }
+    }
+    catalog.GpuMatcher().Match(adapter.name, indices);
+}
+
+// Snapshots per MatchFleet task: enough to amortize the task hand-off,
+// few enough to balance across cores.
+constexpr size_t kFleetBlockSize = 1024;
+
+// One MatchFleet task's output: option counts per snapshot (CPU) and per
+// adapter (GPU), adapters per snapshot, and the options.
+struct FleetBlock {
+    std::vector<size_t> cpuCounts;
+    std::vector<size_t> adapterCounts;
+    std::vector<size_t> gpuCounts;
+    std::vector<CpuTargetHandle> cpuOptions;
+    std::vector<GpuTargetHandle> gpuOptions;
+};
+
+// Nominal values come from the first matched profile that has one.
+void TakeNominal(int& nominal, int value) {
+    if (nominal == 0 && value > 0) {
+        nominal = value;
+    }
+}
+
+// The first matched profile is the one synthesized targets scale from.
+void TakeReference(std::optional<std::uint32_t>& reference, std::uint32_t index) {
+    if (!reference) {
+        reference = index;
+    }
+}
+
+std::vector<std::uint32_t> MatchCpuProfiles(const HardwareMatchKeys& keys, const ProfileCatalog& catalog) {
+    std::vector<std::uint32_t> indices;
+    MatchCpuProfiles(keys, catalog, indices);
+    return indices;
+}
+
+std::vector<std::uint32_t> MatchGpuProfiles(const GpuMatchKeys& adapter, const ProfileCatalog& catalog) {
+    std::vector<std::uint32_t> indices;
+    MatchGpuProfiles(adapter, catalog, indices);
+    return indices;
 }
 
 }  // namespace
 
-void ProfileEngine::Refresh(const HardwareSnapshot& snapshot, const ProfileDatabase& database) {
+void ProfileEngine::Refresh(const HardwareSnapshot& snapshot, const ProfileCatalog& catalog) {
     cpuOptions_.clear();
-    gpuOptions_.clear();
+    cpuProfileIds_.clear();
+    cpuReference_.reset();
     cpuNominalFrequencyMHz_ = 0;
-    gpuNominalFrequencyMHz_ = 0;
-    gpuNominalPowerWatts_ = 0;
-
-    const std::string cpuNameLower = ToLower(snapshot.cpu.name);
-    for (const auto& profile : database.cpuProfiles) {
-        if (MatchesTokens(cpuNameLower, profile.matchTokens)) {
-            cpuOptions_.insert(cpuOptions_.end(), profile.targets.begin(), profile.targets.end());
-            if (cpuNominalFrequencyMHz_ == 0 && profile.nominalFrequencyMHz > 0) {
-                cpuNominalFrequencyMHz_ = profile.nominalFrequencyMHz;
-            }
+    gpuAdapters_.clear();
+
+    const HardwareMatchKeys keys(snapshot);
+    const auto cpuProfiles = catalog.CpuProfiles();
+    for (const std::uint32_t index : MatchCpuProfiles(keys, catalog)) {
+        const auto profile = cpuProfiles[index];
+        cpuProfileIds_.emplace_back(profile.Id());
+        for (const auto target : profile.Targets()) {
+            cpuOptions_.push_back(target.Handle());
         }
+        TakeReference(cpuReference_, index);
+        TakeNominal(cpuNominalFrequencyMHz_, profile.NominalFrequencyMHz());
+    }
+
+    gpuAdapters_.reserve(keys.gpus.size());
+    for (const auto& adapter : keys.gpus) {
+        gpuAdapters_.push_back(MatchGpuAdapter(adapter, catalog));
     }
+}
+
+void ProfileEngine::AddGpuAdapter(size_t adapter, const GpuInfo& gpu, const ProfileCatalog& catalog) {
+    gpuAdapters_.insert(gpuAdapters_.begin() + static_cast<std::ptrdiff_t>(adapter),
+                        MatchGpuAdapter(GpuMatchKeys::FromInfo(gpu), catalog));
+}
+
+void ProfileEngine::RemoveGpuAdapter(size_t adapter) {
+    gpuAdapters_.erase(gpuAdapters_.begin() + static_cast<std::ptrdiff_t>(adapter));
+}
+
+ProfileEngine::GpuAdapterMatch ProfileEngine::MatchGpuAdapter(const GpuMatchKeys& keys, const ProfileCatalog& catalog) {
+    GpuAdapterMatch adapter;
+    const auto gpuProfiles = catalog.GpuProfiles();
+    for (const std::uint32_t index : MatchGpuProfiles(keys, catalog)) {
+        const auto profile = gpuProfiles[index];
+        adapter.profileIds.emplace_back(profile.Id());
+        for (const auto target : profile.Targets()) {
+            adapter.options.push_back(target.Handle());
+        }
+        TakeReference(adapter.reference, index);
+        TakeNominal(adapter.nominalFrequencyMHz, profile.NominalFrequencyMHz());
+        TakeNominal(adapter.nominalPowerWatts, profile.NominalPowerWatts());
+    }
+    return adapter;
+}
+
+namespace {
+
+bool Contains(const std::vector<std::string>& ids, std::string_view id) {
+    return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+// Whether any profile named in `ids` is among the matched indices.
+template <typename Profiles>
+bool AnyMatches(const Profiles& profiles, const std::vector<std::string>& ids, const std::vector<std::uint32_t>& matched) {
+    return std::any_of(matched.begin(), matched.end(),
+                       [&](std::uint32_t index) { return Contains(ids, profiles[index].Id()); });
+}
+
+// Appends the target handles of each profile in `ids`, looked up by id
+// (first occurrence wins, as in matching), and passes each profile to
+// `visit`. Fails if one is missing or the profiles were reordered, since
+// Refresh would then list them differently.
+template <typename Profiles, typename Handle, typename VisitFn>
+bool AppendTargets(const Profiles& profiles, const std::vector<std::string>& ids, std::vector<Handle>& options,
+                   VisitFn&& visit) {
+    std::unordered_map<std::string_view, std::uint32_t> indexById;
+    indexById.reserve(profiles.size());
+    for (const auto profile : profiles) {
+        indexById.try_emplace(profile.Id(), profile.Index());
+    }
+    std::optional<std::uint32_t> previous;
+    for (const auto& id : ids) {
+        const auto it = indexById.find(id);
+        if (it == indexById.end() || (previous && it->second <= *previous)) {
+            return false;
+        }
+        previous = it->second;
+        const auto profile = profiles[it->second];
+        for (const auto target : profile.Targets()) {
+            options.push_back(target.Handle());
+        }
+        visit(profile);
+    }
+    return true;
+}
+
+// Profiles in `ranking` (fastest first) that score below `reference`
+// within its group, minus those `mimics` maps one of the reference's
+// listed targets to.
+template <typename Profiles, typename ScoreFn, typename GroupFn, typename MimicsFn>
+std::vector<std::uint32_t> SlowerCandidates(const Profiles& profiles, std::uint32_t reference,
+                                            std::span<const std::uint32_t> ranking, ScoreFn&& score,
+                                            GroupFn&& group, MimicsFn&& mimics) {
+    std::vector<std::uint32_t> listed;
+    for (const auto target : profiles[reference].Targets()) {
+        listed.push_back(mimics(target.Index()));
+    }
+    const double ceiling = score(reference);
+    const std::uint32_t referenceGroup = group(reference);
+    std::vector<std::uint32_t> candidates;
+    for (const std::uint32_t index : ranking) {
+        if (score(index) < ceiling && group(index) == referenceGroup &&
+            std::find(listed.begin(), listed.end(), index) == listed.end()) {
+            candidates.push_back(index);
+        }
+    }
+    return candidates;
+}
+
+// Synthesized targets never cap the CPU below this processor state, like
+// the generator's floor for listed tiers.
+constexpr int kMinCpuPercent = 25;
+// Thresholds at which synthesized targets ask for confirmation, after the
+// rules the catalog's listed tiers follow.
+constexpr int kConfirmCpuPercent = 35;
+constexpr double kConfirmRatio = 2.0 / 3.0;
+constexpr int kConfirmGpuPowerWatts = 130;
+// Caps are whole MHz/W rounded up, so they may leave slightly more than
+// the ratio; only a larger excess counts as not binding.
+constexpr double kCapRounding = 0.01;
+
+// Caps a nominal value to `mimicked` (the candidate's own nominal value,
+// if it has one) but never below `ratio` of it, so the cap alone does not
+// throttle harder than the scores call for.
+int ScaledCap(int nominal, int mimicked, double ratio) {
+    if (nominal <= 0) {
+        return mimicked > 0 ? mimicked : 0;
+    }
+    const int floor = static_cast<int>(std::ceil(ratio * nominal));
+    return std::max(mimicked > 0 ? std::min(mimicked, nominal) : floor, floor);
+}
+
+std::string SynthesizedId(std::string_view reference, std::string_view mimicked) {
+    std::string id(reference);
+    id += "-as-";
+    id += mimicked;
+    return id;
+}
+
+std::string SynthesizedLabel(std::string_view mimickedLabel) {
+    std::string label = "Mimic ";
+    label += mimickedLabel;
+    label += " (estimated)";
+    return label;
+}
+
+}  // namespace
+
+FleetOptions ProfileEngine::MatchFleet(std::span<const HardwareSnapshot> snapshots, const ProfileCatalog& catalog,
+                                       unsigned workerThreads) {
+    const size_t blockCount = (snapshots.size() + kFleetBlockSize - 1) / kFleetBlockSize;
+    const unsigned workers = workerThreads != 0 ? workerThreads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<FleetBlock> blocks(blockCount);
+    ParallelFor(blockCount, workers, [&](size_t blockIndex) {
+        FleetBlock& block = blocks[blockIndex];
+        const size_t first = blockIndex * kFleetBlockSize;
+        const size_t last = std::min(snapshots.size(), first + kFleetBlockSize);
+        block.cpuCounts.reserve(last - first);
+        block.adapterCounts.reserve(last - first);
+        block.gpuCounts.reserve(last - first);
+        const auto cpuProfiles = catalog.CpuProfiles();
+        const auto gpuProfiles = catalog.GpuProfiles();
+        std::vector<std::uint32_t> indices;
+        for (size_t i = first; i < last; ++i) {
+            const HardwareMatchKeys keys(snapshots[i]);
+            const size_t cpuBefore = block.cpuOptions.size();
+            MatchCpuProfiles(keys, catalog, indices);
+            for (const std::uint32_t index : indices) {
+                for (const auto target : cpuProfiles[index].Targets()) {
+                    block.cpuOptions.push_back(target.Handle());
+                }
+            }
+            block.cpuCounts.push_back(block.cpuOptions.size() - cpuBefore);
 
-    if (!snapshot.gpus.empty()) {
-        std::wstring gpuNameWide = snapshot.gpus.front().name;
-        std::string gpuName(gpuNameWide.begin(), gpuNameWide.end());
-        std::string gpuLower = ToLower(gpuName);
-        for (const auto& profile : database.gpuProfiles) {
-            if (MatchesTokens(gpuLower, profile.matchTokens)) {
-                gpuOptions_.insert(gpuOptions_.end(), profile.targets.begin(), profile.targets.end());
-                if (gpuNominalFrequencyMHz_ == 0 && profile.nominalFrequencyMHz > 0) {
-                    gpuNominalFrequencyMHz_ = profile.nominalFrequencyMHz;
+            block.adapterCounts.push_back(keys.gpus.size());
+            for (const auto& adapter : keys.gpus) {
+                const size_t gpuBefore = block.gpuOptions.size();
+                MatchGpuProfiles(adapter, catalog, indices);
+                for (const std::uint32_t index : indices) {
+                    for (const auto target : gpuProfiles[index].Targets()) {
+                        block.gpuOptions.push_back(target.Handle());
+                    }
                 }
-                if (gpuNominalPowerWatts_ == 0 && profile.nominalPowerWatts > 0) {
-                    gpuNominalPowerWatts_ = profile.nominalPowerWatts;
+                block.gpuCounts.push_back(block.gpuOptions.size() - gpuBefore);
+            }
+        }
+    });
+
+    FleetOptions fleet;
+    size_t cpuTotal = 0;
+    size_t adapterTotal = 0;
+    size_t gpuTotal = 0;
+    for (const auto& block : blocks) {
+        cpuTotal += block.cpuOptions.size();
+        adapterTotal += block.gpuCounts.size();
+        gpuTotal += block.gpuOptions.size();
+    }
+    fleet.cpuStart_.reserve(snapshots.size() + 1);
+    fleet.adapterStart_.reserve(snapshots.size() + 1);
+    fleet.gpuStart_.reserve(adapterTotal + 1);
+    fleet.cpuOptions_.reserve(cpuTotal);
+    fleet.gpuOptions_.reserve(gpuTotal);
+    fleet.cpuStart_.push_back(0);
+    fleet.adapterStart_.push_back(0);
+    fleet.gpuStart_.push_back(0);
+    for (const auto& block : blocks) {
+        for (const size_t count : block.cpuCounts) {
+            fleet.cpuStart_.push_back(fleet.cpuStart_.back() + count);
+        }
+        for (const size_t count : block.adapterCounts) {
+            fleet.adapterStart_.push_back(fleet.adapterStart_.back() + count);
+        }
+        for (const size_t count : block.gpuCounts) {
+            fleet.gpuStart_.push_back(fleet.gpuStart_.back() + count);
+        }
+        fleet.cpuOptions_.insert(fleet.cpuOptions_.end(), block.cpuOptions.begin(), block.cpuOptions.end());
+        fleet.gpuOptions_.insert(fleet.gpuOptions_.end(), block.gpuOptions.begin(), block.gpuOptions.end());
+    }
+    return fleet;
+}
+
+bool ProfileEngine::IsAffectedBy(const CatalogDiff& diff, const HardwareSnapshot& snapshot,
+                                 const ProfileCatalog& next) const {
+    const auto touchesMatched = [](const ProfileChanges& changes, const std::vector<std::string>& matched) {
+        for (const auto* ids : {&changes.changed, &changes.removed}) {
+            for (const auto& id : *ids) {
+                if (Contains(matched, id)) {
+                    return true;
                 }
             }
         }
+        return false;
+    };
+    if (touchesMatched(diff.cpu, cpuProfileIds_) ||
+        std::any_of(gpuAdapters_.begin(), gpuAdapters_.end(),
+                    [&](const GpuAdapterMatch& adapter) { return touchesMatched(diff.gpu, adapter.profileIds); })) {
+        return true;
+    }
+
+    const HardwareMatchKeys keys(snapshot);
+    const auto candidates = [](const ProfileChanges& changes) {
+        std::vector<std::string> ids = changes.added;
+        ids.insert(ids.end(), changes.changed.begin(), changes.changed.end());
+        return ids;
+    };
+    if (AnyMatches(next.CpuProfiles(), candidates(diff.cpu), MatchCpuProfiles(keys, next))) {
+        return true;
     }
+    const auto gpuCandidates = candidates(diff.gpu);
+    return std::any_of(keys.gpus.begin(), keys.gpus.end(), [&](const GpuMatchKeys& adapter) {
+        return AnyMatches(next.GpuProfiles(), gpuCandidates, MatchGpuProfiles(adapter, next));
+    });
 }
 
-bool ProfileEngine::MatchesTokens(const std::string& haystack, const std::vector<std::string>& tokens) {
-    if (tokens.empty()) {
+bool ProfileEngine::Rebind(const ProfileCatalog& next) {
+    std::vector<CpuTargetHandle> cpuOptions;
+    cpuOptions.reserve(cpuOptions_.size());
+    std::optional<std::uint32_t> cpuReference;
+    if (!AppendTargets(next.CpuProfiles(), cpuProfileIds_, cpuOptions,
+                       [&](const auto& profile) { TakeReference(cpuReference, profile.Index()); })) {
         return false;
     }
-    for (const auto& token : tokens) {
-        std::string tokenLower = ToLower(token);
-        if (!tokenLower.empty() && haystack.find(tokenLower) != std::string::npos) {
+    std::vector<std::vector<GpuTargetHandle>> gpuOptions(gpuAdapters_.size());
+    std::vector<std::optional<std::uint32_t>> gpuReferences(gpuAdapters_.size());
+    for (size_t i = 0; i < gpuAdapters_.size(); ++i) {
+        gpuOptions[i].reserve(gpuAdapters_[i].options.size());
+        if (!AppendTargets(next.GpuProfiles(), gpuAdapters_[i].profileIds, gpuOptions[i],
+                           [&](const auto& profile) { TakeReference(gpuReferences[i], profile.Index()); })) {
+            return false;
+        }
+    }
+    cpuOptions_ = std::move(cpuOptions);
+    cpuReference_ = cpuReference;
+    for (size_t i = 0; i < gpuAdapters_.size(); ++i) {
+        gpuAdapters_[i].options = std::move(gpuOptions[i]);
+        gpuAdapters_[i].reference = gpuReferences[i];
+    }
+    return true;
+}
+
+MatchedProfiles ProfileEngine::Matched() const {
+    MatchedProfiles matched;
+    matched.cpu = cpuProfileIds_;
+    matched.gpus.reserve(gpuAdapters_.size());
+    for (const auto& adapter : gpuAdapters_) {
+        matched.gpus.push_back(adapter.profileIds);
+    }
+    return matched;
+}
+
+bool ProfileEngine::Restore(const MatchedProfiles& matched, const ProfileCatalog& catalog) {
+    ProfileEngine restored;
+    if (!AppendTargets(catalog.CpuProfiles(), matched.cpu, restored.cpuOptions_, [&](const auto& profile) {
+            TakeReference(restored.cpuReference_, profile.Index());
+            TakeNominal(restored.cpuNominalFrequencyMHz_, profile.NominalFrequencyMHz());
+        })) {
+        return false;
+    }
+    restored.cpuProfileIds_ = matched.cpu;
+    restored.gpuAdapters_.resize(matched.gpus.size());
+    for (size_t i = 0; i < matched.gpus.size(); ++i) {
+        GpuAdapterMatch& adapter = restored.gpuAdapters_[i];
+        if (!AppendTargets(catalog.GpuProfiles(), matched.gpus[i], adapter.options, [&](const auto& profile) {
+                TakeReference(adapter.reference, profile.Index());
+                TakeNominal(adapter.nominalFrequencyMHz, profile.NominalFrequencyMHz());
+                TakeNominal(adapter.nominalPowerWatts, profile.NominalPowerWatts());
+            })) {
+            return false;
+        }
+        adapter.profileIds = matched.gpus[i];
+    }
+    *this = std::move(restored);
+    return true;
+}
+
+std::vector<std::uint32_t> ProfileEngine::CpuCandidates(const ProfileCatalog& catalog) const {
+    if (!cpuReference_) {
+        return {};
+    }
+    const PerformanceIndex& index = catalog.Performance();
+    return SlowerCandidates(
+        catalog.CpuProfiles(), *cpuReference_, index.CpuRanking(),
+        [&](std::uint32_t profile) { return index.CpuScore(profile); },
+        [&](std::uint32_t profile) { return index.CpuGroup(profile); },
+        [&](std::uint32_t target) { return index.CpuTargetMimics(target); });
+}
+
+std::vector<std::uint32_t> ProfileEngine::GpuCandidates(size_t adapter, const ProfileCatalog& catalog) const {
+    const auto& reference = gpuAdapters_[adapter].reference;
+    if (!reference) {
+        return {};
+    }
+    const PerformanceIndex& index = catalog.Performance();
+    return SlowerCandidates(
+        catalog.GpuProfiles(), *reference, index.GpuRanking(),
+        [&](std::uint32_t profile) { return index.GpuScore(profile); },
+        [&](std::uint32_t profile) { return index.GpuGroup(profile); },
+        [&](std::uint32_t target) { return index.GpuTargetMimics(target); });
+}
+
+// The processor-state cap carries the score ratio; the clock cap follows
+// the candidate's nominal clock where that is not tighter. Extra commands
+// are left out: only listed tiers run vetted shell snippets.
+std::optional<CpuThrottleTarget> ProfileEngine::SynthesizeCpuTarget(std::uint32_t profile,
+                                                                     const ProfileCatalog& catalog) const {
+    if (!cpuReference_) {
+        return std::nullopt;
+    }
+    const PerformanceIndex& index = catalog.Performance();
+    const auto reference = catalog.CpuProfiles()[*cpuReference_];
+    const auto mimicked = catalog.CpuProfiles()[profile];
+    const double ratio = std::min(1.0, index.CpuScore(profile) / index.CpuScore(*cpuReference_));
+
+    CpuThrottleTarget target;
+    target.id = SynthesizedId(reference.Id(), mimicked.Id());
+    target.label = SynthesizedLabel(mimicked.Label());
+    target.maxPercent = std::clamp(static_cast<int>(std::lround(ratio * 100.0)), kMinCpuPercent, 100);
+    target.maxFrequencyMHz = ScaledCap(cpuNominalFrequencyMHz_, mimicked.NominalFrequencyMHz(), ratio);
+    target.requiresConfirmation = target.maxPercent <= kConfirmCpuPercent || ratio <= kConfirmRatio;
+    return target;
+}
+
+// Clock and power caps follow the candidate's nominal values, as listed
+// tiers do; if together they still leave more than the score ratio, the
+// power cap (or, without one, the clock cap) is lowered to it.
+std::optional<GpuThrottleTarget> ProfileEngine::SynthesizeGpuTarget(size_t adapter, std::uint32_t profile,
+                                                                     const ProfileCatalog& catalog) const {
+    const GpuAdapterMatch& match = gpuAdapters_[adapter];
+    if (!match.reference) {
+        return std::nullopt;
+    }
+    const PerformanceIndex& index = catalog.Performance();
+    const auto reference = catalog.GpuProfiles()[*match.reference];
+    const auto mimicked = catalog.GpuProfiles()[profile];
+    const double ratio = std::min(1.0, index.GpuScore(profile) / index.GpuScore(*match.reference));
+
+    GpuThrottleTarget target;
+    target.id = SynthesizedId(reference.Id(), mimicked.Id());
+    target.label = SynthesizedLabel(mimicked.Label());
+    const int nominalClock = match.nominalFrequencyMHz;
+    const int nominalPower = match.nominalPowerWatts;
+    target.maxFrequencyMHz = ScaledCap(nominalClock, mimicked.NominalFrequencyMHz(), ratio);
+    target.powerLimitWatts = ScaledCap(nominalPower, mimicked.NominalPowerWatts(), ratio);
+    if (ProjectedGpuFactor(target.maxFrequencyMHz, target.powerLimitWatts, nominalClock, nominalPower) >
+        ratio + kCapRounding) {
+        if (nominalPower > 0) {
+            target.powerLimitWatts = static_cast<int>(std::ceil(ratio * nominalPower));
+        } else if (nominalClock > 0) {
+            target.maxFrequencyMHz = static_cast<int>(std::ceil(ratio * nominalClock));
+        }
+    }
+    if (target.maxFrequencyMHz > 0) {
+        const std::string clock = std::to_string(target.maxFrequencyMHz);
+        target.nvidiaSmiArgs.push_back("-lgc");
+        target.nvidiaSmiArgs.push_back(clock + "," + clock);
+    }
+    if (target.powerLimitWatts > 0) {
+        target.nvidiaSmiArgs.push_back("-pl");
+        target.nvidiaSmiArgs.push_back(std::to_string(target.powerLimitWatts));
+    }
+    target.requiresConfirmation = ratio <= kConfirmRatio ||
+                                  (target.powerLimitWatts > 0 && target.powerLimitWatts <= kConfirmGpuPowerWatts);
+    return target;
+}
+
+bool ProfileEngine::MatchesTokens(const std::string& haystack, const StringListView& tokens) {
+    for (std::string_view token : tokens) {
+        if (HardwareMatchKeys::ContainsToken(haystack, token)) {
             return true;
         }
     }
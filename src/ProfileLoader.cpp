@@ -1,11 +1,23 @@
 #include "ProfileLoader.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <exception>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <iterator>
+#include <optional>
 #include <stdexcept>
+#include <thread>
 
-using jsonlite::Value;
+#include "ParallelFor.hpp"
+#include "ProfileCatalog.hpp"
+#include "SimpleJson.hpp"
+
+using jsonlite::Event;
+using jsonlite::Reader;
 
 namespace {
 
@@ -14,92 +26,589 @@ std::string ReadUtf8File(const std::filesystem::path& path) {
     if (!stream) {
         throw std::runtime_error("Unable to open profile file");
     }
-    std::ostringstream buffer;
-    buffer << stream.rdbuf();
-    return buffer.str();
+    stream.seekg(0, std::ios::end);
+    const std::streamoff size = stream.tellg();
+    if (size < 0) {
+        throw std::runtime_error("Unable to size profile file");
+    }
+    std::string text(static_cast<size_t>(size), '\0');
+    stream.seekg(0, std::ios::beg);
+    if (!stream.read(text.data(), size)) {
+        throw std::runtime_error("Unable to read profile file");
+    }
+    return text;
 }
 
-}  // namespace
+constexpr std::uint32_t HashKey(std::string_view key) {
+    std::uint32_t hash = 2166136261u;
+    for (char c : key) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash;
+}
 
-ProfileDatabase ProfileLoader::LoadFromFile(const std::filesystem::path& path) const {
-    auto text = ReadUtf8File(path);
-    auto root = jsonlite::Parse(text);
+enum class FieldKind : std::uint8_t {
+    Text,
+    Integer,
+    Flag,
+    StringList,
+    Targets
+};
 
-    ProfileDatabase db;
-    const Value& cpuProfiles = root["cpuProfiles"];
-    if (cpuProfiles.IsArray()) {
-        for (const auto& entry : cpuProfiles.array) {
-            db.cpuProfiles.push_back(ParseCpuProfile(entry));
+template <typename T>
+struct Field {
+    constexpr Field(std::string_view n, std::string T::*member) : name(n), kind(FieldKind::Text), text(member) {}
+    constexpr Field(std::string_view n, int T::*member) : name(n), kind(FieldKind::Integer), integer(member) {}
+    constexpr Field(std::string_view n, bool T::*member) : name(n), kind(FieldKind::Flag), flag(member) {}
+    constexpr Field(std::string_view n, std::vector<std::string> T::*member)
+        : name(n), kind(FieldKind::StringList), list(member) {}
+    constexpr Field(std::string_view n, FieldKind k) : name(n), kind(k) {}
+
+    std::string_view name;
+    FieldKind kind;
+    std::string T::*text = nullptr;
+    int T::*integer = nullptr;
+    bool T::*flag = nullptr;
+    std::vector<std::string> T::*list = nullptr;
+};
+
+// Compile-time perfect hash over a struct's JSON keys: a key resolves with
+// one hash, one slot load and one compare. A slot collision fails the
+// constant evaluation, so adding a field can never silently shadow another.
+template <typename T, size_t N>
+class FieldTable {
+public:
+    static constexpr size_t kSlots = 32;
+    static constexpr std::uint8_t kEmpty = 0xFF;
+
+    constexpr explicit FieldTable(const std::array<Field<T>, N>& fields) : fields_(fields) {
+        static_assert(N < kSlots, "field table too small");
+        slots_.fill(kEmpty);
+        for (size_t i = 0; i < N; ++i) {
+            auto& slot = slots_[HashKey(fields_[i].name) % kSlots];
+            if (slot != kEmpty) {
+                throw std::logic_error("field hash collision");
+            }
+            slot = static_cast<std::uint8_t>(i);
+        }
+    }
+
+    const Field<T>* Find(std::string_view key) const {
+        const std::uint8_t index = slots_[HashKey(key) % kSlots];
+        if (index == kEmpty || fields_[index].name != key) {
+            return nullptr;
+        }
+        return &fields_[index];
+    }
+
+private:
+    std::array<Field<T>, N> fields_;
+    std::array<std::uint8_t, kSlots> slots_{};
+};
+
+constexpr FieldTable kCpuTargetFields(std::array<Field<CpuThrottleTarget>, 8>{{
+    {"id", &CpuThrottleTarget::id},
+    {"label", &CpuThrottleTarget::label},
+    {"maxFrequencyMHz", &CpuThrottleTarget::maxFrequencyMHz},
+    {"maxCores", &CpuThrottleTarget::maxCores},
+    {"maxThreads", &CpuThrottleTarget::maxThreads},
+    {"maxPercent", &CpuThrottleTarget::maxPercent},
+    {"extraCommands", &CpuThrottleTarget::extraCommands},
+    {"requiresConfirmation", &CpuThrottleTarget::requiresConfirmation},
+}});
+
+constexpr FieldTable kCpuProfileFields(std::array<Field<CpuProfile>, 6>{{
+    {"id", &CpuProfile::id},
+    {"label", &CpuProfile::label},
+    {"matchTokens", &CpuProfile::matchTokens},
+    {"cpuIds", &CpuProfile::cpuIds},
+    {"targets", FieldKind::Targets},
+    {"nominalFrequencyMHz", &CpuProfile::nominalFrequencyMHz},
+}});
+
+constexpr FieldTable kGpuTargetFields(std::array<Field<GpuThrottleTarget>, 6>{{
+    {"id", &GpuThrottleTarget::id},
+    {"label", &GpuThrottleTarget::label},
+    {"maxFrequencyMHz", &GpuThrottleTarget::maxFrequencyMHz},
+    {"powerLimitWatts", &GpuThrottleTarget::powerLimitWatts},
+    {"nvidiaSmiArgs", &GpuThrottleTarget::nvidiaSmiArgs},
+    {"requiresConfirmation", &GpuThrottleTarget::requiresConfirmation},
+}});
+
+constexpr FieldTable kGpuProfileFields(std::array<Field<GpuProfile>, 7>{{
+    {"id", &GpuProfile::id},
+    {"label", &GpuProfile::label},
+    {"matchTokens", &GpuProfile::matchTokens},
+    {"pciIds", &GpuProfile::pciIds},
+    {"targets", FieldKind::Targets},
+    {"nominalFrequencyMHz", &GpuProfile::nominalFrequencyMHz},
+    {"nominalPowerWatts", &GpuProfile::nominalPowerWatts},
+}});
+
+// Reads a value where a scalar is expected; containers of the wrong shape
+// are skipped so the field keeps its default, as a DOM lookup would.
+Event ReadScalar(Reader& reader) {
+    const Event event = reader.Next();
+    if (event == Event::StartObject || event == Event::StartArray) {
+        reader.SkipRest();
+    }
+    return event;
+}
+
+void ReadStringList(Reader& reader, std::vector<std::string>& items) {
+    items.clear();
+    const Event event = reader.Next();
+    if (event == Event::StartObject) {
+        reader.SkipRest();
+    }
+    if (event != Event::StartArray) {
+        return;
+    }
+    for (Event entry = reader.Next(); entry != Event::EndArray; entry = reader.Next()) {
+        if (entry == Event::String) {
+            items.emplace_back(reader.Text());
+        } else if (entry == Event::StartObject || entry == Event::StartArray) {
+            reader.SkipRest();
+        }
+    }
+}
+
+// Called after StartObject; binds each known key through the table and
+// skips the rest. `readTargets` handles the nested "targets" array.
+template <typename T, size_t N, typename TargetsFn>
+void ReadObject(Reader& reader, const FieldTable<T, N>& table, T& out, TargetsFn&& readTargets) {
+    for (Event event = reader.Next(); event != Event::EndObject; event = reader.Next()) {
+        const Field<T>* field = table.Find(reader.Text());
+        if (!field) {
+            reader.SkipValue();
+            continue;
+        }
+        switch (field->kind) {
+            case FieldKind::Text:
+                if (ReadScalar(reader) == Event::String) {
+                    out.*(field->text) = reader.Text();
+                }
+                break;
+            case FieldKind::Integer:
+                if (ReadScalar(reader) == Event::Number) {
+                    out.*(field->integer) = static_cast<int>(reader.Number());
+                }
+                break;
+            case FieldKind::Flag:
+                if (ReadScalar(reader) == Event::Bool) {
+                    out.*(field->flag) = reader.Boolean();
+                }
+                break;
+            case FieldKind::StringList:
+                ReadStringList(reader, out.*(field->list));
+                break;
+            case FieldKind::Targets:
+                readTargets(reader, out);
+                break;
         }
     }
+}
+
+template <typename T, size_t N>
+void ReadObject(Reader& reader, const FieldTable<T, N>& table, T& out) {
+    ReadObject(reader, table, out, [](Reader& r, T&) { r.SkipValue(); });
+}
+
+// Reads an array of objects, appending one element per entry.
+template <typename T, typename ElementFn>
+void ReadObjectArray(Reader& reader, std::vector<T>& items, ElementFn&& readElement) {
+    items.clear();
+    const Event event = reader.Next();
+    if (event == Event::StartObject) {
+        reader.SkipRest();
+    }
+    if (event != Event::StartArray) {
+        return;
+    }
+    for (Event entry = reader.Next(); entry != Event::EndArray; entry = reader.Next()) {
+        // Non-object entries still yield a default element, as before.
+        T& item = items.emplace_back();
+        if (entry == Event::StartObject) {
+            readElement(reader, item);
+        } else if (entry == Event::StartArray) {
+            reader.SkipRest();
+        }
+    }
+}
+
+void ReadCpuTargets(Reader& reader, CpuProfile& profile) {
+    ReadObjectArray(reader, profile.targets, [](Reader& r, CpuThrottleTarget& target) {
+        ReadObject(r, kCpuTargetFields, target);
+    });
+}
+
+void ReadGpuTargets(Reader& reader, GpuProfile& profile) {
+    ReadObjectArray(reader, profile.targets, [](Reader& r, GpuThrottleTarget& target) {
+        ReadObject(r, kGpuTargetFields, target);
+    });
+}
+
+void ReadCpuProfile(Reader& reader, CpuProfile& profile) {
+    ReadObject(reader, kCpuProfileFields, profile, ReadCpuTargets);
+}
+
+void ReadGpuProfile(Reader& reader, GpuProfile& profile) {
+    ReadObject(reader, kGpuProfileFields, profile, ReadGpuTargets);
+}
 
-    const Value& gpuProfiles = root["gpuProfiles"];
-    if (gpuProfiles.IsArray()) {
-        for (const auto& entry : gpuProfiles.array) {
-            db.gpuProfiles.push_back(ParseGpuProfile(entry));
+// Walks the root object, handing the two profile arrays to the callbacks.
+template <typename CpuFn, typename GpuFn>
+void ReadRoot(Reader& reader, CpuFn&& readCpuProfiles, GpuFn&& readGpuProfiles) {
+    const Event root = reader.Next();
+    if (root == Event::StartArray) {
+        reader.SkipRest();
+    } else if (root == Event::StartObject) {
+        for (Event event = reader.Next(); event != Event::EndObject; event = reader.Next()) {
+            const std::string_view key = reader.Text();
+            if (key == "cpuProfiles") {
+                readCpuProfiles(reader);
+            } else if (key == "gpuProfiles") {
+                readGpuProfiles(reader);
+            } else {
+                reader.SkipValue();
+            }
         }
     }
+    reader.Next();  // End; throws on trailing characters
+}
+
+ProfileDatabase ReadDatabase(std::string_view text) {
+    ProfileDatabase db;
+    Reader reader(text);
+    ReadRoot(
+        reader, [&](Reader& r) { ReadObjectArray(r, db.cpuProfiles, ReadCpuProfile); },
+        [&](Reader& r) { ReadObjectArray(r, db.gpuProfiles, ReadGpuProfile); });
     return db;
 }
 
-CpuProfile ProfileLoader::ParseCpuProfile(const Value& value) const {
-    CpuProfile profile;
-    profile.id = value["id"].GetString();
-    profile.label = value["label"].GetString();
-    profile.matchTokens = ParseStringArray(value["matchTokens"]);
-    profile.nominalFrequencyMHz = static_cast<int>(value["nominalFrequencyMHz"].GetNumber(0));
-
-    const Value& targets = value["targets"];
-    if (targets.IsArray()) {
-        for (const auto& entry : targets.array) {
-            CpuThrottleTarget target;
-            target.id = entry["id"].GetString();
-            target.label = entry["label"].GetString();
-            target.maxFrequencyMHz = static_cast<int>(entry["maxFrequencyMHz"].GetNumber(0));
-            target.maxCores = static_cast<int>(entry["maxCores"].GetNumber(0));
-            target.maxThreads = static_cast<int>(entry["maxThreads"].GetNumber(0));
-            target.maxPercent = static_cast<int>(entry["maxPercent"].GetNumber(100));
-            target.extraCommands = ParseStringArray(entry["extraCommands"]);
-            target.requiresConfirmation = entry["requiresConfirmation"].GetBool(false);
-            profile.targets.push_back(std::move(target));
+// Below this size thread start-up costs more than the parse it saves.
+constexpr size_t kParallelMinBytes = 512 * 1024;
+constexpr size_t kMinChunkBytes = 16 * 1024;
+
+unsigned WorkerCount(size_t textSize, unsigned requested) {
+    if (requested != 0) {
+        return requested;
+    }
+    if (textSize < kParallelMinBytes) {
+        return 1;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Byte range of one object entry in a profile array. An empty slice stands
+// for a non-object entry, which the serial pass turns into a default
+// profile.
+struct ElementSlice {
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+struct CatalogLayout {
+    std::vector<ElementSlice> cpu;
+    std::vector<ElementSlice> gpu;
+};
+
+void ScanElements(Reader& reader, std::vector<ElementSlice>& slices) {
+    slices.clear();
+    const Event event = reader.Next();
+    if (event == Event::StartObject) {
+        reader.SkipRest();
+    }
+    if (event != Event::StartArray) {
+        return;
+    }
+    for (Event entry = reader.Next(); entry != Event::EndArray; entry = reader.Next()) {
+        if (entry == Event::StartObject) {
+            const size_t begin = reader.Offset() - 1;  // at the '{'
+            reader.SkipRest();
+            slices.push_back({begin, reader.Offset()});
+        } else {
+            if (entry == Event::StartArray) {
+                reader.SkipRest();
+            }
+            slices.emplace_back();
         }
     }
-    return profile;
-}
-
-GpuProfile ProfileLoader::ParseGpuProfile(const Value& value) const {
-    GpuProfile profile;
-    profile.id = value["id"].GetString();
-    profile.label = value["label"].GetString();
-    profile.matchTokens = ParseStringArray(value["matchTokens"]);
-    profile.nominalFrequencyMHz = static_cast<int>(value["nominalFrequencyMHz"].GetNumber(0));
-    profile.nominalPowerWatts = static_cast<int>(value["nominalPowerWatts"].GetNumber(0));
-
-    const Value& targets = value["targets"];
-    if (targets.IsArray()) {
-        for (const auto& entry : targets.array) {
-            GpuThrottleTarget target;
-            target.id = entry["id"].GetString();
-            target.label = entry["label"].GetString();
-            target.maxFrequencyMHz = static_cast<int>(entry["maxFrequencyMHz"].GetNumber(0));
-            target.powerLimitWatts = static_cast<int>(entry["powerLimitWatts"].GetNumber(0));
-            target.nvidiaSmiArgs = ParseStringArray(entry["nvidiaSmiArgs"]);
-            target.requiresConfirmation = entry["requiresConfirmation"].GetBool(false);
-            profile.targets.push_back(std::move(target));
+}
+
+// Pre-scan for the chunked parse: walks the root like ReadRoot (so a
+// repeated key still replaces the earlier array) but only skips over the
+// profile objects, recording where each one lies.
+CatalogLayout ScanLayout(std::string_view text) {
+    CatalogLayout layout;
+    Reader reader(text);
+    ReadRoot(reader, [&](Reader& r) { ScanElements(r, layout.cpu); },
+             [&](Reader& r) { ScanElements(r, layout.gpu); });
+    return layout;
+}
+
+struct Chunk {
+    bool gpu = false;
+    size_t first = 0;
+    size_t last = 0;  // one past the final element
+};
+
+void AppendChunks(const std::vector<ElementSlice>& slices, bool gpu, size_t targetBytes, std::vector<Chunk>& chunks) {
+    size_t first = 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < slices.size(); ++i) {
+        bytes += slices[i].end - slices[i].begin;
+        if (bytes >= targetBytes || i + 1 == slices.size()) {
+            chunks.push_back({gpu, first, i + 1});
+            first = i + 1;
+            bytes = 0;
+        }
+    }
+}
+
+template <typename Profile, typename ProfileFn>
+void ReadChunk(std::string_view text, const std::vector<ElementSlice>& slices, const Chunk& chunk,
+               std::vector<Profile>& items, ProfileFn&& readProfile) {
+    Reader reader(std::string_view{});
+    for (size_t i = chunk.first; i < chunk.last; ++i) {
+        const ElementSlice& slice = slices[i];
+        if (slice.begin == slice.end) {
+            continue;
+        }
+        reader.Reset(text.substr(slice.begin, slice.end - slice.begin));
+        reader.Next();  // StartObject
+        readProfile(reader, items[i]);
+    }
+}
+
+// Pre-scans element boundaries, then parses runs of whole profile objects
+// on worker threads straight into their final slots, so the merge keeps
+// document order for free. Returns nullopt on malformed input; the serial
+// pass then reproduces the exact error.
+std::optional<ProfileDatabase> ReadDatabaseChunked(std::string_view text, unsigned workers) {
+    try {
+        const CatalogLayout layout = ScanLayout(text);
+        ProfileDatabase db;
+        db.cpuProfiles.resize(layout.cpu.size());
+        db.gpuProfiles.resize(layout.gpu.size());
+
+        const size_t targetBytes = std::max(kMinChunkBytes, text.size() / (static_cast<size_t>(workers) * 4));
+        std::vector<Chunk> chunks;
+        AppendChunks(layout.cpu, false, targetBytes, chunks);
+        AppendChunks(layout.gpu, true, targetBytes, chunks);
+
+        ParallelFor(chunks.size(), workers, [&](size_t index) {
+            const Chunk& chunk = chunks[index];
+            if (chunk.gpu) {
+                ReadChunk(text, layout.gpu, chunk, db.gpuProfiles, ReadGpuProfile);
+            } else {
+                ReadChunk(text, layout.cpu, chunk, db.cpuProfiles, ReadCpuProfile);
+            }
+        });
+        return db;
+    } catch (const jsonlite::ParseError&) {
+        return std::nullopt;
+    }
+}
+
+bool MatchesAnyToken(std::string_view key, const std::vector<std::string>& tokens) {
+    return std::any_of(tokens.begin(), tokens.end(), [key](const std::string& token) {
+        return HardwareMatchKeys::ContainsToken(key, token);
+    });
+}
+
+// Whether any catalog ID string covers `device`; malformed ones never do.
+template <typename Key>
+bool MatchesAnyId(const std::optional<Key>& device, const std::vector<std::string>& ids) {
+    if (!device) {
+        return false;
+    }
+    return std::any_of(ids.begin(), ids.end(), [&](const std::string& text) {
+        const auto key = Key::Parse(text);
+        return key && key->Covers(*device);
+    });
+}
+
+// The superset kept by LoadMatching: an ID hit or a token hit. Refresh
+// then prefers ID hits over token hits, as it would on the full catalog.
+bool MatchesProfile(const HardwareMatchKeys& keys, const CpuProfile& profile) {
+    return MatchesAnyId(keys.cpuId, profile.cpuIds) || MatchesAnyToken(keys.cpu, profile.matchTokens);
+}
+
+bool MatchesProfile(const HardwareMatchKeys& keys, const GpuProfile& profile) {
+    return std::any_of(keys.gpus.begin(), keys.gpus.end(), [&](const GpuMatchKeys& adapter) {
+        return MatchesAnyId(adapter.id, profile.pciIds) || MatchesAnyToken(adapter.name, profile.matchTokens);
+    });
+}
+
+// Clears a scratch profile without giving up its capacity.
+void ResetProfile(CpuProfile& profile) {
+    profile.id.clear();
+    profile.label.clear();
+    profile.matchTokens.clear();
+    profile.cpuIds.clear();
+    profile.targets.clear();
+    profile.nominalFrequencyMHz = 0;
+}
+
+void ResetProfile(GpuProfile& profile) {
+    profile.id.clear();
+    profile.label.clear();
+    profile.matchTokens.clear();
+    profile.pciIds.clear();
+    profile.targets.clear();
+    profile.nominalFrequencyMHz = 0;
+    profile.nominalPowerWatts = 0;
+}
+
+// Reads one profile object (after StartObject) and reports whether it
+// matches `keys`. "targets" is decoded straight away when the fields seen
+// so far match; otherwise only its offset is kept, and it is re-read from
+// there if a later "matchTokens" or ID list turns the profile into a match.
+template <typename Profile, size_t N, typename TargetsFn>
+bool ReadProfileIfMatching(Reader& reader, std::string_view text, const FieldTable<Profile, N>& table,
+                           const HardwareMatchKeys& keys, Profile& profile, TargetsFn&& readTargets) {
+    size_t deferredTargets = std::string_view::npos;
+    ReadObject(reader, table, profile, [&](Reader& r, Profile& p) {
+        if (MatchesProfile(keys, p)) {
+            readTargets(r, p);
+            deferredTargets = std::string_view::npos;
+        } else {
+            p.targets.clear();
+            deferredTargets = r.Offset();
+            r.SkipValue();
         }
+    });
+    if (!MatchesProfile(keys, profile)) {
+        return false;
     }
-    return profile;
+    if (deferredTargets != std::string_view::npos) {
+        Reader targets(text.substr(deferredTargets));
+        readTargets(targets, profile);
+    }
+    return true;
 }
 
-std::vector<std::string> ProfileLoader::ParseStringArray(const Value& value) const {
-    std::vector<std::string> items;
-    if (!value.IsArray()) {
-        return items;
+// Like ReadObjectArray, but only matching profiles are kept. Rejected
+// entries reuse one scratch profile, so they cost no allocations beyond
+// the odd long token string.
+template <typename Profile, typename ProfileFn>
+void ReadMatchingProfiles(Reader& reader, std::vector<Profile>& items, ProfileFn&& readProfile) {
+    items.clear();
+    const Event event = reader.Next();
+    if (event == Event::StartObject) {
+        reader.SkipRest();
+    }
+    if (event != Event::StartArray) {
+        return;
     }
-    for (const auto& entry : value.array) {
-        if (entry.IsString()) {
-            items.push_back(entry.string);
+    Profile scratch;
+    for (Event entry = reader.Next(); entry != Event::EndArray; entry = reader.Next()) {
+        if (entry == Event::StartObject) {
+            ResetProfile(scratch);
+            if (readProfile(reader, scratch)) {
+                items.push_back(std::move(scratch));
+            }
+        } else if (entry == Event::StartArray) {
+            reader.SkipRest();
         }
     }
-    return items;
+}
+
+template <typename CompileFn>
+ProfileCatalog LoadCatalogWith(const std::filesystem::path& path, CompileFn&& compile) {
+    std::filesystem::path binaryPath = path;
+    binaryPath.replace_extension(".bin");
+    std::error_code ec;
+    const bool haveSource = std::filesystem::exists(path, ec);
+    const std::string text = haveSource ? ReadUtf8File(path) : std::string();
+    const std::uint64_t sourceHash = ProfileCatalog::HashSource(text);
+
+    if (auto mapped = ProfileCatalog::Map(binaryPath)) {
+        if (!haveSource || mapped->SourceHash() == sourceHash) {
+            return *std::move(mapped);
+        }
+    }
+    if (!haveSource) {
+        throw std::runtime_error("Unable to open profile file");
+    }
+    return compile(text, sourceHash);
+}
+
+}  // namespace
+
+HardwareMatchKeys::HardwareMatchKeys(const HardwareSnapshot& snapshot) {
+    auto lower = [](unsigned char c) { return static_cast<char>(std::tolower(c)); };
+    std::transform(snapshot.cpu.name.begin(), snapshot.cpu.name.end(), std::back_inserter(cpu), lower);
+    cpuId = CpuIdKey::FromInfo(snapshot.cpu);
+    gpus.reserve(snapshot.gpus.size());
+    for (const auto& info : snapshot.gpus) {
+        gpus.push_back(GpuMatchKeys::FromInfo(info));
+    }
+}
+
+GpuMatchKeys GpuMatchKeys::FromInfo(const GpuInfo& info) {
+    GpuMatchKeys keys;
+    // Catalog tokens are ASCII; wide characters are narrowed as before.
+    for (wchar_t c : info.name) {
+        keys.name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(static_cast<char>(c)))));
+    }
+    keys.id = PciIdKey::FromInfo(info);
+    return keys;
+}
+
+bool HardwareMatchKeys::ContainsToken(std::string_view key, std::string_view token) {
+    if (token.empty()) {
+        return false;
+    }
+    auto equalsLower = [](char keyChar, char tokenChar) {
+        return keyChar == static_cast<char>(std::tolower(static_cast<unsigned char>(tokenChar)));
+    };
+    return std::search(key.begin(), key.end(), token.begin(), token.end(), equalsLower) != key.end();
+}
+
+ProfileCatalog ProfileLoader::LoadCatalog(const std::filesystem::path& path) const {
+    return LoadCatalogWith(path, [this](std::string_view text, std::uint64_t sourceHash) {
+        return ProfileCatalog::Compile(LoadFromText(text), sourceHash);
+    });
+}
+
+ProfileCatalog ProfileLoader::LoadCatalog(const std::filesystem::path& path, const HardwareSnapshot& snapshot) const {
+    return LoadCatalogWith(path, [&](std::string_view text, std::uint64_t sourceHash) {
+        return ProfileCatalog::Compile(LoadMatching(text, snapshot), sourceHash, true);
+    });
+}
+
+ProfileDatabase ProfileLoader::LoadFromFile(const std::filesystem::path& path) const {
+    const std::string text = ReadUtf8File(path);
+    return LoadFromText(text);
+}
+
+ProfileDatabase ProfileLoader::LoadFromText(std::string_view text) const {
+    const unsigned workers = WorkerCount(text.size(), workerThreads_);
+    if (workers > 1) {
+        if (auto db = ReadDatabaseChunked(text, workers)) {
+            return *std::move(db);
+        }
+    }
+    return ReadDatabase(text);
+}
+
+ProfileDatabase ProfileLoader::LoadMatching(std::string_view text, const HardwareSnapshot& snapshot) const {
+    const HardwareMatchKeys keys(snapshot);
+    ProfileDatabase db;
+    Reader reader(text);
+    ReadRoot(
+        reader,
+        [&](Reader& r) {
+            ReadMatchingProfiles(r, db.cpuProfiles, [&](Reader& pr, CpuProfile& profile) {
+                return ReadProfileIfMatching(pr, text, kCpuProfileFields, keys, profile, ReadCpuTargets);
+            });
+        },
+        [&](Reader& r) {
+            ReadMatchingProfiles(r, db.gpuProfiles, [&](Reader& pr, GpuProfile& profile) {
+                return ReadProfileIfMatching(pr, text, kGpuProfileFields, keys, profile, ReadGpuTargets);
+            });
+        });
+    return db;
 }
@@ -0,0 +1,142 @@
+#include "StartupCache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "BinaryIo.hpp"
+
+namespace {
+
+constexpr char kMagic[8] = {'H', 'W', 'L', 'S', 'T', 'A', 'R', 'T'};
+constexpr std::uint32_t kVersion = 2;
+
+void WriteSnapshot(BinaryWriter& writer, const HardwareSnapshot& snapshot) {
+    const CpuInfo& cpu = snapshot.cpu;
+    writer.String(cpu.name);
+    writer.String(cpu.vendor);
+    for (const unsigned value : {cpu.logicalCores, cpu.physicalCores, cpu.family, cpu.model, cpu.stepping}) {
+        writer.U32(value);
+    }
+    writer.U32(static_cast<std::uint32_t>(snapshot.gpus.size()));
+    for (const GpuInfo& gpu : snapshot.gpus) {
+        writer.WideString(gpu.name);
+        writer.WideString(gpu.vendor);
+        writer.U64(gpu.dedicatedVideoMemoryMB);
+        for (const unsigned value : {gpu.adapterIndex, gpu.vendorId, gpu.deviceId, gpu.subsystemId, gpu.revision}) {
+            writer.U32(value);
+        }
+        writer.String(gpu.pciBusId);
+    }
+}
+
+HardwareSnapshot ReadSnapshot(BinaryReader& reader) {
+    HardwareSnapshot snapshot;
+    CpuInfo& cpu = snapshot.cpu;
+    cpu.name = reader.String();
+    cpu.vendor = reader.String();
+    for (unsigned* value : {&cpu.logicalCores, &cpu.physicalCores, &cpu.family, &cpu.model, &cpu.stepping}) {
+        *value = reader.U32();
+    }
+    // Each adapter takes at least three empty strings, a U64 and five U32s.
+    const std::uint32_t gpuCount = reader.Count(40);
+    snapshot.gpus.resize(gpuCount);
+    for (GpuInfo& gpu : snapshot.gpus) {
+        gpu.name = reader.WideString();
+        gpu.vendor = reader.WideString();
+        gpu.dedicatedVideoMemoryMB = static_cast<size_t>(reader.U64());
+        for (unsigned* value : {&gpu.adapterIndex, &gpu.vendorId, &gpu.deviceId, &gpu.subsystemId, &gpu.revision}) {
+            *value = reader.U32();
+        }
+        gpu.pciBusId = reader.String();
+    }
+    return snapshot;
+}
+
+}  // namespace
+
+std::optional<StartupCacheEntry> StartupCache::Load() const {
+    std::ifstream stream(path_, std::ios::binary);
+    if (!stream) {
+        return std::nullopt;
+    }
+    const std::string file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    std::uint64_t checksum = 0;
+    if (file.size() < sizeof(checksum)) {
+        return std::nullopt;
+    }
+    const std::string_view data(file.data(), file.size() - sizeof(checksum));
+    std::memcpy(&checksum, file.data() + data.size(), sizeof(checksum));
+    if (checksum != BinaryChecksum(data)) {
+        return std::nullopt;
+    }
+    BinaryReader reader(data);
+    char magic[sizeof(kMagic)] = {};
+    reader.Bytes(magic, sizeof(magic));
+    if (!reader.Ok() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || reader.U32() != kVersion) {
+        return std::nullopt;
+    }
+
+    StartupCacheEntry entry;
+    entry.hardwareFingerprint = reader.U64();
+    entry.catalogHash = reader.U64();
+    entry.snapshot = ReadSnapshot(reader);
+    entry.matched.cpu = reader.StringList();
+    const std::uint32_t adapterCount = reader.Count(sizeof(std::uint32_t));
+    entry.matched.gpus.resize(adapterCount);
+    for (auto& ids : entry.matched.gpus) {
+        ids = reader.StringList();
+    }
+    if (!reader.AtEnd() || entry.matched.gpus.size() != entry.snapshot.gpus.size()) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+bool StartupCache::Save(const StartupCacheEntry& entry) const {
+    BinaryWriter writer;
+    writer.Bytes(kMagic, sizeof(kMagic));
+    writer.U32(kVersion);
+    writer.U64(entry.hardwareFingerprint);
+    writer.U64(entry.catalogHash);
+    WriteSnapshot(writer, entry.snapshot);
+    writer.StringList(entry.matched.cpu);
+    writer.U32(static_cast<std::uint32_t>(entry.matched.gpus.size()));
+    for (const auto& ids : entry.matched.gpus) {
+        writer.StringList(ids);
+    }
+    writer.U64(BinaryChecksum(writer.Buffer()));
+
+    std::error_code ec;
+    std::filesystem::create_directories(path_.parent_path(), ec);
+    std::filesystem::path temp = path_;
+    temp += ".tmp";
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            return false;
+        }
+        const std::string& buffer = writer.Buffer();
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!stream) {
+            stream.close();
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp, path_, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+void StartupCache::Invalidate() const {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+}
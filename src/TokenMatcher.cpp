@@ -0,0 +1,152 @@
+#include "TokenMatcher.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::uint32_t kNoState = ~0u;
+
+unsigned char LowerAscii(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+}  // namespace
+
+TokenMatcher::TokenMatcher(std::span<const Pattern> patterns) {
+    // Byte classes: one per distinct lower-cased token byte; upper-case
+    // letters share their lower-case class.
+    classCount_ = 1;
+    for (const auto& [token, value] : patterns) {
+        for (const char c : token) {
+            const unsigned char lower = LowerAscii(static_cast<unsigned char>(c));
+            if (classes_[lower] == 0) {
+                if (classCount_ > 255) {
+                    throw std::length_error("TokenMatcher: too many distinct token bytes");
+                }
+                classes_[lower] = static_cast<std::uint8_t>(classCount_++);
+            }
+        }
+    }
+    for (unsigned c = 'A'; c <= 'Z'; ++c) {
+        classes_[c] = classes_[LowerAscii(static_cast<unsigned char>(c))];
+    }
+
+    // Trie of the tokens, one dense row per state; outputs are collected
+    // as (state, value) pairs.
+    transitions_.assign(classCount_, kNoState);
+    std::uint32_t stateCount = 1;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> ownOutputs;
+    ownOutputs.reserve(patterns.size());
+    for (const auto& [token, value] : patterns) {
+        if (token.empty()) {
+            continue;
+        }
+        std::uint32_t state = 0;
+        for (const char c : token) {
+            const size_t slot = state * classCount_ + classes_[static_cast<unsigned char>(c)];
+            if (transitions_[slot] == kNoState) {
+                if (stateCount == kHasOutput - 1) {
+                    throw std::length_error("TokenMatcher: too many states");
+                }
+                transitions_[slot] = stateCount++;
+                transitions_.resize(transitions_.size() + classCount_, kNoState);
+            }
+            state = transitions_[slot];
+        }
+        ownOutputs.emplace_back(state, value);
+    }
+    std::sort(ownOutputs.begin(), ownOutputs.end());
+    ownOutputs.erase(std::unique(ownOutputs.begin(), ownOutputs.end()), ownOutputs.end());
+    std::vector<std::uint32_t> ownStart(stateCount + 1, 0);
+    for (const auto& output : ownOutputs) {
+        ++ownStart[output.first + 1];
+    }
+    for (std::uint32_t state = 0; state < stateCount; ++state) {
+        ownStart[state + 1] += ownStart[state];
+    }
+    const auto hasOwn = [&](std::uint32_t state) { return ownStart[state] != ownStart[state + 1]; };
+
+    // Breadth-first, fill missing transitions from the failure state so the
+    // table becomes a DFA. `outputLink` is the nearest proper suffix state
+    // that ends a token, if any.
+    std::vector<std::uint32_t> failure(stateCount, 0);
+    std::vector<std::uint32_t> outputLink(stateCount, kNoState);
+    std::vector<std::uint32_t> queue;
+    queue.reserve(stateCount);
+    for (std::uint32_t c = 0; c < classCount_; ++c) {
+        std::uint32_t& next = transitions_[c];
+        if (next == kNoState) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const std::uint32_t state = queue[head];
+        const std::uint32_t* fallback = &transitions_[failure[state] * classCount_];
+        for (std::uint32_t c = 0; c < classCount_; ++c) {
+            std::uint32_t& next = transitions_[state * classCount_ + c];
+            if (next == kNoState) {
+                next = fallback[c];
+            } else {
+                const std::uint32_t suffix = fallback[c];
+                failure[next] = suffix;
+                outputLink[next] = hasOwn(suffix) ? suffix : outputLink[suffix];
+                queue.push_back(next);
+            }
+        }
+    }
+
+    // Flatten each state's outputs, its own plus those along the links.
+    outputStart_.reserve(stateCount + 1);
+    std::vector<bool> hasOutput(stateCount, false);
+    std::vector<std::uint32_t> values;
+    for (std::uint32_t state = 0; state < stateCount; ++state) {
+        outputStart_.push_back(static_cast<std::uint32_t>(outputs_.size()));
+        values.clear();
+        for (std::uint32_t link = hasOwn(state) ? state : outputLink[state]; link != kNoState;
+             link = outputLink[link]) {
+            for (std::uint32_t i = ownStart[link]; i < ownStart[link + 1]; ++i) {
+                values.push_back(ownOutputs[i].second);
+            }
+        }
+        if (values.empty()) {
+            continue;
+        }
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        outputs_.insert(outputs_.end(), values.begin(), values.end());
+        hasOutput[state] = true;
+    }
+    outputStart_.push_back(static_cast<std::uint32_t>(outputs_.size()));
+    for (std::uint32_t& next : transitions_) {
+        if (hasOutput[next]) {
+            next |= kHasOutput;
+        }
+    }
+}
+
+std::vector<std::uint32_t> TokenMatcher::Match(std::string_view text) const {
+    std::vector<std::uint32_t> values;
+    Match(text, values);
+    return values;
+}
+
+void TokenMatcher::Match(std::string_view text, std::vector<std::uint32_t>& values) const {
+    values.clear();
+    if (transitions_.empty()) {
+        return;
+    }
+    std::uint32_t state = 0;
+    for (const char c : text) {
+        const std::uint32_t next = transitions_[state * classCount_ + classes_[static_cast<unsigned char>(c)]];
+        state = next & ~kHasOutput;
+        if ((next & kHasOutput) != 0) {
+            values.insert(values.end(), outputs_.begin() + outputStart_[state],
+                          outputs_.begin() + outputStart_[state + 1]);
+        }
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
@@ -0,0 +1,829 @@
+#include "WorkloadBenchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkStats.hpp"
+
+namespace {
+
+constexpr double kCallSeconds = 0.01;  // per timed call; passes are added until a call takes about this long
+constexpr double kReferencePoints = 1000.0;
+
+constexpr size_t kTextBytes = 256 * 1024;  // the LZ, hashing and text kernels' input
+constexpr size_t kVocabulary = 512;
+constexpr size_t kTreeNodes = 16 * 1024;
+constexpr size_t kTreeLookups = 16 * 1024;  // half of them for keys in the tree
+constexpr size_t kSortKeys = 128 * 1024;
+constexpr size_t kClothSide = 40;  // particles per row and column
+constexpr int kClothSteps = 16;
+constexpr int kClothIterations = 3;  // constraint relaxation passes per step
+constexpr int kLzHashBits = 12;
+constexpr size_t kLzMinMatch = 4;
+constexpr size_t kLzMaxOffset = 65535;
+constexpr size_t kWordTableSize = 2048;  // a power of two, well above kVocabulary
+
+// SplitMix64: tiny, and its output is the same on every platform (unlike
+// the standard distributions), which the checksums depend on.
+class SplitMix {
+public:
+    explicit SplitMix(std::uint64_t seed) : state_(seed) {}
+
+    std::uint64_t Next() {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound).
+    std::uint32_t Below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((Next() >> 32) * bound) >> 32);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+std::uint32_t Load32(const std::uint8_t* bytes) {
+    std::uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+// A kernel's output folded eight bytes at a time: FNV-1a's byte loop
+// would cost as much as a fast kernel itself.
+std::uint64_t Fold(const void* data, size_t size) {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    std::uint64_t hash = 14695981039346656037ull ^ size;
+    for (; size >= 8; bytes += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, bytes, size);
+    return (hash ^ tail) * 1099511628211ull;
+}
+
+// ---- LZ77 ----------------------------------------------------------------
+// LZ4-like sequences: a token (literal count in the high nibble, match
+// length - 4 in the low one, 15 meaning more in 255-continued bytes), the
+// literals, then a 2-byte match offset. The last sequence is literals
+// only. The compressor is greedy, with a single-entry hash table of
+// 4-byte prefixes.
+
+size_t LzBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+void LzLength(std::uint8_t*& out, size_t rest) {
+    for (; rest >= 255; rest -= 255) {
+        *out++ = 255;
+    }
+    *out++ = static_cast<std::uint8_t>(rest);
+}
+
+size_t LzCompress(const std::uint8_t* in, size_t size, std::uint8_t* out, std::uint32_t* table) {
+    std::fill(table, table + (size_t(1) << kLzHashBits), 0u);  // position + 1; 0 is empty
+    std::uint8_t* const start = out;
+    const auto literals = [&](size_t from, size_t count, size_t matchCode) {
+        *out++ = static_cast<std::uint8_t>((std::min<size_t>(count, 15) << 4) | std::min<size_t>(matchCode, 15));
+        if (count >= 15) {
+            LzLength(out, count - 15);
+        }
+        std::memcpy(out, in + from, count);
+        out += count;
+    };
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + kLzMinMatch <= size) {
+        const std::uint32_t sequence = Load32(in + pos);
+        const std::uint32_t hash = (sequence * 2654435761u) >> (32 - kLzHashBits);
+        const std::uint32_t candidate = table[hash];
+        table[hash] = static_cast<std::uint32_t>(pos + 1);
+        if (candidate == 0 || pos - (candidate - 1) > kLzMaxOffset || Load32(in + candidate - 1) != sequence) {
+            ++pos;
+            continue;
+        }
+        const size_t match = candidate - 1;
+        size_t length = kLzMinMatch;
+        while (pos + length < size && in[match + length] == in[pos + length]) {
+            ++length;
+        }
+        literals(anchor, pos - anchor, length - kLzMinMatch);
+        const size_t offset = pos - match;
+        *out++ = static_cast<std::uint8_t>(offset);
+        *out++ = static_cast<std::uint8_t>(offset >> 8);
+        if (length - kLzMinMatch >= 15) {
+            LzLength(out, length - kLzMinMatch - 15);
+        }
+        pos += length;
+        anchor = pos;
+    }
+    literals(anchor, size - anchor, 0);
+    return static_cast<size_t>(out - start);
+}
+
+// Bytes written, or 0 when `in` is not a valid stream for `capacity`.
+size_t LzDecompress(const std::uint8_t* in, size_t size, std::uint8_t* out, size_t capacity) {
+    size_t i = 0;
+    size_t o = 0;
+    const auto length = [&](size_t value) {
+        std::uint8_t byte = 255;
+        while (byte == 255 && i < size) {
+            byte = in[i++];
+            value += byte;
+        }
+        return value;
+    };
+    while (i < size) {
+        const std::uint8_t token = in[i++];
+        size_t count = token >> 4;
+        if (count == 15) {
+            count = length(count);
+        }
+        if (count > size - i || count > capacity - o) {
+            return 0;
+        }
+        std::memcpy(out + o, in + i, count);
+        i += count;
+        o += count;
+        if (i == size) {
+            break;
+        }
+        if (size - i < 2) {
+            return 0;
+        }
+        const size_t offset = in[i] | (size_t(in[i + 1]) << 8);
+        i += 2;
+        size_t match = (token & 15) + kLzMinMatch;
+        if ((token & 15) == 15) {
+            match = length(match);
+        }
+        if (offset == 0 || offset > o || match > capacity - o) {
+            return 0;
+        }
+        // Byte by byte: the copy may overlap what it writes.
+        for (const std::uint8_t* from = out + o - offset; match > 0; --match) {
+            out[o++] = *from++;
+        }
+    }
+    return o;
+}
+
+// ---- SHA-256 (FIPS 180-4) -------------------------------------------------
+
+constexpr std::uint32_t kSha256Rounds[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+constexpr std::uint32_t RotateRight(std::uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+void Sha256Block(std::uint32_t state[8], const std::uint8_t* block) {
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = (std::uint32_t(block[4 * i]) << 24) | (std::uint32_t(block[4 * i + 1]) << 16) |
+               (std::uint32_t(block[4 * i + 2]) << 8) | block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; ++i) {
+        const std::uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const std::uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; ++i) {
+        const std::uint32_t t1 = h + (RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25)) +
+                                 ((e & f) ^ (~e & g)) + kSha256Rounds[i] + w[i];
+        const std::uint32_t t2 = (RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22)) +
+                                 ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+std::array<std::uint8_t, 32> Sha256(const std::uint8_t* data, size_t size) {
+    std::uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                              0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    size_t done = 0;
+    for (; size - done >= 64; done += 64) {
+        Sha256Block(state, data + done);
+    }
+    std::uint8_t tail[128] = {};
+    const size_t rest = size - done;
+    std::memcpy(tail, data + done, rest);
+    tail[rest] = 0x80;
+    const size_t tailSize = rest + 9 <= 64 ? 64 : 128;
+    const std::uint64_t bits = static_cast<std::uint64_t>(size) * 8;
+    for (int i = 0; i < 8; ++i) {
+        tail[tailSize - 1 - i] = static_cast<std::uint8_t>(bits >> (8 * i));
+    }
+    for (size_t offset = 0; offset < tailSize; offset += 64) {
+        Sha256Block(state, tail + offset);
+    }
+    std::array<std::uint8_t, 32> digest;
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            digest[4 * i + j] = static_cast<std::uint8_t>(state[i] >> (24 - 8 * j));
+        }
+    }
+    return digest;
+}
+
+// ---- CRC-32C (Castagnoli), slicing by 8 -----------------------------------
+
+constexpr auto kCrcTables = [] {
+    std::array<std::array<std::uint32_t, 256>, 8> tables{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78u : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (size_t slice = 1; slice < tables.size(); ++slice) {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            const std::uint32_t previous = tables[slice - 1][i];
+            tables[slice][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}();
+
+std::uint32_t Crc32c(const std::uint8_t* data, size_t size) {
+    const auto& t = kCrcTables;
+    std::uint32_t crc = ~0u;
+    for (; size >= 8; data += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));  // little-endian
+        word ^= crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^ t[5][(word >> 16) & 0xFF] ^
+              t[4][(word >> 24) & 0xFF] ^ t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+              t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+    }
+    for (; size > 0; ++data, --size) {
+        crc = t[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ---- Inputs and per-thread working sets -----------------------------------
+
+struct TreeNode {
+    std::uint32_t key = 0;
+    std::int32_t left = -1;
+    std::int32_t right = -1;
+};
+
+struct Particle {
+    float x, y, z;
+    float px, py, pz;    // the previous step's position (Verlet)
+    float inverseMass;  // 0 for the pinned corners
+};
+
+struct Spring {
+    std::uint32_t a;
+    std::uint32_t b;
+    float rest;
+};
+
+// Shared by every thread, read-only once built.
+struct WorkloadInputs {
+    std::vector<std::uint8_t> text;        // words, punctuation and line breaks
+    std::vector<std::uint8_t> compressed;  // `text` after LzCompress
+    std::vector<TreeNode> tree;            // unbalanced: the keys inserted in random order
+    std::vector<std::uint32_t> lookups;
+    std::vector<std::uint32_t> keys;  // for the sort
+    std::vector<Particle> cloth;      // at rest, before the first step
+    std::vector<Spring> springs;
+};
+
+struct WordSlot {
+    std::uint64_t hash = 0;
+    std::uint32_t offset = 0;  // of its lowercase copy in WorkloadScratch::words
+    std::uint32_t length = 0;
+    std::uint32_t count = 0;
+};
+
+// One thread's buffers, allocated (and first touched) on that thread.
+struct WorkloadScratch {
+    explicit WorkloadScratch(const WorkloadInputs& inputs)
+        : bytes(LzBound(inputs.text.size())),
+          lzTable(size_t(1) << kLzHashBits),
+          keys(inputs.keys.size()),
+          sortBuffer(inputs.keys.size()),
+          table(kWordTableSize),
+          particles(inputs.cloth.size()) {
+        words.reserve(kVocabulary * 16);
+    }
+
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::uint32_t> lzTable;
+    std::vector<std::uint32_t> keys;
+    std::vector<std::uint32_t> sortBuffer;
+    std::vector<WordSlot> table;
+    std::string words;
+    std::vector<Particle> particles;
+};
+
+std::string MakeWord(SplitMix& random) {
+    // Frequent letters far more often than rare ones, as in real text.
+    static constexpr char kLetters[] = "etaoinshrdlucmfwypvbgkjqxz";
+    std::string word(1 + random.Below(9), ' ');
+    for (char& c : word) {
+        c = kLetters[random.Below(random.Below(26) + 1)];
+    }
+    return word;
+}
+
+// Sentences of words drawn with a steep bias towards the first ones in
+// the vocabulary, so the text repeats the way prose does; it compresses
+// a little under 2:1.
+std::vector<std::uint8_t> MakeText(SplitMix& random) {
+    std::vector<std::string> vocabulary;
+    for (size_t i = 0; i < kVocabulary; ++i) {
+        vocabulary.push_back(MakeWord(random));
+    }
+    std::string text;
+    text.reserve(kTextBytes + 256);
+    while (text.size() < kTextBytes) {
+        const std::uint32_t words = 4 + random.Below(12);
+        for (std::uint32_t i = 0; i < words; ++i) {
+            std::string word =
+                vocabulary[random.Below(random.Below(static_cast<std::uint32_t>(kVocabulary)) + 1)];
+            if (i == 0) {
+                word[0] = static_cast<char>(word[0] - 'a' + 'A');
+            }
+            text += word;
+            if (i + 1 < words) {
+                text += random.Below(8) == 0 ? ", " : " ";
+            }
+        }
+        text += random.Below(6) == 0 ? ".\n" : ". ";
+    }
+    text.resize(kTextBytes);
+    return {text.begin(), text.end()};
+}
+
+WorkloadInputs MakeInputs() {
+    SplitMix random(0x5EED);
+    WorkloadInputs inputs;
+    inputs.text = MakeText(random);
+    inputs.compressed.resize(LzBound(inputs.text.size()));
+    std::vector<std::uint32_t> table(size_t(1) << kLzHashBits);
+    inputs.compressed.resize(
+        LzCompress(inputs.text.data(), inputs.text.size(), inputs.compressed.data(), table.data()));
+
+    while (inputs.tree.size() < kTreeNodes) {
+        const auto key = static_cast<std::uint32_t>(random.Next() >> 32);
+        std::int32_t* link = nullptr;
+        if (!inputs.tree.empty()) {
+            std::int32_t node = 0;
+            while (node >= 0 && inputs.tree[node].key != key) {
+                link = key < inputs.tree[node].key ? &inputs.tree[node].left : &inputs.tree[node].right;
+                node = *link;
+            }
+            if (node >= 0) {
+                continue;  // already in the tree
+            }
+        }
+        if (link) {
+            *link = static_cast<std::int32_t>(inputs.tree.size());
+        }
+        inputs.tree.push_back({key, -1, -1});
+    }
+    for (size_t i = 0; i < kTreeLookups; ++i) {
+        inputs.lookups.push_back(i % 2 == 0 ? inputs.tree[random.Below(kTreeNodes)].key
+                                            : static_cast<std::uint32_t>(random.Next() >> 32));
+    }
+
+    for (size_t i = 0; i < kSortKeys; ++i) {
+        inputs.keys.push_back(static_cast<std::uint32_t>(random.Next()));
+    }
+
+    // A square sheet held at two corners, above a sphere it falls onto.
+    const float spacing = 1.0f / static_cast<float>(kClothSide - 1);
+    for (size_t row = 0; row < kClothSide; ++row) {
+        for (size_t column = 0; column < kClothSide; ++column) {
+            const float x = static_cast<float>(column) * spacing;
+            const float z = static_cast<float>(row) * spacing;
+            const bool pinned = row == 0 && (column == 0 || column == kClothSide - 1);
+            inputs.cloth.push_back({x, 1.0f, z, x, 1.0f, z, pinned ? 0.0f : 1.0f});
+        }
+    }
+    const auto link = [&](size_t row, size_t column, size_t toRow, size_t toColumn) {
+        if (toRow < kClothSide && toColumn < kClothSide) {
+            const auto a = static_cast<std::uint32_t>(row * kClothSide + column);
+            const auto b = static_cast<std::uint32_t>(toRow * kClothSide + toColumn);
+            const float dx = inputs.cloth[b].x - inputs.cloth[a].x;
+            const float dz = inputs.cloth[b].z - inputs.cloth[a].z;
+            inputs.springs.push_back({a, b, std::sqrt(dx * dx + dz * dz)});
+        }
+    };
+    for (size_t row = 0; row < kClothSide; ++row) {
+        for (size_t column = 0; column < kClothSide; ++column) {
+            link(row, column, row, column + 1);
+            link(row, column, row + 1, column);
+            link(row, column, row + 1, column + 1);
+            link(row, column + 1, row + 1, column);
+        }
+    }
+    return inputs;
+}
+
+// ---- The kernels: one pass each, returning its checksum -------------------
+
+std::uint64_t LzCompressPass(const WorkloadInputs& in, WorkloadScratch& scratch) {
+    const size_t size = LzCompress(in.text.data(), in.text.size(), scratch.bytes.data(), scratch.lzTable.data());
+    return Fold(scratch.bytes.data(), size);
+}
+
+std::uint64_t LzDecompressPass(const WorkloadInputs& in, WorkloadScratch& scratch) {
+    const size_t size =
+        LzDecompress(in.compressed.data(), in.compressed.size(), scratch.bytes.data(), scratch.bytes.size());
+    return Fold(scratch.bytes.data(), size);
+}
+
+std::uint64_t Sha256Pass(const WorkloadInputs& in, WorkloadScratch&) {
+    const std::array<std::uint8_t, 32> digest = Sha256(in.text.data(), in.text.size());
+    std::uint64_t head = 0;
+    for (int i = 0; i < 8; ++i) {
+        head = (head << 8) | digest[i];
+    }
+    return head;
+}
+
+std::uint64_t Crc32cPass(const WorkloadInputs& in, WorkloadScratch&) {
+    return Crc32c(in.text.data(), in.text.size());
+}
+
+std::uint64_t TreeSearchPass(const WorkloadInputs& in, WorkloadScratch&) {
+    std::uint64_t found = 0;
+    std::uint64_t depth = 0;
+    for (const std::uint32_t key : in.lookups) {
+        std::int32_t node = 0;
+        while (node >= 0) {
+            const TreeNode& current = in.tree[node];
+            if (current.key == key) {
+                ++found;
+                break;
+            }
+            node = key < current.key ? current.left : current.right;
+            ++depth;
+        }
+    }
+    return (found << 40) ^ depth;
+}
+
+// LSD radix sort, a byte per pass, of a fresh copy of the keys.
+std::uint64_t RadixSortPass(const WorkloadInputs& in, WorkloadScratch& scratch) {
+    std::uint32_t* keys = scratch.keys.data();
+    std::uint32_t* buffer = scratch.sortBuffer.data();
+    const size_t count = in.keys.size();
+    std::copy(in.keys.begin(), in.keys.end(), keys);
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t offsets[256] = {};
+        for (size_t i = 0; i < count; ++i) {
+            ++offsets[(keys[i] >> shift) & 0xFF];
+        }
+        size_t total = 0;
+        for (size_t& offset : offsets) {
+            const size_t bucket = offset;
+            offset = total;
+            total += bucket;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            buffer[offsets[(keys[i] >> shift) & 0xFF]++] = keys[i];
+        }
+        std::swap(keys, buffer);
+    }
+    // Position-weighted, so keys out of order change it.
+    std::uint64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += keys[i] * static_cast<std::uint64_t>(i + 1);
+    }
+    return sum;
+}
+
+// Splits the text into words, lowercases them and counts each one in an
+// open-addressing hash table, as a compiler's lexer and symbol table do.
+std::uint64_t StringsPass(const WorkloadInputs& in, WorkloadScratch& scratch) {
+    std::fill(scratch.table.begin(), scratch.table.end(), WordSlot{});
+    scratch.words.clear();
+    const std::uint8_t* text = in.text.data();
+    const size_t size = in.text.size();
+    char word[64];
+    std::uint64_t total = 0;
+    std::uint64_t distinct = 0;
+    std::uint64_t sentences = 0;
+    for (size_t i = 0; i < size;) {
+        const std::uint8_t c = text[i];
+        const bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        if (!letter) {
+            sentences += c == '.';
+            ++i;
+            continue;
+        }
+        std::uint32_t length = 0;
+        std::uint64_t hash = 14695981039346656037ull;
+        for (; i < size && length < sizeof(word); ++i, ++length) {
+            std::uint8_t next = text[i];
+            if (next >= 'A' && next <= 'Z') {
+                next = static_cast<std::uint8_t>(next - 'A' + 'a');
+            } else if (next < 'a' || next > 'z') {
+                break;
+            }
+            word[length] = static_cast<char>(next);
+            hash = (hash ^ next) * 1099511628211ull;
+        }
+        ++total;
+        for (size_t slot = hash & (kWordTableSize - 1);; slot = (slot + 1) & (kWordTableSize - 1)) {
+            WordSlot& entry = scratch.table[slot];
+            if (entry.count == 0) {
+                entry = {hash, static_cast<std::uint32_t>(scratch.words.size()), length, 1};
+                scratch.words.append(word, length);
+                ++distinct;
+                break;
+            }
+            if (entry.hash == hash && entry.length == length &&
+                std::memcmp(scratch.words.data() + entry.offset, word, length) == 0) {
+                ++entry.count;
+                break;
+            }
+        }
+    }
+    // Independent of the slots' order.
+    std::uint64_t counts = 0;
+    for (const WordSlot& entry : scratch.table) {
+        counts += entry.hash * entry.count;
+    }
+    return counts ^ (total << 48) ^ (distinct << 32) ^ sentences;
+}
+
+// Position-based Verlet cloth: gravity, springs relaxed a few times per
+// step, collision with a sphere. Only +, -, *, / and sqrt, compiled
+// without floating-point contraction, so every IEEE machine lands on the
+// same bits.
+std::uint64_t PhysicsPass(const WorkloadInputs& in, WorkloadScratch& scratch) {
+    constexpr float kDamping = 0.99f;
+    constexpr float kGravityStep = -9.81f / (60.0f * 60.0f);  // acceleration times the step squared
+    constexpr float kSphereX = 0.5f, kSphereY = 0.45f, kSphereZ = 0.6f, kSphereRadius = 0.3f;
+    std::vector<Particle>& particles = scratch.particles;
+    std::copy(in.cloth.begin(), in.cloth.end(), particles.begin());
+    for (int step = 0; step < kClothSteps; ++step) {
+        for (Particle& p : particles) {
+            if (p.inverseMass == 0.0f) {
+                continue;
+            }
+            const float vx = (p.x - p.px) * kDamping;
+            const float vy = (p.y - p.py) * kDamping;
+            const float vz = (p.z - p.pz) * kDamping;
+            p.px = p.x;
+            p.py = p.y;
+            p.pz = p.z;
+            p.x += vx;
+            p.y += vy + kGravityStep;
+            p.z += vz;
+        }
+        for (int iteration = 0; iteration < kClothIterations; ++iteration) {
+            for (const Spring& spring : in.springs) {
+                Particle& a = particles[spring.a];
+                Particle& b = particles[spring.b];
+                const float dx = b.x - a.x;
+                const float dy = b.y - a.y;
+                const float dz = b.z - a.z;
+                const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+                const float weight = a.inverseMass + b.inverseMass;
+                if (distance <= 0.0f || weight == 0.0f) {
+                    continue;
+                }
+                const float correction = (distance - spring.rest) / (distance * weight);
+                a.x += dx * correction * a.inverseMass;
+                a.y += dy * correction * a.inverseMass;
+                a.z += dz * correction * a.inverseMass;
+                b.x -= dx * correction * b.inverseMass;
+                b.y -= dy * correction * b.inverseMass;
+                b.z -= dz * correction * b.inverseMass;
+            }
+        }
+        for (Particle& p : particles) {
+            const float dx = p.x - kSphereX;
+            const float dy = p.y - kSphereY;
+            const float dz = p.z - kSphereZ;
+            const float squared = dx * dx + dy * dy + dz * dz;
+            if (squared < kSphereRadius * kSphereRadius && squared > 0.0f) {
+                const float scale = kSphereRadius / std::sqrt(squared);
+                p.x = kSphereX + dx * scale;
+                p.y = kSphereY + dy * scale;
+                p.z = kSphereZ + dz * scale;
+            }
+        }
+    }
+    return Fold(particles.data(), particles.size() * sizeof(Particle));
+}
+
+struct Workload {
+    const char* name;
+    const char* unit;  // of its rate, G units per second
+    double weight;     // in the composite; they sum to 1
+    double reference;  // rate on one thread of the reference machine, scoring kReferencePoints
+    std::uint64_t checksum;  // every pass must return it; physics only without contraction (CMakeLists.txt)
+    std::uint64_t (*pass)(const WorkloadInputs&, WorkloadScratch&);
+    std::uint64_t (*units)(const WorkloadInputs&);  // per pass
+};
+
+std::uint64_t TextUnits(const WorkloadInputs& in) {
+    return in.text.size();
+}
+
+// Weighted towards the branchy, integer-heavy work of builds and game
+// logic; compression and hashing next, floating point last.
+constexpr Workload kWorkloads[] = {
+    {"lz-compress", "GB/s", 0.15, 0.20, 0x6f1f5941ec38153eull, LzCompressPass, TextUnits},
+    {"lz-decompress", "GB/s", 0.10, 0.28, 0x19b4ada0a2b491ebull, LzDecompressPass, TextUnits},
+    {"sha256", "GB/s", 0.10, 0.21, 0x2feb55887d3c1c10ull, Sha256Pass, TextUnits},
+    {"crc32c", "GB/s", 0.05, 1.4, 0x00000000f4136b6eull, Crc32cPass, TextUnits},
+    {"tree-search", "G lookups/s", 0.20, 0.0087, 0x0020000000045b2cull, TreeSearchPass,
+     [](const WorkloadInputs& in) -> std::uint64_t { return in.lookups.size(); }},
+    {"radix-sort", "G keys/s", 0.15, 0.098, 0x55785bbdcf7beb61ull, RadixSortPass,
+     [](const WorkloadInputs& in) -> std::uint64_t { return in.keys.size(); }},
+    {"strings", "GB/s", 0.15, 0.23, 0x30046c92477bc343ull, StringsPass, TextUnits},
+    {"physics", "G particle updates/s", 0.10, 0.0050, 0x1fe488d94973a82aull, PhysicsPass,
+     [](const WorkloadInputs& in) -> std::uint64_t { return in.cloth.size() * kClothSteps; }},
+};
+static_assert(std::size(kWorkloads) == std::size(kWorkloadKernels));
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Passes per call for a call to take about kCallSeconds on one thread:
+// doubled until `passes` take a quarter of that, then scaled. False when
+// a pass returns the wrong checksum.
+bool CalibratePasses(const Workload& workload, const WorkloadInputs& inputs, std::uint64_t& passes) {
+    WorkloadScratch scratch(inputs);
+    passes = 1;
+    while (true) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t i = 0; i < passes; ++i) {
+            if (workload.pass(inputs, scratch) != workload.checksum) {
+                return false;
+            }
+        }
+        const double seconds = SecondsSince(start);
+        if (seconds >= kCallSeconds / 4.0 || passes >= (1u << 20)) {
+            passes = std::max<std::uint64_t>(
+                1, static_cast<std::uint64_t>(static_cast<double>(passes) * kCallSeconds / std::max(seconds, 1e-9)));
+            return true;
+        }
+        passes *= 2;
+    }
+}
+
+// Rates (G units/s, all threads together) of each timed call, `passes`
+// passes per thread per call. The threads allocate their working sets
+// first and run every call together, released by a barrier; a call is
+// timed from the release to the last thread finishing. Empty when a
+// pass returned the wrong checksum.
+std::vector<double> MeasureWorkload(const Workload& workload, const WorkloadInputs& inputs, unsigned threads,
+                                    std::uint64_t passes, const RepeatOptions& repeats) {
+    const int calls = repeats.warmup + repeats.repetitions;
+    std::barrier sync(static_cast<std::ptrdiff_t>(threads) + 1);
+    std::atomic<bool> valid = true;
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            WorkloadScratch scratch(inputs);
+            for (int call = 0; call < calls; ++call) {
+                sync.arrive_and_wait();
+                bool ok = true;
+                for (std::uint64_t i = 0; i < passes; ++i) {
+                    ok = workload.pass(inputs, scratch) == workload.checksum && ok;
+                }
+                if (!ok) {
+                    valid = false;
+                }
+                sync.arrive_and_wait();
+            }
+        });
+    }
+    const double units = static_cast<double>(workload.units(inputs) * passes * threads);
+    std::vector<double> rates = Repeat(
+        [&] {
+            sync.arrive_and_wait();
+            const auto start = std::chrono::steady_clock::now();
+            sync.arrive_and_wait();
+            return units / std::max(SecondsSince(start), 1e-9) / 1e9;
+        },
+        repeats);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return valid ? rates : std::vector<double>();
+}
+
+std::string Format(const char* format, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), format, value);
+    return buffer;
+}
+
+}  // namespace
+
+std::optional<BenchmarkResultData> WorkloadBenchmark::Run(const HardwareSnapshot& snapshot, int repetitions,
+                                                          BenchmarkControl* control) const {
+    BenchmarkControl detached;
+    const BenchmarkControl& active = control ? *control : detached;
+    unsigned threads = snapshot.cpu.logicalCores;
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (!active.Advance(0.0, "Workload inputs")) {
+        return std::nullopt;
+    }
+    const WorkloadInputs inputs = MakeInputs();
+    const RepeatOptions repeats{1, std::max(1, repetitions)};
+
+    std::vector<std::vector<double>> rates;
+    for (size_t k = 0; k < std::size(kWorkloads); ++k) {
+        const Workload& workload = kWorkloads[k];
+        if (!active.Advance(static_cast<double>(k) / std::size(kWorkloads),
+                            std::string("Workload ") + workload.name)) {
+            return std::nullopt;
+        }
+        std::uint64_t passes = 0;
+        if (!CalibratePasses(workload, inputs, passes)) {
+            return std::nullopt;
+        }
+        rates.push_back(MeasureWorkload(workload, inputs, threads, passes, repeats));
+        if (rates.back().empty()) {
+            return std::nullopt;
+        }
+    }
+
+    // Sample r combines every workload's r-th timed call.
+    std::vector<double> composite(repeats.repetitions, 0.0);
+    for (size_t k = 0; k < rates.size(); ++k) {
+        for (size_t r = 0; r < composite.size(); ++r) {
+            composite[r] += kWorkloads[k].weight * std::log(rates[k][r] / kWorkloads[k].reference);
+        }
+    }
+    for (double& sample : composite) {
+        sample = kReferencePoints * std::exp(sample);
+    }
+
+    BenchmarkResultData result;
+    std::string table;
+    for (size_t k = 0; k < rates.size(); ++k) {
+        const Workload& workload = kWorkloads[k];
+        const double rate = SummarizeSamples(rates[k]).median;
+        result.kernels.push_back({workload.name, "", rate});
+        table += std::string("\n") + workload.name + ": " + Format("%.4g", rate) + " " + workload.unit + ", " +
+                 Format("%.0f", kReferencePoints * rate / workload.reference) + " points";
+    }
+    result.stats = SummarizeSamples(composite);
+    result.score = result.stats.median;
+    result.samples = std::move(composite);
+    result.unit = "points";
+    result.details = "Threads: " + std::to_string(threads) + ", " + std::to_string(std::size(kWorkloads)) +
+                     " workloads, weighted geometric mean (" + Format("%.0f", kReferencePoints) +
+                     " = one thread of the reference machine)\nPoints: " + FormatStats(result.stats) +
+                     "\nPer workload, all threads (median of " + std::to_string(repeats.repetitions) + "):" + table;
+    return result;
+}
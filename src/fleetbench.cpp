@@ -0,0 +1,147 @@
+// fleetbench: times ProfileEngine::MatchFleet on synthetic inventory
+// snapshots and checks a sample against per-snapshot Refresh, and the
+// catalog's token automata against ProfileEngine::MatchesTokens.
+//
+//   fleetbench <profiles.json> [snapshots] [threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ProfileCatalog.hpp"
+#include "ProfileEngine.hpp"
+#include "ProfileLoader.hpp"
+
+namespace {
+
+// Brand strings built around a random catalog token, so most snapshots
+// match something; every eighth one is unknown hardware. Some carry IDs,
+// and some have several GPU adapters.
+std::vector<HardwareSnapshot> MakeFleet(const ProfileCatalog& catalog, size_t count) {
+    std::mt19937 rng(12345);
+    const auto cpuProfiles = catalog.CpuProfiles();
+    const auto gpuProfiles = catalog.GpuProfiles();
+    auto pickToken = [&](const auto& profiles) -> std::string {
+        if (profiles.empty()) {
+            return "unknown";
+        }
+        const auto tokens = profiles[rng() % profiles.size()].MatchTokens();
+        return tokens.empty() ? std::string("unknown") : std::string(tokens[rng() % tokens.size()]);
+    };
+
+    std::vector<HardwareSnapshot> fleet(count);
+    for (auto& snapshot : fleet) {
+        const bool unknown = rng() % 8 == 0;
+        snapshot.cpu.name = "CPU " + (unknown ? std::string("Model 9000") : pickToken(cpuProfiles)) + " @ 3.60GHz";
+        snapshot.cpu.vendor = rng() % 2 ? "GenuineIntel" : "AuthenticAMD";
+        if (rng() % 4 == 0) {
+            snapshot.cpu.family = 6;
+            snapshot.cpu.model = rng() % 256;
+            snapshot.cpu.stepping = rng() % 16;
+        }
+        // Mostly one adapter, sometimes none, sometimes a multi-GPU node.
+        const unsigned roll = rng() % 20;
+        const unsigned adapters = roll < 2 ? 0 : roll < 18 ? 1 : 2 + rng() % 3;
+        for (unsigned a = 0; a < adapters; ++a) {
+            GpuInfo gpu;
+            const std::string name = "GPU " + (unknown ? std::string("Model 9000") : pickToken(gpuProfiles));
+            gpu.name.assign(name.begin(), name.end());
+            gpu.adapterIndex = a;
+            gpu.vendorId = rng() % 4 == 0 ? 0x10DE : 0;
+            gpu.deviceId = rng() % 0x3000;
+            snapshot.gpus.push_back(std::move(gpu));
+        }
+    }
+    return fleet;
+}
+
+bool SameOptions(const FleetOptions& fleet, size_t index, const ProfileEngine& engine) {
+    const auto cpu = fleet.CpuOptions(index);
+    if (!std::equal(cpu.begin(), cpu.end(), engine.CpuOptions().begin(), engine.CpuOptions().end()) ||
+        fleet.GpuAdapterCount(index) != engine.GpuAdapterCount()) {
+        return false;
+    }
+    for (size_t adapter = 0; adapter < engine.GpuAdapterCount(); ++adapter) {
+        const auto gpu = fleet.GpuOptions(index, adapter);
+        const auto expected = engine.GpuOptions(adapter);
+        if (!std::equal(gpu.begin(), gpu.end(), expected.begin(), expected.end())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Names whose automaton matches differ from the token-by-token scan over
+// every profile's matchTokens.
+template <typename Profiles>
+size_t CountTokenMismatches(const std::string& name, const TokenMatcher& matcher, const Profiles& profiles) {
+    std::vector<std::uint32_t> expected;
+    for (const auto profile : profiles) {
+        if (ProfileEngine::MatchesTokens(name, profile.MatchTokens())) {
+            expected.push_back(profile.Index());
+        }
+    }
+    return matcher.Match(name) == expected ? 0 : 1;
+}
+
+size_t CountTokenMismatches(const HardwareSnapshot& snapshot, const ProfileCatalog& catalog) {
+    const HardwareMatchKeys keys(snapshot);
+    size_t mismatches = CountTokenMismatches(keys.cpu, catalog.CpuMatcher(), catalog.CpuProfiles());
+    for (const GpuMatchKeys& gpu : keys.gpus) {
+        mismatches += CountTokenMismatches(gpu.name, catalog.GpuMatcher(), catalog.GpuProfiles());
+    }
+    return mismatches;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 4) {
+        std::fprintf(stderr, "usage: fleetbench <profiles.json> [snapshots] [threads]\n");
+        return 2;
+    }
+    const size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+    const unsigned threads = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+    try {
+        ProfileLoader loader;
+        const ProfileCatalog catalog = loader.LoadCatalog(argv[1]);
+        const auto fleet = MakeFleet(catalog, count);
+
+        using Clock = std::chrono::steady_clock;
+        FleetOptions options;
+        double bestMs = 0.0;
+        for (int run = 0; run < 5; ++run) {
+            const auto start = Clock::now();
+            options = ProfileEngine::MatchFleet(fleet, catalog, threads);
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            bestMs = run == 0 ? ms : std::min(bestMs, ms);
+        }
+
+        size_t mismatches = 0;
+        size_t tokenMismatches = 0;
+        size_t matched = 0;
+        ProfileEngine engine;
+        for (size_t i = 0; i < fleet.size(); i += 97) {
+            engine.Refresh(fleet[i], catalog);
+            mismatches += SameOptions(options, i, engine) ? 0 : 1;
+            tokenMismatches += CountTokenMismatches(fleet[i], catalog);
+        }
+        for (size_t i = 0; i < options.size(); ++i) {
+            matched += options.CpuOptions(i).empty() ? 0 : 1;
+        }
+        std::printf("fleetbench: %zu snapshots in %.1f ms (best of 5, %.2f M/s), %zu with CPU options, "
+                    "%zu sampled mismatches, %zu token automaton mismatches\n",
+                    count, bestMs, bestMs > 0.0 ? count / bestMs / 1000.0 : 0.0, matched, mismatches,
+                    tokenMismatches);
+        return mismatches == 0 && tokenMismatches == 0 ? 0 : 1;
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "fleetbench: %s\n", ex.what());
+        return 1;
+    }
+}
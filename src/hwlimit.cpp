@@ -0,0 +1,968 @@
+// hwlimit: the app's hardware, profile, throttling and benchmark logic
+// without the GUI, for scripts. Every command prints one JSON document on
+// stdout; diagnostics go to stderr.
+//
+//   hwlimit detect
+//   hwlimit list    [--profiles <path>]
+//   hwlimit apply   [--profiles <path>] [--cpu <target-id>] [--gpu <target-id>]... [--yes]
+//   hwlimit restore
+//   hwlimit bench   [--memory] [--huge-pages] [--workloads] [--sustained <seconds>] [--scaling] [--per-core]
+//                   [--runs <n>] [--progress]
+//                   [--cpu-target <id>] [--gpu-target <id>] [--baseline] [--history <path> | --no-history]
+//   hwlimit history [--target <id>] [--kernel <name>] [--history <path>]
+//
+// Exit status: 0 on success, 1 when something failed (JSON still printed
+// where there is a result to report), 2 on a usage error and 130 when a
+// benchmark was interrupted (the parts that finished are printed).
+
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+#include "BenchmarkHistory.hpp"
+#include "BenchmarkRunner.hpp"
+#include "CpuKernels.hpp"
+#include "CpuTopology.hpp"
+#include "HardwareInfo.hpp"
+#include "PowerThrottler.hpp"
+#include "ProfileCatalog.hpp"
+#include "ProfileEngine.hpp"
+#include "ProfileLoader.hpp"
+
+namespace {
+
+constexpr int kExitFailure = 1;
+constexpr int kExitUsage = 2;
+constexpr int kExitInterrupted = 130;
+
+constexpr const char* kUsage =
+    "usage: hwlimit <command> [options]\n"
+    "  detect                     probed CPU, caches and GPU adapters\n"
+    "  list                       targets offered for this machine, estimated ones included\n"
+    "  apply --cpu <id> --gpu <id>...\n"
+    "                             apply targets by id (a GPU id on every adapter offering it);\n"
+    "                             --yes confirms high-impact targets\n"
+    "  restore                    default CPU and GPU limits\n"
+    "  bench                      CPU and GPU benchmark; --memory adds the memory suite,\n"
+    "                             --huge-pages backs it with huge pages, --workloads adds the\n"
+    "                             workload suite (compression, hashing, search, sort, text,\n"
+    "                             physics), --sustained <seconds> keeps the CPU loaded that long\n"
+    "                             and scores the steady state, --scaling runs the CPU kernels on\n"
+    "                             1, 2, 4... threads (checked against --cpu-target's core and\n"
+    "                             thread limits), --per-core scores each core,\n"
+    "                             --runs <n> sets the timed repetitions, --progress reports\n"
+    "                             progress on stderr;\n"
+    "                             runs are added to the history under --cpu-target and\n"
+    "                             --gpu-target (the ids applied, none when unthrottled) and\n"
+    "                             checked against the last ones stored there; --baseline takes\n"
+    "                             parts stored in the last 7 days instead of measuring them\n"
+    "  history                    stored runs on this machine under --target <id> (none:\n"
+    "                             unthrottled), --kernel cpu|gpu|memory|workloads|sustained|\n"
+    "                             scaling limiting them to one part\n"
+    "  --history <path>           history file instead of the per-user one; --no-history\n"
+    "                             leaves bench runs out of it\n"
+    "  --profiles <path>          profiles.json to use (its compiled profiles.bin alongside, if\n"
+    "                             current) instead of the bundle next to hwlimit\n";
+
+// Streams compact JSON into a string; the caller keeps the nesting right,
+// the writer places the commas.
+class JsonWriter {
+public:
+    JsonWriter& BeginObject() { return Open('{'); }
+    JsonWriter& EndObject() { return Close('}'); }
+    JsonWriter& BeginArray() { return Open('['); }
+    JsonWriter& EndArray() { return Close(']'); }
+
+    JsonWriter& Key(std::string_view key) {
+        Separate();
+        Quote(key);
+        text_ += ':';
+        afterKey_ = true;
+        return *this;
+    }
+
+    JsonWriter& String(std::string_view value) {
+        Separate();
+        Quote(value);
+        return *this;
+    }
+
+    JsonWriter& Number(double value) {
+        Separate();
+        if (!std::isfinite(value)) {
+            text_ += "null";
+            return *this;
+        }
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+        text_ += buffer;
+        return *this;
+    }
+
+    JsonWriter& Integer(long long value) {
+        Separate();
+        text_ += std::to_string(value);
+        return *this;
+    }
+
+    JsonWriter& Bool(bool value) {
+        Separate();
+        text_ += value ? "true" : "false";
+        return *this;
+    }
+
+    JsonWriter& Null() {
+        Separate();
+        text_ += "null";
+        return *this;
+    }
+
+    const std::string& Text() const { return text_; }
+
+private:
+    JsonWriter& Open(char bracket) {
+        Separate();
+        text_ += bracket;
+        first_.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& Close(char bracket) {
+        text_ += bracket;
+        first_.pop_back();
+        return *this;
+    }
+
+    void Separate() {
+        if (afterKey_) {
+            afterKey_ = false;
+        } else if (!first_.empty()) {
+            if (!first_.back()) {
+                text_ += ',';
+            }
+            first_.back() = false;
+        }
+    }
+
+    void Quote(std::string_view value) {
+        text_ += '"';
+        for (const char c : value) {
+            switch (c) {
+            case '"': text_ += "\\\""; break;
+            case '\\': text_ += "\\\\"; break;
+            case '\n': text_ += "\\n"; break;
+            case '\r': text_ += "\\r"; break;
+            case '\t': text_ += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[8];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+                    text_ += escape;
+                } else {
+                    text_ += c;
+                }
+            }
+        }
+        text_ += '"';
+    }
+
+    std::string text_;
+    std::vector<bool> first_;  // per open container: nothing written into it yet
+    bool afterKey_ = false;
+};
+
+void Print(const JsonWriter& json) {
+    std::fwrite(json.Text().data(), 1, json.Text().size(), stdout);
+    std::fputc('\n', stdout);
+}
+
+// GPU names and throttler messages are wide: UTF-16 on Windows, widened
+// bytes elsewhere.
+std::string ToUtf8(std::wstring_view text) {
+#ifdef _WIN32
+    if (text.empty()) {
+        return {};
+    }
+    const int size = WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0,
+                                         nullptr, nullptr);
+    std::string result(static_cast<size_t>(size), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), result.data(), size, nullptr,
+                        nullptr);
+    return result;
+#else
+    return std::string(text.begin(), text.end());
+#endif
+}
+
+std::filesystem::path ExecutableDirectory() {
+#ifdef _WIN32
+    std::wstring buffer(MAX_PATH, L'\0');
+    DWORD length = 0;
+    while ((length = GetModuleFileNameW(nullptr, buffer.data(), static_cast<DWORD>(buffer.size()))) ==
+           buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+    }
+    buffer.resize(length);
+    return std::filesystem::path(buffer).parent_path();
+#elif defined(__APPLE__)
+    uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+    std::string buffer(size, '\0');
+    if (_NSGetExecutablePath(buffer.data(), &size) != 0) {
+        return {};
+    }
+    return std::filesystem::path(buffer.c_str()).parent_path();
+#else
+    std::error_code error;
+    return std::filesystem::read_symlink("/proc/self/exe", error).parent_path();
+#endif
+}
+
+// Like the GUI: the bundle next to the executable, else the source tree's.
+std::filesystem::path DefaultProfilesPath() {
+    std::filesystem::path path = ExecutableDirectory() / "profiles.json";
+    std::filesystem::path compiled = path;
+    compiled.replace_extension(".bin");
+    if (std::filesystem::exists(path) || std::filesystem::exists(compiled)) {
+        return path;
+    }
+    return std::filesystem::current_path() / "resources" / "profiles.json";
+}
+
+struct Options {
+    std::string command;
+    std::filesystem::path profiles;
+    std::optional<std::string> cpuTarget;
+    std::vector<std::string> gpuTargets;
+    bool yes = false;
+    BenchmarkOptions bench;
+    bool progress = false;
+    std::string benchCpuTarget;  // labels of the bench run in the history
+    std::string benchGpuTarget;
+    bool baseline = false;
+    std::filesystem::path history;  // empty with --no-history
+    bool useHistory = true;
+    std::string historyTarget;
+    std::string historyKernel;
+};
+
+// nullopt (after printing why) on a usage error.
+std::optional<Options> ParseArguments(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fputs(kUsage, stderr);
+        return std::nullopt;
+    }
+    Options options;
+    options.command = argv[1];
+    const bool known = options.command == "detect" || options.command == "list" || options.command == "apply" ||
+                       options.command == "restore" || options.command == "bench" || options.command == "history";
+    if (!known) {
+        std::fprintf(stderr, "hwlimit: unknown command '%s'\n%s", argv[1], kUsage);
+        return std::nullopt;
+    }
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "hwlimit: %s needs a value\n", argv[i]);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        const char* text = nullptr;
+        if (arg == "--profiles") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.profiles = text;
+        } else if (arg == "--cpu" && options.command == "apply") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.cpuTarget = text;
+        } else if (arg == "--gpu" && options.command == "apply") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.gpuTargets.push_back(text);
+        } else if (arg == "--yes" && options.command == "apply") {
+            options.yes = true;
+        } else if (arg == "--memory" && options.command == "bench") {
+            options.bench.memory = true;
+        } else if (arg == "--huge-pages" && options.command == "bench") {
+            options.bench.memoryOptions.hugePages = true;
+        } else if (arg == "--workloads" && options.command == "bench") {
+            options.bench.workloads = true;
+        } else if (arg == "--sustained" && options.command == "bench") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.bench.sustainedSeconds = std::atoi(text);
+            if (options.bench.sustainedSeconds < 1) {
+                std::fprintf(stderr, "hwlimit: --sustained needs a positive number of seconds\n");
+                return std::nullopt;
+            }
+        } else if (arg == "--scaling" && options.command == "bench") {
+            options.bench.scaling = true;
+        } else if (arg == "--per-core" && options.command == "bench") {
+            options.bench.cpuMode = CpuBenchmarkMode::PerCore;
+        } else if (arg == "--runs" && options.command == "bench") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.bench.repetitions = std::atoi(text);
+            if (options.bench.repetitions < 1) {
+                std::fprintf(stderr, "hwlimit: --runs needs a positive count\n");
+                return std::nullopt;
+            }
+        } else if (arg == "--progress" && options.command == "bench") {
+            options.progress = true;
+        } else if (arg == "--cpu-target" && options.command == "bench") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.benchCpuTarget = text;
+        } else if (arg == "--gpu-target" && options.command == "bench") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.benchGpuTarget = text;
+        } else if (arg == "--baseline" && options.command == "bench") {
+            options.baseline = true;
+        } else if (arg == "--no-history" && options.command == "bench") {
+            options.useHistory = false;
+        } else if (arg == "--history" && (options.command == "bench" || options.command == "history")) {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.history = text;
+        } else if (arg == "--target" && options.command == "history") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.historyTarget = text;
+        } else if (arg == "--kernel" && options.command == "history") {
+            if (!(text = value())) {
+                return std::nullopt;
+            }
+            options.historyKernel = text;
+        } else {
+            std::fprintf(stderr, "hwlimit: unexpected argument '%s' for %s\n%s", argv[i], options.command.c_str(),
+                         kUsage);
+            return std::nullopt;
+        }
+    }
+    if (options.command == "apply" && !options.cpuTarget && options.gpuTargets.empty()) {
+        std::fprintf(stderr, "hwlimit: apply needs --cpu or --gpu\n");
+        return std::nullopt;
+    }
+    if (options.baseline && !options.useHistory) {
+        std::fprintf(stderr, "hwlimit: --baseline needs the history\n");
+        return std::nullopt;
+    }
+    if (options.profiles.empty()) {
+        options.profiles = DefaultProfilesPath();
+    }
+    if (!options.useHistory) {
+        options.history.clear();
+    } else if (options.history.empty()) {
+        options.history = BenchmarkHistory::DefaultPath();
+    }
+    return options;
+}
+
+// The machine matched against the whole catalog, so candidates can be
+// ranked and synthesized.
+struct Session {
+    HardwareSnapshot snapshot;
+    ProfileCatalog catalog;
+    ProfileEngine engine;
+};
+
+Session OpenSession(const Options& options) {
+    Session session;
+    session.snapshot = HardwareInfoService().QueryHardware();
+    session.catalog = ProfileLoader().LoadCatalog(options.profiles);
+    session.engine.Refresh(session.snapshot, session.catalog);
+    return session;
+}
+
+struct CpuEntry {
+    CpuThrottleTarget target;
+    bool estimated = false;
+};
+
+struct GpuEntry {
+    GpuThrottleTarget target;
+    bool estimated = false;
+};
+
+// Listed tiers first, then the synthesized candidates, as the GUI lists
+// them. `id` stops at the first target with that id, so an apply of a
+// listed tier never ranks the candidates.
+std::vector<CpuEntry> CpuEntries(const Session& session, std::string_view id = {}) {
+    std::vector<CpuEntry> entries;
+    for (const auto option : session.engine.CpuOptions()) {
+        entries.push_back({session.catalog.CpuTarget(option).Materialize(), false});
+        if (!id.empty() && entries.back().target.id == id) {
+            return entries;
+        }
+    }
+    for (const std::uint32_t candidate : session.engine.CpuCandidates(session.catalog)) {
+        if (auto target = session.engine.SynthesizeCpuTarget(candidate, session.catalog)) {
+            entries.push_back({std::move(*target), true});
+        }
+    }
+    return entries;
+}
+
+std::vector<GpuEntry> GpuEntries(const Session& session, size_t adapter, std::string_view id = {}) {
+    std::vector<GpuEntry> entries;
+    for (const auto option : session.engine.GpuOptions(adapter)) {
+        entries.push_back({session.catalog.GpuTarget(option).Materialize(), false});
+        if (!id.empty() && entries.back().target.id == id) {
+            return entries;
+        }
+    }
+    for (const std::uint32_t candidate : session.engine.GpuCandidates(adapter, session.catalog)) {
+        if (auto target = session.engine.SynthesizeGpuTarget(adapter, candidate, session.catalog)) {
+            entries.push_back({std::move(*target), true});
+        }
+    }
+    return entries;
+}
+
+void WriteCpu(JsonWriter& json, const CpuInfo& cpu) {
+    json.BeginObject();
+    json.Key("name").String(cpu.name);
+    json.Key("vendor").String(cpu.vendor);
+    json.Key("logicalCores").Integer(cpu.logicalCores);
+    json.Key("physicalCores").Integer(cpu.physicalCores);
+    json.Key("family").Integer(cpu.family);
+    json.Key("model").Integer(cpu.model);
+    json.Key("stepping").Integer(cpu.stepping);
+    json.EndObject();
+}
+
+void WriteGpu(JsonWriter& json, const std::vector<GpuInfo>& gpus, size_t adapter) {
+    const GpuInfo& gpu = gpus[adapter];
+    json.Key("adapter").Integer(static_cast<long long>(adapter));
+    json.Key("name").String(ToUtf8(gpu.name));
+    json.Key("vendor").String(ToUtf8(gpu.vendor));
+    json.Key("dedicatedVideoMemoryMB").Integer(static_cast<long long>(gpu.dedicatedVideoMemoryMB));
+    json.Key("vendorId").Integer(gpu.vendorId);
+    json.Key("deviceId").Integer(gpu.deviceId);
+    json.Key("subsystemId").Integer(gpu.subsystemId);
+    json.Key("revision").Integer(gpu.revision);
+    json.Key("pciBusId").String(gpu.pciBusId);
+    json.Key("nvidiaSmiDevice");
+    if (const auto device = NvidiaSmiDevice(gpu)) {
+        json.String(*device);
+    } else {
+        json.Null();
+    }
+}
+
+void WriteTarget(JsonWriter& json, const CpuEntry& entry) {
+    const CpuThrottleTarget& target = entry.target;
+    json.BeginObject();
+    json.Key("id").String(target.id);
+    json.Key("label").String(target.label);
+    json.Key("maxFrequencyMHz").Integer(target.maxFrequencyMHz);
+    json.Key("maxCores").Integer(target.maxCores);
+    json.Key("maxThreads").Integer(target.maxThreads);
+    json.Key("maxPercent").Integer(target.maxPercent);
+    json.Key("requiresConfirmation").Bool(target.requiresConfirmation);
+    json.Key("estimated").Bool(entry.estimated);
+    json.EndObject();
+}
+
+void WriteTarget(JsonWriter& json, const GpuEntry& entry) {
+    const GpuThrottleTarget& target = entry.target;
+    json.BeginObject();
+    json.Key("id").String(target.id);
+    json.Key("label").String(target.label);
+    json.Key("maxFrequencyMHz").Integer(target.maxFrequencyMHz);
+    json.Key("powerLimitWatts").Integer(target.powerLimitWatts);
+    json.Key("requiresConfirmation").Bool(target.requiresConfirmation);
+    json.Key("estimated").Bool(entry.estimated);
+    json.EndObject();
+}
+
+void WriteResult(JsonWriter& json, const ThrottleResult& result) {
+    json.Key("success").Bool(result.success);
+    json.Key("message").String(ToUtf8(result.message));
+}
+
+std::string FingerprintText(std::uint64_t fingerprint) {
+    char text[24];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(fingerprint));
+    return text;
+}
+
+int Detect() {
+    HardwareInfoService service;
+    const HardwareSnapshot snapshot = service.QueryHardware();
+
+    JsonWriter json;
+    json.BeginObject();
+    json.Key("fingerprint").String(FingerprintText(service.Fingerprint()));
+    json.Key("cpu");
+    WriteCpu(json, snapshot.cpu);
+    json.Key("simd").String(SimdIsaName(DetectSimdIsa()));
+    json.Key("caches").BeginArray();
+    for (const CacheLevel& cache : QueryCacheLevels()) {
+        json.BeginObject();
+        json.Key("level").Integer(cache.level);
+        json.Key("bytes").Integer(static_cast<long long>(cache.bytes));
+        json.Key("sharedBy").Integer(cache.sharedBy);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.Key("gpus").BeginArray();
+    for (size_t i = 0; i < snapshot.gpus.size(); ++i) {
+        json.BeginObject();
+        WriteGpu(json, snapshot.gpus, i);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    Print(json);
+    return 0;
+}
+
+int List(const Options& options) {
+    const Session session = OpenSession(options);
+    JsonWriter json;
+    json.BeginObject();
+    json.Key("cpu").BeginObject();
+    json.Key("name").String(session.snapshot.cpu.name);
+    json.Key("nominalFrequencyMHz").Integer(session.engine.CpuNominalFrequencyMHz());
+    json.Key("targets").BeginArray();
+    for (const CpuEntry& entry : CpuEntries(session)) {
+        WriteTarget(json, entry);
+    }
+    json.EndArray();
+    json.EndObject();
+    json.Key("gpus").BeginArray();
+    for (size_t i = 0; i < session.engine.GpuAdapterCount(); ++i) {
+        json.BeginObject();
+        WriteGpu(json, session.snapshot.gpus, i);
+        json.Key("nominalFrequencyMHz").Integer(session.engine.GpuNominalFrequencyMHz(i));
+        json.Key("nominalPowerWatts").Integer(session.engine.GpuNominalPowerWatts(i));
+        json.Key("targets").BeginArray();
+        for (const GpuEntry& entry : GpuEntries(session, i)) {
+            WriteTarget(json, entry);
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    Print(json);
+    return 0;
+}
+
+// Resolves every id before applying anything, so a typo or a missing
+// --yes changes nothing.
+int Apply(const Options& options) {
+    const Session session = OpenSession(options);
+    std::optional<CpuEntry> cpu;
+    if (options.cpuTarget) {
+        for (CpuEntry& entry : CpuEntries(session, *options.cpuTarget)) {
+            if (entry.target.id == *options.cpuTarget) {
+                cpu = std::move(entry);
+                break;
+            }
+        }
+        if (!cpu) {
+            std::fprintf(stderr, "hwlimit: no CPU target '%s' for this machine\n", options.cpuTarget->c_str());
+            return kExitFailure;
+        }
+    }
+    struct GpuApply {
+        size_t adapter = 0;
+        GpuThrottleTarget target;
+    };
+    std::vector<GpuApply> gpus;
+    for (const std::string& id : options.gpuTargets) {
+        const size_t before = gpus.size();
+        for (size_t i = 0; i < session.engine.GpuAdapterCount(); ++i) {
+            for (GpuEntry& entry : GpuEntries(session, i, id)) {
+                if (entry.target.id == id) {
+                    gpus.push_back({i, std::move(entry.target)});
+                    break;
+                }
+            }
+        }
+        if (gpus.size() == before) {
+            std::fprintf(stderr, "hwlimit: no GPU adapter offers target '%s'\n", id.c_str());
+            return kExitFailure;
+        }
+    }
+    if (!options.yes) {
+        bool highImpact = cpu && cpu->target.requiresConfirmation;
+        for (const GpuApply& gpu : gpus) {
+            highImpact = highImpact || gpu.target.requiresConfirmation;
+        }
+        if (highImpact) {
+            std::fprintf(stderr, "hwlimit: a selected target is marked high impact; pass --yes to apply it\n");
+            return kExitFailure;
+        }
+    }
+
+    PowerThrottler throttler;
+    bool success = true;
+    JsonWriter json;
+    json.BeginObject();
+    if (cpu) {
+        const ThrottleResult result = throttler.ApplyCpuTarget(cpu->target);
+        success = success && result.success;
+        json.Key("cpu").BeginObject();
+        json.Key("target").String(cpu->target.id);
+        WriteResult(json, result);
+        json.EndObject();
+    }
+    std::vector<GpuAdapterTarget> targets;
+    std::vector<size_t> nvidia;  // indices into `gpus` of the adapters nvidia-smi can address
+    for (size_t i = 0; i < gpus.size(); ++i) {
+        if (auto device = NvidiaSmiDevice(session.snapshot.gpus[gpus[i].adapter])) {
+            targets.push_back({*std::move(device), gpus[i].target});
+            nvidia.push_back(i);
+        }
+    }
+    const auto results = throttler.ApplyGpuTargets(targets);
+    json.Key("gpus").BeginArray();
+    for (size_t i = 0, next = 0; i < gpus.size(); ++i) {
+        json.BeginObject();
+        json.Key("adapter").Integer(static_cast<long long>(gpus[i].adapter));
+        json.Key("target").String(gpus[i].target.id);
+        if (next < nvidia.size() && nvidia[next] == i) {
+            success = success && results[next].result.success;
+            WriteResult(json, results[next++].result);
+        } else {
+            success = false;
+            WriteResult(json, {false, L"Not an NVIDIA adapter at a known PCI location"});
+        }
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    Print(json);
+    return success ? 0 : kExitFailure;
+}
+
+// Needs no catalog: each GPU goes back to its own default power limit.
+int Restore() {
+    const HardwareSnapshot snapshot = HardwareInfoService().QueryHardware();
+    PowerThrottler throttler;
+    const ThrottleResult cpu = throttler.RestoreDefaults();
+    bool success = cpu.success;
+    std::vector<GpuAdapterDefaults> defaults;
+    std::vector<size_t> adapters;
+    for (size_t i = 0; i < snapshot.gpus.size(); ++i) {
+        if (auto device = NvidiaSmiDevice(snapshot.gpus[i])) {
+            defaults.push_back({*std::move(device)});
+            adapters.push_back(i);
+        }
+    }
+    const auto results = throttler.RestoreGpuDefaults(defaults);
+
+    JsonWriter json;
+    json.BeginObject();
+    json.Key("cpu").BeginObject();
+    WriteResult(json, cpu);
+    json.EndObject();
+    json.Key("gpus").BeginArray();
+    for (size_t i = 0; i < results.size(); ++i) {
+        success = success && results[i].result.success;
+        json.BeginObject();
+        json.Key("adapter").Integer(static_cast<long long>(adapters[i]));
+        WriteResult(json, results[i].result);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    Print(json);
+    return success ? 0 : kExitFailure;
+}
+
+void WriteNumbers(JsonWriter& json, const std::vector<double>& values) {
+    json.BeginArray();
+    for (const double value : values) {
+        json.Number(value);
+    }
+    json.EndArray();
+}
+
+void WriteBenchmark(JsonWriter& json, const std::optional<BenchmarkResultData>& result) {
+    if (!result) {
+        json.Null();
+        return;
+    }
+    json.BeginObject();
+    json.Key("score").Number(result->score);
+    json.Key("unit").String(result->unit);
+    json.Key("details").String(result->details);
+    json.Key("stats").BeginObject();
+    json.Key("samples").Integer(static_cast<long long>(result->stats.samples));
+    json.Key("outliers").Integer(static_cast<long long>(result->stats.outliers));
+    json.Key("median").Number(result->stats.median);
+    json.Key("mad").Number(result->stats.mad);
+    json.Key("ciLow").Number(result->stats.ciLow);
+    json.Key("ciHigh").Number(result->stats.ciHigh);
+    json.EndObject();
+    json.Key("samples");
+    WriteNumbers(json, result->samples);
+    json.Key("kernels").BeginArray();
+    for (const KernelScore& kernel : result->kernels) {
+        json.BeginObject();
+        json.Key("kernel").String(kernel.kernel);
+        json.Key("isa").String(kernel.isa);
+        json.Key("gops").Number(kernel.gops);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.Key("cores").BeginArray();
+    for (const CoreScore& core : result->cores) {
+        json.BeginObject();
+        json.Key("core").Integer(core.core);
+        json.Key("type").String(core.type);
+        json.Key("cpus").BeginArray();
+        for (const unsigned cpu : core.cpus) {
+            json.Integer(cpu);
+        }
+        json.EndArray();
+        json.Key("alone");
+        WriteNumbers(json, core.alone);
+        json.Key("together").Number(core.together);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.Key("curves").BeginArray();
+    for (const BenchmarkCurve& curve : result->curves) {
+        json.BeginObject();
+        json.Key("name").String(curve.name);
+        json.Key("xUnit").String(curve.xUnit);
+        json.Key("yUnit").String(curve.yUnit);
+        json.Key("points").BeginArray();
+        for (const CurvePoint& point : curve.points) {
+            json.BeginArray().Number(point.x).Number(point.y).EndArray();
+        }
+        json.EndArray();
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+}
+
+std::atomic<BenchmarkControl*> gInterruptTarget = nullptr;
+
+// Ctrl+C stops the benchmark at its next step instead of killing the
+// process, so the finished parts are still printed.
+extern "C" void HandleInterrupt(int) {
+    if (BenchmarkControl* control = gInterruptTarget.load()) {
+        control->Cancel();
+    }
+}
+
+void WriteRegressions(JsonWriter& json, const std::vector<RegressionCheck>& checks) {
+    json.BeginArray();
+    for (const RegressionCheck& check : checks) {
+        json.BeginObject();
+        json.Key("kernel").String(check.kernel);
+        json.Key("baselineRuns").Integer(static_cast<long long>(check.baselineRuns));
+        // A first run, or too few samples on either side, was not compared;
+        // nulls keep that apart from "compared and unchanged".
+        const bool compared = check.baselineRuns > 0 && check.comparison.enoughSamples;
+        json.Key("baselineMedian");
+        if (check.baselineRuns > 0) {
+            json.Number(check.baselineMedian);
+        } else {
+            json.Null();
+        }
+        json.Key("change");
+        if (compared) {
+            json.Number(check.comparison.change);
+        } else {
+            json.Null();
+        }
+        json.Key("pValue");
+        if (compared) {
+            json.Number(check.comparison.pValue);
+        } else {
+            json.Null();
+        }
+        json.Key("regressed").Bool(check.regressed);
+        json.EndObject();
+    }
+    json.EndArray();
+}
+
+int Bench(const Options& options) {
+    HardwareInfoService service;
+    const HardwareSnapshot snapshot = service.QueryHardware();
+    BenchmarkOptions benchOptions = options.bench;
+    std::optional<BenchmarkHistory> history;
+    BenchmarkRunKeys keys;
+    BenchmarkReport reused;
+    if (!options.history.empty()) {
+        history.emplace(options.history);
+        keys = MakeRunKeys(service.Fingerprint(), options.benchCpuTarget, options.benchGpuTarget, benchOptions);
+        if (options.baseline) {
+            reused = ReuseStoredRuns(*history, keys, benchOptions);
+        }
+    }
+
+    // The target the run is labelled with, if this machine offers it, for
+    // the scaling comparison. Looked up before the run so that a catalog
+    // problem cannot cost the measurements.
+    std::optional<CpuThrottleTarget> scalingTarget;
+    if ((benchOptions.scaling || reused.scaling) && !options.benchCpuTarget.empty()) {
+        try {
+            const Session session = OpenSession(options);
+            for (const CpuEntry& entry : CpuEntries(session, options.benchCpuTarget)) {
+                if (entry.target.id == options.benchCpuTarget) {
+                    scalingTarget = entry.target;
+                    break;
+                }
+            }
+        } catch (const std::exception& ex) {
+            std::fprintf(stderr, "hwlimit: %s; reporting scaling without the target comparison\n", ex.what());
+        }
+    }
+
+    BenchmarkControl control([&](const BenchmarkProgress& progress) {
+        if (options.progress) {
+            std::fprintf(stderr, "[%3d%%] %s\n", static_cast<int>(progress.fraction * 100.0), progress.step.c_str());
+        }
+    });
+    gInterruptTarget = &control;
+    std::signal(SIGINT, HandleInterrupt);
+    BenchmarkReport report = BenchmarkRunner().Run(snapshot, benchOptions, &control);
+    std::signal(SIGINT, SIG_DFL);
+    gInterruptTarget = nullptr;
+
+    std::vector<RegressionCheck> checks;
+    if (history) {
+        checks = RecordRuns(*history, keys, benchOptions, report);
+    }
+    JsonWriter json;
+    json.BeginObject();
+    json.Key("cancelled").Bool(report.cancelled);
+    json.Key("reused").BeginArray();
+    for (auto [name, slot, stored] : {std::tuple{kCpuScore, &report.cpu, &reused.cpu},
+                                      std::tuple{kGpuScore, &report.gpu, &reused.gpu},
+                                      std::tuple{kMemoryScore, &report.memory, &reused.memory},
+                                      std::tuple{kWorkloadScore, &report.workloads, &reused.workloads},
+                                      std::tuple{kSustainedScore, &report.sustained, &reused.sustained},
+                                      std::tuple{kScalingScore, &report.scaling, &reused.scaling}}) {
+        if (*stored) {
+            *slot = *stored;
+            json.String(name);
+        }
+    }
+    json.EndArray();
+    json.Key("cpu");
+    WriteBenchmark(json, report.cpu);
+    json.Key("gpu");
+    WriteBenchmark(json, report.gpu);
+    json.Key("memory");
+    WriteBenchmark(json, report.memory);
+    json.Key("workloads");
+    WriteBenchmark(json, report.workloads);
+    json.Key("sustained");
+    WriteBenchmark(json, report.sustained);
+    json.Key("scaling");
+    WriteBenchmark(json, report.scaling);
+    json.Key("scalingVsTarget");
+    std::string comparison;
+    if (report.scaling && scalingTarget) {
+        comparison = CompareScaling(*report.scaling, scalingTarget->maxCores, scalingTarget->maxThreads);
+    }
+    if (comparison.empty()) {
+        json.Null();
+    } else {
+        json.String(comparison);
+    }
+    json.Key("regressions");
+    WriteRegressions(json, checks);
+    json.EndObject();
+    Print(json);
+    return report.cancelled ? kExitInterrupted : 0;
+}
+
+// Every kernel and settings the target was benchmarked with, oldest run
+// first.
+int History(const Options& options) {
+    const std::uint64_t fingerprint = HardwareInfoService().Fingerprint();
+    const BenchmarkHistory history(options.history);
+    JsonWriter json;
+    json.BeginObject();
+    json.Key("path").String(history.Path().string());
+    json.Key("fingerprint").String(FingerprintText(fingerprint));
+    json.Key("target").String(options.historyTarget);
+    json.Key("runs").BeginArray();
+    for (const BenchmarkRecord& run : history.RunsOfTarget(fingerprint, options.historyTarget)) {
+        if (!options.historyKernel.empty() && run.key.kernel != options.historyKernel) {
+            continue;
+        }
+        json.BeginObject();
+        json.Key("kernel").String(run.key.kernel);
+        json.Key("settings").String(run.key.settings);
+        json.Key("timestamp").Integer(run.timestamp);
+        json.Key("result");
+        WriteBenchmark(json, run.result);
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+    Print(json);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const auto options = ParseArguments(argc, argv);
+    if (!options) {
+        return kExitUsage;
+    }
+    try {
+        if (options->command == "detect") {
+            return Detect();
+        }
+        if (options->command == "list") {
+            return List(*options);
+        }
+        if (options->command == "apply") {
+            return Apply(*options);
+        }
+        if (options->command == "restore") {
+            return Restore();
+        }
+        if (options->command == "history") {
+            return History(*options);
+        }
+        return Bench(*options);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "hwlimit: %s\n", ex.what());
+        return kExitFailure;
+    }
+}
@@ -0,0 +1,115 @@
+// profilec: validates resources/profiles.json and compiles it into the
+// binary catalog image that ProfileLoader::LoadCatalog memory-maps.
+//
+//   profilec <profiles.json> <profiles.bin>
+
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "HardwareKeys.hpp"
+#include "ProfileCatalog.hpp"
+#include "ProfileLoader.hpp"
+
+namespace {
+
+std::vector<std::string> ValidateDatabase(const ProfileDatabase& db) {
+    std::vector<std::string> errors;
+    std::unordered_set<std::string> profileIds;
+    std::unordered_set<std::string> targetIds;
+
+    auto checkProfile = [&](const std::string& kind, const std::string& id, size_t matchKeys) {
+        if (id.empty()) {
+            errors.push_back(kind + " profile without an id");
+        } else if (!profileIds.insert(id).second) {
+            errors.push_back("duplicate profile id '" + id + "'");
+        }
+        if (matchKeys == 0) {
+            errors.push_back("profile '" + id + "' has no matchTokens or hardware ids and can never match");
+        }
+    };
+    auto checkTarget = [&](const std::string& profileId, const std::string& id) {
+        if (id.empty()) {
+            errors.push_back("profile '" + profileId + "' has a target without an id");
+        } else if (!targetIds.insert(id).second) {
+            errors.push_back("duplicate target id '" + id + "'");
+        }
+    };
+
+    auto checkIds = [&](const std::string& profileId, const std::vector<std::string>& ids, auto parse) {
+        for (const auto& id : ids) {
+            if (!parse(id)) {
+                errors.push_back("profile '" + profileId + "' has a malformed hardware id '" + id + "'");
+            }
+        }
+    };
+
+    for (const auto& profile : db.cpuProfiles) {
+        checkProfile("CPU", profile.id, profile.matchTokens.size() + profile.cpuIds.size());
+        checkIds(profile.id, profile.cpuIds, CpuIdKey::Parse);
+        for (const auto& target : profile.targets) {
+            checkTarget(profile.id, target.id);
+            if (target.maxPercent < 1 || target.maxPercent > 100) {
+                errors.push_back("target '" + target.id + "' has maxPercent outside 1..100");
+            }
+            if (target.maxFrequencyMHz < 0 || target.maxCores < 0 || target.maxThreads < 0) {
+                errors.push_back("target '" + target.id + "' has a negative limit");
+            }
+        }
+    }
+    for (const auto& profile : db.gpuProfiles) {
+        checkProfile("GPU", profile.id, profile.matchTokens.size() + profile.pciIds.size());
+        checkIds(profile.id, profile.pciIds, PciIdKey::Parse);
+        for (const auto& target : profile.targets) {
+            checkTarget(profile.id, target.id);
+            if (target.maxFrequencyMHz < 0 || target.powerLimitWatts < 0) {
+                errors.push_back("target '" + target.id + "' has a negative limit");
+            }
+        }
+    }
+    return errors;
+}
+
+std::string ReadText(const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("unable to open " + path.string());
+    }
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: profilec <profiles.json> <profiles.bin>\n");
+        return 2;
+    }
+    try {
+        const std::string text = ReadText(argv[1]);
+        ProfileLoader loader;
+        const ProfileDatabase db = loader.LoadFromText(text);
+
+        const auto errors = ValidateDatabase(db);
+        for (const auto& error : errors) {
+            std::fprintf(stderr, "profilec: %s: %s\n", argv[1], error.c_str());
+        }
+        if (!errors.empty()) {
+            return 1;
+        }
+
+        const auto image = ProfileCatalog::BuildImage(db, ProfileCatalog::HashSource(text));
+        ProfileCatalog::WriteImage(argv[2], image);
+        std::printf("profilec: %zu CPU / %zu GPU profiles -> %s (%zu bytes)\n",
+                    db.cpuProfiles.size(), db.gpuProfiles.size(), argv[2], image.size());
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "profilec: %s\n", ex.what());
+        return 1;
+    }
+    return 0;
+}
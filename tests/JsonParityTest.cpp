@@ -0,0 +1,390 @@
+// Checks the event Reader against the pre-Reader parser it replaced: every
+// input either parses to the same values under each scan backend or fails
+// with the same message, and the vector kernels agree with the scalar ones.
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ReferenceJson.hpp"
+#include "SimpleJson.hpp"
+
+namespace {
+
+using jsonlite::ScanBackend;
+using namespace std::string_view_literals;
+
+constexpr ScanBackend kBackends[] = {ScanBackend::Scalar, ScanBackend::Sse2, ScanBackend::Avx2};
+constexpr int kGeneratedDocuments = 4000;
+constexpr int kMutationsPerDocument = 4;
+constexpr int kCatalogMutations = 200;
+constexpr int kKernelBuffers = 400;
+
+int failures = 0;
+
+const char* BackendName(ScanBackend backend) {
+    switch (backend) {
+        case ScanBackend::Sse2:
+            return "sse2";
+        case ScanBackend::Avx2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+// Inputs are clipped so a failure on the catalog stays readable.
+void Fail(std::string_view what, std::string_view input) {
+    ++failures;
+    if (failures > 20) {
+        return;
+    }
+    std::string shown(input.substr(0, 200));
+    std::fprintf(stderr, "FAIL: %.*s\n  input (%zu bytes): %s\n", static_cast<int>(what.size()), what.data(),
+                 input.size(), shown.c_str());
+}
+
+bool SameNumber(double lhs, double rhs) {
+    return std::bit_cast<std::uint64_t>(lhs) == std::bit_cast<std::uint64_t>(rhs);
+}
+
+// The reference keeps the first of repeated keys in a std::map; the new
+// members are sorted stably, so the first of each run of equal keys is
+// the one lookups return.
+bool SameValue(const reference_json::Value& expected, const jsonlite::Value& actual) {
+    switch (expected.type) {
+        case reference_json::Type::Null:
+            return actual.IsNull();
+        case reference_json::Type::Bool:
+            return actual.IsBool() && actual.GetBool() == expected.boolean;
+        case reference_json::Type::Number:
+            return actual.IsNumber() && SameNumber(actual.GetNumber(), expected.number);
+        case reference_json::Type::String:
+            return actual.IsString() && actual.GetString() == expected.string;
+        case reference_json::Type::Array: {
+            if (!actual.IsArray() || actual.Items().size() != expected.array.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < expected.array.size(); ++i) {
+                if (!SameValue(expected.array[i], actual.Items()[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case reference_json::Type::Object: {
+            if (!actual.IsObject()) {
+                return false;
+            }
+            auto it = expected.object.begin();
+            const auto members = actual.Members();
+            for (size_t i = 0; i < members.size(); ++i) {
+                if (i > 0 && members[i].key == members[i - 1].key) {
+                    continue;
+                }
+                if (it == expected.object.end() || it->first != members[i].key ||
+                    !SameValue(it->second, members[i].value)) {
+                    return false;
+                }
+                ++it;
+            }
+            return it == expected.object.end();
+        }
+    }
+    return false;
+}
+
+void CheckParse(std::string_view input) {
+    std::optional<reference_json::Value> expected;
+    std::string expectedError;
+    try {
+        expected = reference_json::Parse(input);
+    } catch (const reference_json::ParseError& error) {
+        expectedError = error.what();
+    }
+    for (ScanBackend backend : kBackends) {
+        jsonlite::SetScanBackend(backend);
+        std::string label = std::string("parse under ") + BackendName(jsonlite::ActiveScanBackend());
+        try {
+            const jsonlite::Document document = jsonlite::Parse(input);
+            if (!expected) {
+                Fail(label + ": accepted, reference failed with \"" + expectedError + "\"", input);
+            } else if (!SameValue(*expected, document.Root())) {
+                Fail(label + ": values differ", input);
+            }
+        } catch (const jsonlite::ParseError& error) {
+            if (expected) {
+                Fail(label + ": failed with \"" + error.what() + "\", reference accepted", input);
+            } else if (expectedError != error.what()) {
+                Fail(label + ": \"" + error.what() + "\" but reference \"" + expectedError + "\"", input);
+            }
+        }
+    }
+}
+
+// Event trace of a walk that skips every other member value and the tail
+// of every third nested container, so SkipValue/SkipRest run their
+// balanced scans from many positions.
+std::string SkipTrace(std::string_view input) {
+    std::string trace;
+    try {
+        jsonlite::Reader reader(input);
+        size_t keys = 0;
+        size_t containers = 0;
+        for (jsonlite::Event event = reader.Next(); event != jsonlite::Event::End; event = reader.Next()) {
+            trace += std::to_string(static_cast<int>(event));
+            trace += '@';
+            trace += std::to_string(reader.Offset());
+            trace += ' ';
+            if (event == jsonlite::Event::Key && ++keys % 2 == 0) {
+                reader.SkipValue();
+                trace += "v@" + std::to_string(reader.Offset()) + ' ';
+            } else if ((event == jsonlite::Event::StartObject || event == jsonlite::Event::StartArray) &&
+                       reader.Depth() > 1 && ++containers % 3 == 0) {
+                reader.SkipRest();
+                trace += "r@" + std::to_string(reader.Offset()) + ' ';
+            }
+        }
+    } catch (const jsonlite::ParseError& error) {
+        trace += error.what();
+    }
+    return trace;
+}
+
+void CheckSkips(std::string_view input) {
+    jsonlite::SetScanBackend(ScanBackend::Scalar);
+    const std::string expected = SkipTrace(input);
+    for (ScanBackend backend : kBackends) {
+        jsonlite::SetScanBackend(backend);
+        if (SkipTrace(input) != expected) {
+            Fail(std::string("skip trace differs under ") + BackendName(jsonlite::ActiveScanBackend()), input);
+        }
+    }
+}
+
+void Check(std::string_view input) {
+    CheckParse(input);
+    CheckSkips(input);
+}
+
+class Generator {
+public:
+    explicit Generator(std::uint32_t seed) : random_(seed) {}
+
+    std::string Document() {
+        std::string out;
+        Space(out);
+        Value(out, 0);
+        Space(out);
+        return out;
+    }
+
+    // One edit of the kinds that break JSON in interesting places: a byte
+    // replaced, inserted or dropped, the text cut short, or a slice repeated.
+    std::string Mutate(std::string text) {
+        static constexpr std::string_view kBytes = "{}[]\",:\\/ \t\n\v\r0123456789-+.eEtrufalsn\x00\x7f\xc3"sv;
+        const auto pick = [&] { return kBytes[Below(kBytes.size())]; };
+        const size_t at = text.empty() ? 0 : Below(text.size());
+        switch (Below(5)) {
+            case 0:
+                if (!text.empty()) {
+                    text[at] = pick();
+                }
+                break;
+            case 1:
+                text.insert(text.begin() + static_cast<std::ptrdiff_t>(at), pick());
+                break;
+            case 2:
+                if (!text.empty()) {
+                    text.erase(at, 1);
+                }
+                break;
+            case 3:
+                text.resize(at);
+                break;
+            default: {
+                const size_t length = Below(std::min<size_t>(text.size() - at, 24) + 1);
+                text.insert(at, text.substr(at, length));
+                break;
+            }
+        }
+        return text;
+    }
+
+    size_t Below(size_t bound) {
+        return bound == 0 ? 0 : std::uniform_int_distribution<size_t>(0, bound - 1)(random_);
+    }
+
+private:
+    void Space(std::string& out) {
+        static constexpr std::string_view kSpaces = " \t\n\r\v\f";
+        for (size_t n = Below(3); n > 0; --n) {
+            out += kSpaces[Below(kSpaces.size())];
+        }
+    }
+
+    void Value(std::string& out, int depth) {
+        switch (Below(depth > 6 ? 4 : 6)) {
+            case 0:
+                out += Below(2) ? (Below(2) ? "true" : "false") : "null";
+                break;
+            case 1:
+                Number(out);
+                break;
+            case 2:
+            case 3:
+                String(out);
+                break;
+            case 4: {
+                out += '[';
+                const size_t count = Below(5);
+                for (size_t i = 0; i < count; ++i) {
+                    if (i > 0) {
+                        out += ',';
+                    }
+                    Space(out);
+                    Value(out, depth + 1);
+                    Space(out);
+                }
+                Space(out);
+                out += ']';
+                break;
+            }
+            default: {
+                out += '{';
+                const size_t count = Below(5);
+                for (size_t i = 0; i < count; ++i) {
+                    if (i > 0) {
+                        out += ',';
+                    }
+                    Space(out);
+                    String(out);
+                    Space(out);
+                    out += ':';
+                    Space(out);
+                    Value(out, depth + 1);
+                    Space(out);
+                }
+                Space(out);
+                out += '}';
+                break;
+            }
+        }
+    }
+
+    void Number(std::string& out) {
+        static constexpr std::string_view kNumbers[] = {
+            "0", "-0", "1", "-17", "3.25", "1e3", "2E-2", "6.02e+23", "1e400", "-1e400", "1e-400", "4.9e-324",
+            "0.1", "123456789012345678901234567890", "1.", "01", "1e", "1e+", "-", "-.5", "5e-1", "0.000001",
+        };
+        out += kNumbers[Below(std::size(kNumbers))];
+    }
+
+    // Long enough runs that the vector kernels cross block boundaries.
+    void String(std::string& out) {
+        static constexpr std::string_view kPieces[] = {
+            "a", "bc", "intel core", "{[", "]}", ",:", "\\\"", "\\\\", "\\/", "\\n", "\\t", "\\u0041", "\\u00e9",
+            "\\u20AC", "\xc3\xa9", "0123456789abcdefghijklmnopqrstuvwxyz",
+        };
+        out += '"';
+        for (size_t n = Below(Below(4) == 0 ? 40 : 6); n > 0; --n) {
+            out += kPieces[Below(std::size(kPieces))];
+        }
+        out += '"';
+    }
+
+    std::mt19937 random_;
+};
+
+void CheckGenerated() {
+    Generator generator(0x5eed);
+    for (int i = 0; i < kGeneratedDocuments; ++i) {
+        const std::string document = generator.Document();
+        Check(document);
+        std::string mutated = document;
+        for (int m = 0; m < kMutationsPerDocument; ++m) {
+            mutated = generator.Mutate(mutated);
+            Check(mutated);
+        }
+    }
+}
+
+void CheckCatalog(const std::string& catalog) {
+    Check(catalog);
+    Generator generator(0xca7a);
+    for (int i = 0; i < kCatalogMutations; ++i) {
+        CheckParse(generator.Mutate(catalog));
+    }
+}
+
+#if JSONLITE_X86_SIMD
+// Mostly brackets, quotes and escapes, so every branch of the balanced
+// skip and the string masks sees block-boundary cases.
+std::string BracketHeavyBuffer(Generator& generator) {
+    static constexpr std::string_view kBytes = "{}[]{}[]\"\"\\ \t\n,:a0";
+    std::string buffer(generator.Below(200), ' ');
+    for (char& c : buffer) {
+        c = kBytes[generator.Below(kBytes.size())];
+    }
+    return buffer;
+}
+
+void CheckKernels(const jsonlite::detail::ScanKernels& kernels, const char* name) {
+    const jsonlite::detail::ScanKernels& scalar = jsonlite::detail::kScalarKernels;
+    Generator generator(0xb7ac);
+    for (int i = 0; i < kKernelBuffers; ++i) {
+        const std::string buffer = BracketHeavyBuffer(generator);
+        const char* data = buffer.data();
+        const size_t size = buffer.size();
+        for (size_t pos = 0; pos <= size; ++pos) {
+            const bool same = kernels.skipWhitespace(data, pos, size) == scalar.skipWhitespace(data, pos, size) &&
+                              kernels.findQuoteOrEscape(data, pos, size) ==
+                                  scalar.findQuoteOrEscape(data, pos, size) &&
+                              kernels.findStructural(data, pos, size) == scalar.findStructural(data, pos, size) &&
+                              kernels.skipBalanced(data, pos, size) == scalar.skipBalanced(data, pos, size);
+            if (!same) {
+                Fail(std::string(name) + " kernels differ from scalar at offset " + std::to_string(pos), buffer);
+            }
+        }
+    }
+}
+#endif
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: json_parity_test <profiles.json>\n");
+        return 2;
+    }
+    std::ifstream file(argv[1], std::ios::binary);
+    const std::string catalog{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (!file || catalog.empty()) {
+        std::fprintf(stderr, "Unable to read %s\n", argv[1]);
+        return 2;
+    }
+
+    CheckCatalog(catalog);
+    CheckGenerated();
+#if JSONLITE_X86_SIMD
+    CheckKernels(jsonlite::detail::kSse2Kernels, "sse2");
+    if (jsonlite::detail::CpuHasAvx2()) {
+        CheckKernels(jsonlite::detail::kAvx2Kernels, "avx2");
+    }
+#endif
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d parity failures\n", failures);
+        return 1;
+    }
+    std::printf("jsonlite matches the reference parser\n");
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Checks the chunked catalog load against the serial pass: for the shipped
+// catalog and mutated copies of it, every worker count must yield the same
+// profiles, or fail with the same error.
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ProfileLoader.hpp"
+
+namespace {
+
+constexpr unsigned kWorkerCounts[] = {2, 3, 4, 8, 16};
+constexpr int kCatalogMutations = 300;
+
+int failures = 0;
+
+void Fail(const std::string& what) {
+    ++failures;
+    if (failures <= 20) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+    }
+}
+
+void Describe(std::string& out, const std::vector<std::string>& list) {
+    out += '[';
+    for (const std::string& item : list) {
+        out += item;
+        out += '|';
+    }
+    out += ']';
+}
+
+void Describe(std::string& out, const CpuThrottleTarget& target) {
+    out += target.id + ';' + target.label + ';' + std::to_string(target.maxFrequencyMHz) + ';' +
+           std::to_string(target.maxCores) + ';' + std::to_string(target.maxThreads) + ';' +
+           std::to_string(target.maxPercent) + ';' + (target.requiresConfirmation ? "confirm" : "") + ';';
+    Describe(out, target.extraCommands);
+}
+
+void Describe(std::string& out, const GpuThrottleTarget& target) {
+    out += target.id + ';' + target.label + ';' + std::to_string(target.maxFrequencyMHz) + ';' +
+           std::to_string(target.powerLimitWatts) + ';' + (target.requiresConfirmation ? "confirm" : "") + ';';
+    Describe(out, target.nvidiaSmiArgs);
+}
+
+// Every field of every profile, in order, so any difference shows up.
+std::string Describe(const ProfileDatabase& db) {
+    std::string out;
+    for (const CpuProfile& profile : db.cpuProfiles) {
+        out += "cpu " + profile.id + ';' + profile.label + ';' + std::to_string(profile.nominalFrequencyMHz) + ';';
+        Describe(out, profile.matchTokens);
+        Describe(out, profile.cpuIds);
+        for (const CpuThrottleTarget& target : profile.targets) {
+            Describe(out, target);
+        }
+        out += '\n';
+    }
+    for (const GpuProfile& profile : db.gpuProfiles) {
+        out += "gpu " + profile.id + ';' + profile.label + ';' + std::to_string(profile.nominalFrequencyMHz) + ';' +
+               std::to_string(profile.nominalPowerWatts) + ';';
+        Describe(out, profile.matchTokens);
+        Describe(out, profile.pciIds);
+        for (const GpuThrottleTarget& target : profile.targets) {
+            Describe(out, target);
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+std::string Load(std::string_view text, unsigned workers) {
+    ProfileLoader loader;
+    loader.SetWorkerThreads(workers);
+    try {
+        return Describe(loader.LoadFromText(text));
+    } catch (const std::exception& error) {
+        return std::string("error: ") + error.what();
+    }
+}
+
+void Check(std::string_view text, const std::string& name) {
+    const std::string serial = Load(text, 1);
+    for (unsigned workers : kWorkerCounts) {
+        if (Load(text, workers) != serial) {
+            Fail(name + ": " + std::to_string(workers) + " workers differ from the serial pass (" +
+                 serial.substr(0, 80) + ")");
+        }
+    }
+}
+
+// Edits aimed at the chunk boundaries: a byte inside or between profiles
+// changed, a bracket or quote added or dropped, a value replaced by one of
+// another type, or the text cut short.
+std::string Mutate(std::string text, std::mt19937& random) {
+    static constexpr std::string_view kBytes = "{}[]\",:\\ 0-9x";
+    static constexpr std::string_view kValues[] = {"null", "\"x\"", "[]", "{}", "-1", "1e999", "true"};
+    const auto below = [&](size_t bound) { return std::uniform_int_distribution<size_t>(0, bound - 1)(random); };
+    const size_t at = below(text.size());
+    switch (below(5)) {
+        case 0:
+            text[at] = kBytes[below(kBytes.size())];
+            break;
+        case 1:
+            text.insert(at, 1, kBytes[below(4)]);
+            break;
+        case 2:
+            text.erase(at, 1);
+            break;
+        case 3: {
+            // The value after the next ':'.
+            const size_t colon = text.find(':', at);
+            if (colon == std::string::npos) {
+                break;
+            }
+            const size_t end = text.find_first_of(",}]", colon);
+            text.replace(colon + 1, end == std::string::npos ? 0 : end - colon - 1, kValues[below(std::size(kValues))]);
+            break;
+        }
+        default:
+            text.resize(at);
+            break;
+    }
+    return text;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: loader_parity_test <profiles.json>\n");
+        return 2;
+    }
+    std::ifstream file(argv[1], std::ios::binary);
+    const std::string catalog{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (!file || catalog.empty()) {
+        std::fprintf(stderr, "Unable to read %s\n", argv[1]);
+        return 2;
+    }
+
+    if (Load(catalog, 1).starts_with("error: ")) {
+        Fail("the catalog itself does not load: " + Load(catalog, 1));
+    }
+    Check(catalog, "catalog");
+    std::mt19937 random(0x10ad);
+    for (int i = 0; i < kCatalogMutations; ++i) {
+        std::string mutated = Mutate(catalog, random);
+        if (i % 3 == 0) {
+            mutated = Mutate(std::move(mutated), random);
+        }
+        Check(mutated, "mutation " + std::to_string(i));
+    }
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d parity failures\n", failures);
+        return 1;
+    }
+    std::printf("chunked loads match the serial pass\n");
+    return 0;
+}